@@ -0,0 +1,92 @@
+/**
+ * Confirms that a find command run against the $cmd namespace with the exhaust option streams every
+ * batch of its cursor, against both mongod and mongos, and that other cursor commands run with the
+ * exhaust option return a single reply instead of waiting for streamed batches.
+ */
+(function() {
+    "use strict";
+
+    var numDocs = 25;
+
+    /**
+     * Runs an exhaust find on 'coll' through the $cmd namespace of its database and returns the
+     * documents it produced.
+     */
+    function exhaustFind(coll, batchSize) {
+        var cmdColl = coll.getDB().getCollection("$cmd");
+        return cmdColl.find({find: coll.getName(), sort: {_id: 1}, batchSize: batchSize})
+            .limit(1)
+            .addOption(DBQuery.Option.exhaust)
+            .toArray();
+    }
+
+    function checkExhaustFind(coll) {
+        [0, 1, 4, numDocs, numDocs + 1].forEach(function(batchSize) {
+            var docs = exhaustFind(coll, batchSize);
+            assert.eq(numDocs, docs.length, tojson(docs));
+            for (var i = 0; i < numDocs; ++i) {
+                assert.eq({_id: i, x: "x".repeat(i)}, docs[i]);
+            }
+        });
+    }
+
+    function insertDocs(coll) {
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < numDocs; ++i) {
+            bulk.insert({_id: i, x: "x".repeat(i)});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    //
+    // mongod
+    //
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    var coll = conn.getDB("test").exhaust_find_command;
+    insertDocs(coll);
+    checkExhaustFind(coll);
+
+    // An aggregate is not streamed, so the client returns its reply as that of any other command.
+    var cmdColl = coll.getDB().getCollection("$cmd");
+    var replies =
+        cmdColl.find({aggregate: coll.getName(), pipeline: [], cursor: {batchSize: 2}})
+            .limit(1)
+            .addOption(DBQuery.Option.exhaust)
+            .toArray();
+    assert.eq(1, replies.length, tojson(replies));
+    assert.commandWorked(replies[0]);
+    assert.eq(2, replies[0].cursor.firstBatch.length, tojson(replies[0]));
+
+    MongoRunner.stopMongod(conn);
+
+    //
+    // mongos, with the documents spread over two shards
+    //
+    var st = new ShardingTest({shards: 2, mongos: 1});
+
+    var mongosDB = st.s0.getDB("test");
+    coll = mongosDB.exhaust_find_command;
+    assert.commandWorked(mongosDB.adminCommand({enableSharding: mongosDB.getName()}));
+    st.ensurePrimaryShard(mongosDB.getName(), "shard0000");
+    assert.commandWorked(
+        mongosDB.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(mongosDB.adminCommand({split: coll.getFullName(), middle: {_id: 10}}));
+    assert.commandWorked(mongosDB.adminCommand(
+        {moveChunk: coll.getFullName(), find: {_id: 10}, to: "shard0001"}));
+
+    insertDocs(coll);
+    checkExhaustFind(coll);
+
+    // mongos rejects the exhaust option for other commands.
+    cmdColl = mongosDB.getCollection("$cmd");
+    assert.throws(function() {
+        cmdColl.find({aggregate: coll.getName(), pipeline: [], cursor: {}})
+            .limit(1)
+            .addOption(DBQuery.Option.exhaust)
+            .next();
+    });
+
+    st.stop();
+})();
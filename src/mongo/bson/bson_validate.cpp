@@ -27,15 +27,16 @@
  *    then also delete it in the license file.
  */
 
+#include <boost/container/small_vector.hpp>
 #include <cstring>
 #include <limits>
-#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/oid.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/platform/bits.h"
 #include "mongo/platform/decimal128.h"
 
 namespace mongo {
@@ -73,10 +74,13 @@ public:
     }
 
     Status readCString(StringData* out) {
-        const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
-        if (!x)
-            return makeError("no end of c-string", _idElem);
-        uint64_t len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
+        uint64_t len;
+        if (!_findShortCStringEnd(&len)) {
+            const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
+            if (!x)
+                return makeError("no end of c-string", _idElem);
+            len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
+        }
 
         StringData data(_buffer + _position, len);
         _position += len + 1;
@@ -139,6 +143,27 @@ public:
     }
 
 private:
+    /**
+     * Most field names are only a few bytes long, for which the call to memchr costs more than the
+     * search itself. Looks for the terminating NUL among the next 8 bytes one word at a time and
+     * sets 'len' to the length of the string if it is found there.
+     */
+    bool _findShortCStringEnd(uint64_t* len) const {
+        if (_maxLength - _position < sizeof(uint64_t))
+            return false;
+
+        const uint64_t word = ConstDataView(_buffer).read<LittleEndian<uint64_t>>(_position);
+
+        // Has the high bit set in each zero byte of 'word'. Bytes above the first zero byte may be
+        // flagged spuriously, which does not matter since only the lowest one is used.
+        const uint64_t zeroBytes = (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+        if (!zeroBytes)
+            return false;
+
+        *len = countTrailingZeros64(zeroBytes) / 8;
+        return true;
+    }
+
     const char* _buffer;
     uint64_t _position;
     uint64_t _maxLength;
@@ -291,8 +316,9 @@ Status validateElementInfo(Buffer* buffer,
 }
 
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    // Keeps the frames of typical documents on the stack, so that validating them does not need a
+    // heap allocation.
+    boost::container::small_vector<ValidationObjectFrame, 16> frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
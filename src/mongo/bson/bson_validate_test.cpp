@@ -320,6 +320,26 @@ TEST(BSONValidateFast, StringHasSomething) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize()));
 }
 
+TEST(BSONValidateFast, FieldNamesOfAllShortLengths) {
+    for (size_t len = 0; len < 20; len++) {
+        const std::string fieldName(len, 'a');
+        const BSONObj x = BSON(fieldName << 1 << "_id" << 1);
+        ASSERT_OK(validateBSON(x.objdata(), x.objsize()));
+
+        // Truncating the buffer within the field name leaves it without terminator
+        const int truncatedSize = 4 + 1 + len;
+        ASSERT_NOT_OK(validateBSON(x.objdata(), truncatedSize));
+    }
+}
+
+TEST(BSONValidateFast, DeeplyNestedObject) {
+    BSONObj x = BSON("x" << 1);
+    for (int i = 0; i < 100; i++) {
+        x = BSON("a" << x << "b" << i);
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize()));
+}
+
 TEST(BSONValidateBool, BoolValuesAreValidated) {
     BSONObjBuilder bob;
     bob.append("x", false);
@@ -51,14 +51,45 @@ using std::dec;
 using std::hex;
 using std::string;
 
+namespace {
+
+/**
+ * Writes 'str' to 's' the way escape() would, without copying it when nothing needs escaping,
+ * which is the common case.
+ */
+void writeEscaped(std::stringstream& s, StringData str, bool escapeSlash = false) {
+    for (char c : str) {
+        if (c == '"' || c == '\\' || (c == '/' && escapeSlash) || (c >= 0 && c <= 0x1f)) {
+            s << escape(str.toString(), escapeSlash);
+            return;
+        }
+    }
+    s.write(str.rawData(), str.size());
+}
+
+}  // namespace
+
 string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames, int pretty) const {
     std::stringstream s;
-    if (includeFieldNames)
-        s << '"' << escape(fieldName()) << "\" : ";
+    jsonStringStream(format, includeFieldNames, pretty, s);
+    return s.str();
+}
+
+void BSONElement::jsonStringStream(JsonStringFormat format,
+                                   bool includeFieldNames,
+                                   int pretty,
+                                   std::stringstream& s) const {
+    if (includeFieldNames) {
+        s << '"';
+        writeEscaped(s, fieldNameStringData());
+        s << "\" : ";
+    }
     switch (type()) {
         case mongo::String:
         case Symbol:
-            s << '"' << escape(string(valuestr(), valuestrsize() - 1)) << '"';
+            s << '"';
+            writeEscaped(s, StringData(valuestr(), valuestrsize() - 1));
+            s << '"';
             break;
         case NumberLong:
             if (format == TenGen) {
@@ -125,7 +156,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             }
             break;
         case Object:
-            s << embeddedObject().jsonString(format, pretty);
+            embeddedObject().jsonStringStream(format, pretty, false, s);
             break;
         case mongo::Array: {
             if (embeddedObject().isEmpty()) {
@@ -147,7 +178,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
                     if (strtol(e.fieldName(), 0, 10) > count) {
                         s << "undefined";
                     } else {
-                        s << e.jsonString(format, false, pretty ? pretty + 1 : 0);
+                        e.jsonStringStream(format, false, pretty ? pretty + 1 : 0, s);
                         e = i.next();
                     }
                     count++;
@@ -198,6 +229,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             s.width(2);
             s.fill('0');
             s << type << dec;
+            s.fill(' ');
             s << "\" }";
             break;
         }
@@ -264,7 +296,9 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             BSONObj scope = codeWScopeObject();
             if (!scope.isEmpty()) {
                 s << "{ \"$code\" : \"" << escape(_asCode()) << "\" , "
-                  << "\"$scope\" : " << scope.jsonString() << " }";
+                  << "\"$scope\" : ";
+                scope.jsonStringStream(Strict, 0, false, s);
+                s << " }";
                 break;
             }
         }
@@ -299,7 +333,6 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             string message = ss.str();
             massert(10312, message.c_str(), false);
     }
-    return s.str();
 }
 
 namespace {
@@ -1041,16 +1074,12 @@ int compareElementValues(const BSONElement& l,
     return -1;
 }
 
-size_t BSONElement::Hasher::operator()(const BSONElement& elem) const {
-    size_t hash = 0;
-
-    boost::hash_combine(hash, elem.canonicalType());
-
-    const StringData fieldName = elem.fieldNameStringData();
-    if (!fieldName.empty()) {
-        boost::hash_combine(hash, StringData::Hasher()(fieldName));
-    }
+namespace {
 
+/**
+ * Combines the hash of the value of 'elem', not including its type and field name, into 'hash'.
+ */
+void hashCombineValue(size_t& hash, const BSONElement& elem) {
     switch (elem.type()) {
         // Order of types is the same as in compareElementValues().
 
@@ -1145,6 +1174,29 @@ size_t BSONElement::Hasher::operator()(const BSONElement& elem) const {
             break;
         }
     }
+}
+
+}  // namespace
+
+size_t BSONElement::Hasher::operator()(const BSONElement& elem) const {
+    size_t hash = 0;
+
+    boost::hash_combine(hash, elem.canonicalType());
+
+    const StringData fieldName = elem.fieldNameStringData();
+    if (!fieldName.empty()) {
+        boost::hash_combine(hash, StringData::Hasher()(fieldName));
+    }
+
+    hashCombineValue(hash, elem);
+    return hash;
+}
+
+size_t BSONElement::ValueHasher::operator()(const BSONElement& elem) const {
+    size_t hash = 0;
+
+    boost::hash_combine(hash, elem.canonicalType());
+    hashCombineValue(hash, elem);
     return hash;
 }
 
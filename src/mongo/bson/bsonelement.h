@@ -31,6 +31,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <iosfwd>
 #include <string.h>  // strlen
 #include <string>
 #include <vector>
@@ -187,6 +188,15 @@ public:
     std::string jsonString(JsonStringFormat format,
                            bool includeFieldNames = true,
                            int pretty = 0) const;
+
+    /**
+     * Same as jsonString, but appends to 's' instead of returning a new string, so that the
+     * elements of a document can all be written to one stream.
+     */
+    void jsonStringStream(JsonStringFormat format,
+                          bool includeFieldNames,
+                          int pretty,
+                          std::stringstream& s) const;
     operator std::string() const {
         return toString();
     }
@@ -521,6 +531,15 @@ public:
         size_t operator()(const BSONElement& elem) const;
     };
 
+    /**
+     * Same as Hasher, but ignores the field name, for use with containers which compare elements
+     * with woCompare(other, false). Strings are hashed by their bytes, so this is not suitable for
+     * comparisons which use a collator.
+     */
+    struct ValueHasher {
+        size_t operator()(const BSONElement& elem) const;
+    };
+
     const char* rawdata() const {
         return data;
     }
@@ -88,16 +88,26 @@ BSONObj BSONObj::getOwned() const {
 }
 
 string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArray) const {
-    if (isEmpty())
-        return isArray ? "[]" : "{}";
+    std::stringstream s;
+    jsonStringStream(format, pretty, isArray, s);
+    return s.str();
+}
+
+void BSONObj::jsonStringStream(JsonStringFormat format,
+                               int pretty,
+                               bool isArray,
+                               std::stringstream& s) const {
+    if (isEmpty()) {
+        s << (isArray ? "[]" : "{}");
+        return;
+    }
 
-    StringBuilder s;
     s << (isArray ? "[ " : "{ ");
     BSONObjIterator i(*this);
     BSONElement e = i.next();
     if (!e.eoo())
         while (1) {
-            s << e.jsonString(format, !isArray, pretty ? pretty + 1 : 0);
+            e.jsonStringStream(format, !isArray, pretty ? pretty + 1 : 0, s);
             e = i.next();
             if (e.eoo())
                 break;
@@ -111,7 +121,6 @@ string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArray) co
             }
         }
     s << (isArray ? " ]" : " }");
-    return s.str();
 }
 
 bool BSONObj::valid() const {
@@ -221,6 +221,12 @@ public:
                            int pretty = 0,
                            bool isArray = false) const;
 
+    /** Same as jsonString, but appends to 's' instead of returning a new string. */
+    void jsonStringStream(JsonStringFormat format,
+                          int pretty,
+                          bool isArray,
+                          std::stringstream& s) const;
+
     /** note: addFields always adds _id even if not specified */
     int addFields(BSONObj& from, std::set<std::string>& fields); /* returns n added */
 
@@ -73,6 +73,28 @@ public:
         _b.reserveBytes(1);
     }
 
+    /**
+     * Builds into memory taken from 'arena'. The object returned by done() or asTempObj() is
+     * valid only as long as the arena; obj() copies the result to the heap. A null 'arena' builds
+     * on the heap, like the constructors above.
+     */
+    explicit BSONObjBuilder(Arena* arena, int initsize = 512)
+        : _b(_buf), _buf(arena, initsize), _offset(0), _s(this), _tracker(0), _doneCalled(false) {
+        _b.skip(sizeof(int));
+        _b.reserveBytes(1);
+    }
+
+    BSONObjBuilder(Arena* arena, const BSONSizeTracker& tracker)
+        : _b(_buf),
+          _buf(arena, tracker.getSize()),
+          _offset(0),
+          _s(this),
+          _tracker(const_cast<BSONSizeTracker*>(&tracker)),
+          _doneCalled(false) {
+        _b.skip(sizeof(int));
+        _b.reserveBytes(1);
+    }
+
     /** @param baseBuilder construct a BSONObjBuilder using an existing BufBuilder
      *  This is for more efficient adding of subobjects/arrays. See docs for subobjStart for
      *  example.
@@ -331,5 +331,24 @@ TEST(BSONObjBuilderTest, ResetToEmptyForNestedBuilderOnlyResetsInnerObj) {
     ASSERT_EQ(BSON("a" << 3 << "nestedObj" << BSONObj()), bob.obj());
 }
 
+TEST(BSONObjBuilderTest, ArenaBackedBuilderObjOutlivesArena) {
+    BSONObj obj;
+    {
+        Arena arena;
+        BSONObjBuilder bob(&arena);
+        bob.append("a", 1);
+        BSONObjBuilder sub(bob.subobjStart("b"));
+        sub.append("c", "x");
+        sub.done();
+        ASSERT_EQ(BSON("a" << 1 << "b" << BSON("c"
+                                                 << "x")),
+                  bob.asTempObj());
+        obj = bob.obj();
+    }
+    ASSERT_EQ(BSON("a" << 1 << "b" << BSON("c"
+                                             << "x")),
+              obj);
+}
+
 }  // unnamed namespace
 }  // namespace mongo
@@ -65,8 +65,6 @@ enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
-    STRINGVAL_RESERVE_SIZE = 4096,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
     NS_RESERVE_SIZE = 64,
@@ -76,6 +74,15 @@ enum {
     DATE_RESERVE_SIZE = 64
 };
 
+namespace {
+
+// Unlike isdigit(), not locale dependent and safe to call on negative chars
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+}  // namespace
+
 static const char *LBRACE = "{", *RBRACE = "}", *LBRACKET = "[", *RBRACKET = "]", *LPAREN = "(",
                   *RPAREN = ")", *COLON = ":", *COMMA = ",", *FORWARDSLASH = "/",
                   *SINGLEQUOTE = "'", *DOUBLEQUOTE = "\"";
@@ -95,6 +102,24 @@ Status JParse::parseError(StringData msg) {
 
 Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
     MONGO_JSON_DEBUG("fieldName: " << fieldName);
+
+    // Strings and numbers are by far the most common values, so look for them before trying each
+    // of the keywords in turn. No keyword starts with a quote, a digit or a '-' and a digit.
+    const char* next = skipWhitespace();
+    if (next < _input_end && (*next == '"' || *next == '\'')) {
+        std::string valueString;
+        Status ret = quotedString(&valueString);
+        if (ret != Status::OK()) {
+            return ret;
+        }
+        builder.append(fieldName, valueString);
+        return Status::OK();
+    }
+    if (next < _input_end &&
+        (isDigit(*next) || (*next == '-' && next + 1 < _input_end && isDigit(next[1])))) {
+        return number(fieldName, builder);
+    }
+
     if (peekToken(LBRACE)) {
         Status ret = object(fieldName, builder);
         if (ret != Status::OK()) {
@@ -150,14 +175,6 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
         if (ret != Status::OK()) {
             return ret;
         }
-    } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
-        std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
-        Status ret = quotedString(&valueString);
-        if (ret != Status::OK()) {
-            return ret;
-        }
-        builder.append(fieldName, valueString);
     } else if (readToken("true")) {
         builder.append(fieldName, true);
     } else if (readToken("false")) {
@@ -202,7 +219,6 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
 
     // Special object
     std::string firstField;
-    firstField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&firstField);
     if (ret != Status::OK()) {
         return ret;
@@ -314,9 +330,10 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        // Reused for every field, so that long field names only need to be allocated for once
+        std::string fieldName;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
+            fieldName.clear();
             Status fieldRet = field(&fieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
@@ -429,7 +446,6 @@ Status JParse::dateObject(StringData fieldName, BSONObjBuilder& builder) {
         date = dateRet.getValue();
     } else if (readToken(LBRACE)) {
         std::string fieldName;
-        fieldName.reserve(FIELD_RESERVE_SIZE);
         Status ret = field(&fieldName);
         if (ret != Status::OK()) {
             return ret;
@@ -999,6 +1015,10 @@ Status JParse::regexOptCheck(StringData opt) {
 }
 
 Status JParse::number(StringData fieldName, BSONObjBuilder& builder) {
+    if (integer(fieldName, builder)) {
+        return Status::OK();
+    }
+
     char* endptrll;
     char* endptrd;
     long long retll;
@@ -1042,6 +1062,43 @@ Status JParse::number(StringData fieldName, BSONObjBuilder& builder) {
     return Status::OK();
 }
 
+bool JParse::integer(StringData fieldName, BSONObjBuilder& builder) {
+    const char* q = skipWhitespace();
+
+    const bool negative = q < _input_end && *q == '-';
+    if (negative) {
+        ++q;
+    }
+
+    // At most 18 digits, so that the value cannot overflow
+    const char* const digitsBegin = q;
+    long long value = 0;
+    while (q < _input_end && q - digitsBegin < 18 && isDigit(*q)) {
+        value = value * 10 + (*q - '0');
+        ++q;
+    }
+
+    // Anything that could continue the number, such as a decimal point, an exponent, a hex prefix
+    // or more digits, is left to the general case. So is a number at the very end of the input,
+    // which is an error.
+    if (q == digitsBegin || q >= _input_end || isDigit(*q) || *q == '.' ||
+        isalpha(static_cast<unsigned char>(*q))) {
+        return false;
+    }
+
+    if (negative) {
+        value = -value;
+    }
+
+    if (value == static_cast<int>(value)) {
+        builder.append(fieldName, static_cast<int>(value));
+    } else {
+        builder.append(fieldName, value);
+    }
+    _input = q;
+    return true;
+}
+
 Status JParse::field(std::string* result) {
     MONGO_JSON_DEBUG("");
     if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
@@ -1100,8 +1157,26 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
         return parseError("Unexpected end of input");
     }
     const char* q = _input;
+
+    // Quoted strings end at a single character. For them, runs of characters which need no
+    // unescaping are copied in one go.
+    const bool singleTerminal =
+        allowedSet == NULL && terminalSet[0] != '\0' && terminalSet[1] == '\0';
+
     while (q < _input_end && !match(*q, terminalSet)) {
         MONGO_JSON_DEBUG("q: " << q);
+        if (singleTerminal) {
+            const char* runEnd = q;
+            while (runEnd < _input_end && *runEnd != terminalSet[0] && *runEnd != '\\' &&
+                   !(0x00 <= *runEnd && *runEnd <= 0x1F)) {
+                ++runEnd;
+            }
+            if (runEnd != q) {
+                result->append(q, runEnd - q);
+                q = runEnd;
+                continue;
+            }
+        }
         if (allowedSet != NULL) {
             if (!match(*q, allowedSet)) {
                 _input = q;
@@ -1209,6 +1284,17 @@ std::string JParse::encodeUTF8(unsigned char first, unsigned char second) const
     return oss.str();
 }
 
+const char* JParse::skipWhitespace() const {
+    const char* q = _input;
+    // 'isspace()' takes an 'int' (signed), so (default signed) 'char's get sign-extended
+    // and therefore 'corrupted' unless we force them to be unsigned ... 0x80 becomes
+    // 0xffffff80 as seen by isspace when sign-extended ... we want it to be 0x00000080
+    while (q < _input_end && isspace(*reinterpret_cast<const unsigned char*>(q))) {
+        ++q;
+    }
+    return q;
+}
+
 inline bool JParse::peekToken(const char* token) {
     return readTokenImpl(token, false);
 }
@@ -1246,7 +1332,6 @@ bool JParse::readTokenImpl(const char* token, bool advance) {
 bool JParse::readField(StringData expectedField) {
     MONGO_JSON_DEBUG("expectedField: " << expectedField);
     std::string nextField;
-    nextField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&nextField);
     if (ret != Status::OK()) {
         return false;
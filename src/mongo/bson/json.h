@@ -355,6 +355,14 @@ private:
      */
     Status number(StringData fieldName, BSONObjBuilder&);
 
+    /**
+     * Fast path of number() for plain decimal integers, which avoids scanning them with both
+     * strtod and strtoll.
+     * @return true if the number at the cursor was such an integer and has been appended, false
+     * if the general case must handle it, in which case the cursor has not moved.
+     */
+    bool integer(StringData fieldName, BSONObjBuilder&);
+
     /*
      * FIELD :
      *     STRING
@@ -419,6 +427,13 @@ private:
      */
     std::string encodeUTF8(unsigned char first, unsigned char second) const;
 
+    /**
+     * @return a pointer to the next non whitespace character in our
+     * buffer, or to the end of the buffer.  Does not update the pointer
+     * to our buffer.
+     */
+    const char* skipWhitespace() const;
+
     /**
      * @return true if the given token matches the next non whitespace
      * sequence in our buffer, and false if the token doesn't match or
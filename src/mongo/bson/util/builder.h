@@ -45,6 +45,7 @@
 #include "mongo/platform/decimal128.h"
 #include "mongo/stdx/type_traits.h"
 #include "mongo/util/allocator.h"
+#include "mongo/util/arena.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/shared_buffer.h"
 
@@ -77,25 +78,59 @@ class SharedBufferAllocator {
 public:
     SharedBufferAllocator() = default;
 
+    /**
+     * Allocates from 'arena' instead of the heap. The buffer is freed in bulk with the arena, so
+     * release() must copy it out to the heap.
+     */
+    explicit SharedBufferAllocator(Arena* arena) : _arena(arena) {}
+
     void malloc(size_t sz) {
+        if (_arena) {
+            _ptr = static_cast<char*>(_arena->allocate(sz));
+            _size = sz;
+            return;
+        }
         _buf = SharedBuffer::allocate(sz);
+        _ptr = _buf.get();
     }
     void realloc(size_t sz) {
+        if (_arena) {
+            _ptr = static_cast<char*>(_arena->reallocate(_ptr, _size, sz));
+            _size = sz;
+            return;
+        }
         _buf.realloc(sz);
+        _ptr = _buf.get();
     }
     void free() {
         _buf = {};
+        _ptr = nullptr;
+        _size = 0;
     }
     SharedBuffer release() {
+        if (_arena) {
+            SharedBuffer copy = SharedBuffer::allocate(_size);
+            if (_size) {
+                memcpy(copy.get(), _ptr, _size);
+            }
+            free();
+            return copy;
+        }
+        _ptr = nullptr;
         return std::move(_buf);
     }
 
     char* get() const {
-        return _buf.get();
+        return _ptr;
     }
 
 private:
     SharedBuffer _buf;
+    char* _ptr = nullptr;
+
+    // Only used when allocating from '_arena', which needs the old size to grow a buffer.
+    Arena* const _arena = nullptr;
+    size_t _size = 0;
 };
 
 class StackAllocator {
@@ -149,6 +184,18 @@ public:
         l = 0;
         reservedBytes = 0;
     }
+
+    /**
+     * Builds into memory taken from 'arena', which must outlive the builder and every pointer
+     * into its buffer. release() returns a heap copy.
+     */
+    _BufBuilder(Arena* arena, int initsize = 512) : _buf(arena), size(initsize) {
+        if (size > 0) {
+            _buf.malloc(size);
+        }
+        l = 0;
+        reservedBytes = 0;
+    }
     ~_BufBuilder() {
         kill();
     }
@@ -66,4 +66,32 @@ TEST(Builder, StringBuilderAddress) {
     sb << nullPtr;
     ASSERT_EQUALS("0x0", sb.str());
 }
+
+TEST(Builder, ArenaBackedBufBuilderGrows) {
+    Arena arena(64);
+    BufBuilder bb(&arena, 16);
+    for (int i = 0; i < 100; ++i) {
+        bb.appendNum(i);
+    }
+
+    ASSERT_EQUALS(400, bb.len());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQUALS(i, ConstDataView(bb.buf()).read<LittleEndian<int>>(i * sizeof(int)));
+    }
+    ASSERT_GREATER_THAN_OR_EQUALS(arena.bytesAllocated(), 400U);
+}
+
+TEST(Builder, ArenaBackedBufBuilderReleaseCopiesToHeap) {
+    SharedBuffer released;
+    {
+        Arena arena;
+        BufBuilder bb(&arena);
+        bb.appendStr("eliot");
+        const char* arenaBuf = bb.buf();
+        released = bb.release();
+        ASSERT_NOT_EQUALS(static_cast<const void*>(arenaBuf),
+                          static_cast<const void*>(released.get()));
+    }
+    ASSERT_EQUALS(0, strcmp("eliot", released.get()));
+}
 }
@@ -47,6 +47,10 @@ enum ResultFlagType {
        the QueryOption_AwaitData option. if it doesn't, a repl slave client should sleep
     a little between getMore's.
     */
-    ResultFlag_AwaitCapable = 8
+    ResultFlag_AwaitCapable = 8,
+
+    /* set on a reply to a find or getMore command run with QueryOption_Exhaust when the server
+       will send the next batch of the cursor without waiting for another request. */
+    ResultFlag_MoreToCome = 16
 };
 }
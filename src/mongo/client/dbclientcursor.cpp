@@ -36,6 +36,7 @@
 #include "mongo/client/connpool.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/query/getmore_request.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata.h"
@@ -56,6 +57,22 @@ using std::string;
 using std::vector;
 
 namespace {
+/**
+ * Returns the batch document at '*data' and advances '*data' past it. If 'dataIsArray' is true,
+ * '*data' points at an element of a BSON array of documents.
+ */
+BSONObj readBatchDocument(const char** data, bool dataIsArray) {
+    if (dataIsArray) {
+        BSONElement elt(*data);
+        *data += elt.size();
+        return elt.embeddedObjectUserCheck();
+    }
+
+    BSONObj o(*data);
+    *data += o.objsize();
+    return o;
+}
+
 /**
  * This code is mostly duplicated from DBClientWithCommands::runCommand. It may not
  * be worth de-duplicating as this codepath will eventually be removed anyway.
@@ -95,7 +112,8 @@ Message assembleCommandRequest(DBClientWithCommands* cli,
 }  // namespace
 
 int DBClientCursor::nextBatchSize() {
-    if (nToReturn == 0)
+    // The nToReturn of an exhaust command only applied to the command itself.
+    if (nToReturn == 0 || _isExhaustCommand())
         return batchSize;
 
     if (batchSize == 0)
@@ -112,7 +130,8 @@ void DBClientCursor::_assembleInit(Message& toSend) {
         // so we need to allow the shell to send invalid options so that we can
         // test that the server rejects them. Thus, to allow generating commands with
         // invalid options, we validate them here, and fall back to generating an OP_QUERY
-        // through assembleQueryRequest if the options are invalid.
+        // through assembleQueryRequest if the options are invalid. Exhaust commands are also
+        // sent as OP_QUERY, which is the only protocol that lets the server stream replies.
 
         bool hasValidNToReturnForCommand = (nToReturn == 1 || nToReturn == -1);
         bool hasValidFlagsForCommand = !(opts & mongo::QueryOption_Exhaust);
@@ -187,14 +206,21 @@ void DBClientCursor::requestMore() {
         nToReturn -= batch.nReturned;
         verify(nToReturn > 0);
     }
-    BufBuilder b;
-    b.appendNum(opts);
-    b.appendStr(ns);
-    b.appendNum(nextBatchSize());
-    b.appendNum(cursorId);
 
     Message toSend;
-    toSend.setData(dbGetMore, b.buf(), b.len());
+    if (_isExhaustCommand()) {
+        // The server did not stream the cursor of the exhaust command, so fetch the next batch with
+        // a getMore command. A legacy getMore would be run against the $cmd namespace.
+        assembleQueryRequest(
+            ns, _exhaustCommandGetMore, 1, 0, nullptr, opts & ~QueryOption_Exhaust, toSend);
+    } else {
+        BufBuilder b;
+        b.appendNum(opts);
+        b.appendStr(ns);
+        b.appendNum(nextBatchSize());
+        b.appendNum(cursorId);
+        toSend.setData(dbGetMore, b.buf(), b.len());
+    }
     Message response;
 
     if (_client) {
@@ -232,6 +258,11 @@ void DBClientCursor::commandDataReceived() {
 
     batch.nReturned = 1;
     batch.pos = 0;
+    batch.dataIsArray = false;
+
+    if (_isExhaustCommand() && exhaustCommandBatchReceived()) {
+        return;
+    }
 
     auto commandReply = rpc::makeReply(&batch.m);
 
@@ -262,9 +293,72 @@ void DBClientCursor::commandDataReceived() {
     batch.data = qr.data();
 }
 
+bool DBClientCursor::exhaustCommandBatchReceived() {
+    // Exhaust commands are always sent as OP_QUERY, so their replies are OP_REPLYs. The batch is
+    // read from the reply in place, without upconverting the reply as rpc::makeReply() does.
+    invariant(batch.m.operation() == opReply);
+    QueryResult::View qr = batch.m.singleData().view2ptr();
+    const BSONObj reply(qr.data());
+
+    // Only the reply to the command itself has no cursor id yet.
+    const bool isFirstReply = cursorId == 0;
+
+    BSONElement cursorElt = reply["cursor"];
+    Status replyStatus = getStatusFromCommandResult(reply);
+    if (!replyStatus.isOK() || cursorElt.type() != Object) {
+        cursorId = 0;
+        _exhaustCommandStreaming = false;
+
+        // Any other reply to the command itself is returned like the reply to any other command.
+        // A later reply is a failed getMore, which must not pass for a document of the cursor.
+        if (isFirstReply) {
+            return false;
+        }
+        uassertStatusOK(replyStatus);
+        uasserted(40381, str::stream() << "exhaust command reply has no cursor: " << reply);
+    }
+
+    if (_client->getReplyMetadataReader()) {
+        auto commandReply = rpc::makeReply(&batch.m);
+        uassertStatusOK(_client->getReplyMetadataReader()(commandReply->getMetadata(),
+                                                          _client->getServerAddress()));
+    }
+
+    BSONObj cursorObj = cursorElt.embeddedObject();
+    BSONElement batchElt = cursorObj["firstBatch"];
+    if (batchElt.eoo()) {
+        batchElt = cursorObj["nextBatch"];
+    }
+    uassert(40380,
+            str::stream() << "malformed cursor in exhaust command reply: " << cursorObj,
+            batchElt.type() == Array);
+
+    BSONObj batchObj = batchElt.embeddedObject();
+    batch.nReturned = batchObj.nFields();
+    batch.data = batchObj.firstElement().rawdata();
+    batch.dataIsArray = true;
+
+    // A server which does not stream command cursors leaves the reply unflagged. The rest of the
+    // cursor is then fetched with getMore commands.
+    cursorId = cursorObj["id"].numberLong();
+    _exhaustCommandStreaming = cursorId != 0 && (qr.getResultFlags() & ResultFlag_MoreToCome);
+    if (cursorId != 0 && !_exhaustCommandStreaming) {
+        auto getMore = GetMoreRequest::makeExhaustGetMore(query, reply);
+        uassert(40382,
+                str::stream() << "exhaust command reply has no cursor namespace: " << cursorObj,
+                getMore);
+        _exhaustCommandGetMore = getMore->toBSON();
+    }
+    return true;
+}
+
+bool DBClientCursor::_isExhaustCommand() const {
+    return _isCommand && (opts & QueryOption_Exhaust) && GetMoreRequest::isExhaustCommand(query);
+}
+
 void DBClientCursor::dataReceived(bool& retry, string& host) {
-    // If this is a reply to our initial command request.
-    if (_isCommand && cursorId == 0) {
+    // If this is a reply to our initial command request, or to a command we are exhausting.
+    if (_isCommand && (cursorId == 0 || _isExhaustCommand())) {
         commandDataReceived();
         return;
     }
@@ -298,6 +392,7 @@ void DBClientCursor::dataReceived(bool& retry, string& host) {
     batch.nReturned = qr.getNReturned();
     batch.pos = 0;
     batch.data = qr.data();
+    batch.dataIsArray = false;
 
     _client->checkResponse(batch.data, batch.nReturned, &retry, &host);  // watches for "not master"
 
@@ -329,7 +424,11 @@ bool DBClientCursor::more() {
     if (cursorId == 0)
         return false;
 
-    requestMore();
+    if (_exhaustCommandStreaming) {
+        exhaustReceiveMore();
+    } else {
+        requestMore();
+    }
     return batch.pos < batch.nReturned;
 }
 
@@ -344,10 +443,8 @@ BSONObj DBClientCursor::next() {
     uassert(13422, "DBClientCursor next() called but more() is false", batch.pos < batch.nReturned);
 
     batch.pos++;
-    BSONObj o(batch.data);
-    batch.data += o.objsize();
     /* todo would be good to make data null at end of batch for safety */
-    return o;
+    return readBatchDocument(&batch.data, batch.dataIsArray);
 }
 
 BSONObj DBClientCursor::nextSafe() {
@@ -382,8 +479,7 @@ void DBClientCursor::peek(vector<BSONObj>& v, int atMost) {
     int p = batch.pos;
     const char* d = batch.data;
     while (m && p < batch.nReturned) {
-        BSONObj o(d);
-        d += o.objsize();
+        BSONObj o = readBatchDocument(&d, batch.dataIsArray);
         p++;
         m--;
         v.push_back(o);
@@ -489,7 +585,10 @@ DBClientCursor::DBClientCursor(DBClientBase* client,
       _isCommand(nsIsFull(ns) ? nsToCollectionSubstring(ns) == "$cmd" : false),
       query(query),
       nToReturn(nToReturn),
-      haveLimit(nToReturn > 0 && !(queryOptions & QueryOption_CursorTailable)),
+      // The nToReturn of a command is not a limit, even when the command's cursor is exhausted.
+      haveLimit(nToReturn > 0 && !(queryOptions & QueryOption_CursorTailable) &&
+                !(_isCommand && (queryOptions & QueryOption_Exhaust) &&
+                  GetMoreRequest::isExhaustCommand(query))),
       nToSkip(nToSkip),
       fieldsToReturn(fieldsToReturn),
       opts(queryOptions),
@@ -215,6 +215,10 @@ public:
         int pos{0};
         const char* data{nullptr};
 
+        // If true, 'data' points at the elements of a BSON array of documents within 'm', such as
+        // the batch of a command cursor, instead of at consecutive documents.
+        bool dataIsArray{false};
+
     public:
         Batch() = default;
     };
@@ -269,6 +273,14 @@ private:
     std::string _lazyHost;
     bool wasError;
 
+    // True while the server streams the batches of an exhaust command's cursor, so that more()
+    // waits for the next batch instead of requesting it.
+    bool _exhaustCommandStreaming{false};
+
+    // The getMore command which fetches the next batch of an exhaust command's cursor from a
+    // server which does not stream it.
+    BSONObj _exhaustCommandGetMore;
+
     void dataReceived() {
         bool retry;
         std::string lazyHost;
@@ -283,6 +295,23 @@ private:
      */
     void commandDataReceived();
 
+    /**
+     * Called by commandDataReceived for each reply of an exhaust find or getMore command. If the
+     * reply succeeded and has a cursor, makes the documents of its batch the current batch of this
+     * cursor, reading them in place, and returns true. The cursor id is taken from the reply, and
+     * more() keeps receiving replies for as long as the server flags them with
+     * ResultFlag_MoreToCome, and otherwise sends getMore commands. A reply to the command itself
+     * which failed or has no cursor ends the stream and returns false; any later one throws.
+     */
+    bool exhaustCommandBatchReceived();
+
+    /**
+     * True if this cursor runs a find or getMore command with QueryOption_Exhaust, which asks the
+     * server to stream the batches of the command's cursor without waiting for getMore requests.
+     * This cursor then returns the documents of those batches.
+     */
+    bool _isExhaustCommand() const;
+
     void requestMore();
 
     // Don't call from a virtual function
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <set>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/util/time_support.h"
 
@@ -72,6 +74,16 @@ public:
     virtual StatusWith<HostAndPort> findHost(const ReadPreferenceSetting& readPref,
                                              Milliseconds maxWait = Milliseconds(0)) = 0;
 
+    /**
+     * Obtains a host, which matches the read preferences specified by readPref and is not one of
+     * 'excludedHosts'. Never blocks: only the cached view of the replica set's host state is
+     * consulted. Used to pick a second host for hedged reads.
+     *
+     * Returns FailedToSatisfyReadPreference if no such host is known.
+     */
+    virtual StatusWith<HostAndPort> findHostExcluding(
+        const ReadPreferenceSetting& readPref, const std::set<HostAndPort>& excludedHosts) = 0;
+
     /**
      * Reports to the targeter that a NotMaster response was received when communicating with
      * "host', and so it should update its bookkeeping to avoid giving out the host again on a
@@ -36,7 +36,8 @@
 namespace mongo {
 
 RemoteCommandTargeterMock::RemoteCommandTargeterMock()
-    : _findHostReturnValue(Status(ErrorCodes::InternalError, "No return value set")) {}
+    : _findHostReturnValue(Status(ErrorCodes::InternalError, "No return value set")),
+      _findHostExcludingReturnValue(Status(ErrorCodes::InternalError, "No return value set")) {}
 
 RemoteCommandTargeterMock::~RemoteCommandTargeterMock() = default;
 
@@ -57,6 +58,16 @@ StatusWith<HostAndPort> RemoteCommandTargeterMock::findHost(const ReadPreference
     return _findHostReturnValue;
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterMock::findHostExcluding(
+    const ReadPreferenceSetting& readPref, const std::set<HostAndPort>& excludedHosts) {
+    if (_findHostExcludingReturnValue.isOK() &&
+        excludedHosts.count(_findHostExcludingReturnValue.getValue())) {
+        return Status(ErrorCodes::FailedToSatisfyReadPreference, "Host was excluded");
+    }
+
+    return _findHostExcludingReturnValue;
+}
+
 void RemoteCommandTargeterMock::markHostNotMaster(const HostAndPort& host) {}
 
 void RemoteCommandTargeterMock::markHostUnreachable(const HostAndPort& host) {}
@@ -69,4 +80,9 @@ void RemoteCommandTargeterMock::setFindHostReturnValue(StatusWith<HostAndPort> r
     _findHostReturnValue = std::move(returnValue);
 }
 
+void RemoteCommandTargeterMock::setFindHostExcludingReturnValue(
+    StatusWith<HostAndPort> returnValue) {
+    _findHostExcludingReturnValue = std::move(returnValue);
+}
+
 }  // namespace mongo
@@ -57,6 +57,14 @@ public:
     StatusWith<HostAndPort> findHost(const ReadPreferenceSetting& readPref,
                                      Milliseconds maxWait) override;
 
+    /**
+     * Returns the return value last set by setFindHostExcludingReturnValue, unless that host is
+     * one of 'excludedHosts', in which case returns FailedToSatisfyReadPreference.
+     * Returns ErrorCodes::InternalError if setFindHostExcludingReturnValue was never called.
+     */
+    StatusWith<HostAndPort> findHostExcluding(const ReadPreferenceSetting& readPref,
+                                              const std::set<HostAndPort>& excludedHosts) override;
+
     /**
      * No-op for the mock.
      */
@@ -77,9 +85,15 @@ public:
      */
     void setFindHostReturnValue(StatusWith<HostAndPort> returnValue);
 
+    /**
+     * Sets the return value for the next call to findHostExcluding.
+     */
+    void setFindHostExcludingReturnValue(StatusWith<HostAndPort> returnValue);
+
 private:
     ConnectionString _connectionStringReturnValue;
     StatusWith<HostAndPort> _findHostReturnValue;
+    StatusWith<HostAndPort> _findHostExcludingReturnValue;
 };
 
 }  // namespace mongo
@@ -63,6 +63,11 @@ StatusWith<HostAndPort> RemoteCommandTargeterRS::findHost(const ReadPreferenceSe
     return _rsMonitor->getHostOrRefresh(readPref, maxWait);
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterRS::findHostExcluding(
+    const ReadPreferenceSetting& readPref, const std::set<HostAndPort>& excludedHosts) {
+    return _rsMonitor->getHostExcluding(readPref, excludedHosts);
+}
+
 void RemoteCommandTargeterRS::markHostNotMaster(const HostAndPort& host) {
     invariant(_rsMonitor);
 
@@ -55,6 +55,9 @@ public:
     StatusWith<HostAndPort> findHost(const ReadPreferenceSetting& readPref,
                                      Milliseconds maxWait) override;
 
+    StatusWith<HostAndPort> findHostExcluding(const ReadPreferenceSetting& readPref,
+                                              const std::set<HostAndPort>& excludedHosts) override;
+
     void markHostNotMaster(const HostAndPort& host) override;
 
     void markHostUnreachable(const HostAndPort& host) override;
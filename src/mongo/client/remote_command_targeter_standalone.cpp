@@ -32,6 +32,7 @@
 #include "mongo/client/remote_command_targeter_standalone.h"
 
 #include "mongo/base/status_with.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -47,6 +48,17 @@ StatusWith<HostAndPort> RemoteCommandTargeterStandalone::findHost(
     return _hostAndPort;
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterStandalone::findHostExcluding(
+    const ReadPreferenceSetting& readPref, const std::set<HostAndPort>& excludedHosts) {
+    if (excludedHosts.count(_hostAndPort)) {
+        return Status(ErrorCodes::FailedToSatisfyReadPreference,
+                      str::stream() << "Standalone host " << _hostAndPort.toString()
+                                    << " was excluded");
+    }
+
+    return _hostAndPort;
+}
+
 void RemoteCommandTargeterStandalone::markHostNotMaster(const HostAndPort& host) {
     dassert(host == _hostAndPort);
 }
@@ -305,6 +305,20 @@ StatusWith<HostAndPort> ReplicaSetMonitor::getHostOrRefresh(const ReadPreference
                                 << getName());
 }
 
+StatusWith<HostAndPort> ReplicaSetMonitor::getHostExcluding(
+    const ReadPreferenceSetting& criteria, const std::set<HostAndPort>& excludedHosts) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    HostAndPort out = _state->getMatchingHost(criteria, excludedHosts);
+    if (!out.empty())
+        return out;
+
+    return Status(ErrorCodes::FailedToSatisfyReadPreference,
+                  str::stream() << "could not find another host matching read preference "
+                                << criteria.toString()
+                                << " for set "
+                                << getName());
+}
+
 HostAndPort ReplicaSetMonitor::getMasterOrUassert() {
     return uassertStatusOK(getHostOrRefresh(kPrimaryOnlyReadPreference));
 }
@@ -965,33 +979,34 @@ bool SetState::isUsable() const {
     return consecutiveFailedScans < maxConsecutiveFailedChecks;
 }
 
-HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) const {
+HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria,
+                                      const std::set<HostAndPort>& excludedHosts) const {
     switch (criteria.pref) {
         // "Prefered" read preferences are defined in terms of other preferences
         case ReadPreference::PrimaryPreferred: {
-            HostAndPort out =
-                getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+            HostAndPort out = getMatchingHost(
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excludedHosts);
             // NOTE: the spec says we should use the primary even if tags don't match
             if (!out.empty())
                 return out;
             return getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags), excludedHosts);
         }
 
         case ReadPreference::SecondaryPreferred: {
             HostAndPort out = getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags), excludedHosts);
             if (!out.empty())
                 return out;
             // NOTE: the spec says we should use the primary even if tags don't match
             return getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excludedHosts);
         }
 
         case ReadPreference::PrimaryOnly: {
             // NOTE: isMaster implies isUp
             Nodes::const_iterator it = std::find_if(nodes.begin(), nodes.end(), isMaster);
-            if (it == nodes.end())
+            if (it == nodes.end() || excludedHosts.count(it->host))
                 return HostAndPort();
             return it->host;
         }
@@ -1005,7 +1020,8 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
 
                 std::vector<const Node*> matchingNodes;
                 for (size_t i = 0; i < nodes.size(); i++) {
-                    if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag)) {
+                    if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag) &&
+                        !excludedHosts.count(nodes[i].host)) {
                         matchingNodes.push_back(&nodes[i]);
                     }
                 }
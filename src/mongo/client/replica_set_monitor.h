@@ -89,6 +89,15 @@ public:
     StatusWith<HostAndPort> getHostOrRefresh(const ReadPreferenceSetting& readPref,
                                              Milliseconds maxWait = kDefaultFindHostTimeout);
 
+    /**
+     * Returns a host matching the given read preference, which is not one of 'excludedHosts'.
+     * Uses only the cached view of the set and never blocks or refreshes it.
+     *
+     * Returns FailedToSatisfyReadPreference if no such host is known.
+     */
+    StatusWith<HostAndPort> getHostExcluding(const ReadPreferenceSetting& readPref,
+                                             const std::set<HostAndPort>& excludedHosts);
+
     /**
      * Returns the host we think is the current master or uasserts.
      *
@@ -134,11 +134,14 @@ public:
     bool isUsable() const;
 
     /**
-     * Returns a host matching criteria or an empty host if no known host matches.
+     * Returns a host matching criteria or an empty host if no known host matches. Hosts in
+     * 'excludedHosts' are never returned.
      *
      * Note: Uses only local data and does not go over the network.
      */
-    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
+    HostAndPort getMatchingHost(
+        const ReadPreferenceSetting& criteria,
+        const std::set<HostAndPort>& excludedHosts = std::set<HostAndPort>()) const;
 
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
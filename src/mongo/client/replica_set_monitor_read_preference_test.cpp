@@ -50,7 +50,8 @@ HostAndPort selectNode(const vector<Node>& nodes,
                        ReadPreference pref,
                        const TagSet& tagSet,
                        int latencyThresholdMillis,
-                       bool* isPrimarySelected) {
+                       bool* isPrimarySelected,
+                       const set<HostAndPort>& excludedHosts = set<HostAndPort>()) {
     invariant(!nodes.empty());
 
     set<HostAndPort> seeds;
@@ -61,7 +62,7 @@ HostAndPort selectNode(const vector<Node>& nodes,
     set.latencyThresholdMicros = latencyThresholdMillis * 1000;
 
     ReadPreferenceSetting criteria(pref, tagSet);
-    HostAndPort out = set.getMatchingHost(criteria);
+    HostAndPort out = set.getMatchingHost(criteria, excludedHosts);
     if (isPrimarySelected && !out.empty()) {
         Node* node = set.findNode(out);
         ASSERT(node);
@@ -265,6 +266,48 @@ TEST(ReplSetMonitorReadPref, SecPrefWithNoNodeOk) {
     ASSERT(host.empty());
 }
 
+TEST(ReplSetMonitorReadPref, SecOnlyExcludingHost) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    bool isPrimarySelected = false;
+    HostAndPort host = selectNode(nodes,
+                                  mongo::ReadPreference::SecondaryOnly,
+                                  tags,
+                                  1,
+                                  &isPrimarySelected,
+                                  {HostAndPort("a")});
+
+    ASSERT(!isPrimarySelected);
+    ASSERT_EQUALS("c", host.host());
+}
+
+TEST(ReplSetMonitorReadPref, SecPrefExcludingAllSecondaries) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    bool isPrimarySelected = false;
+    HostAndPort host = selectNode(nodes,
+                                  mongo::ReadPreference::SecondaryPreferred,
+                                  tags,
+                                  1,
+                                  &isPrimarySelected,
+                                  {HostAndPort("a"), HostAndPort("c")});
+
+    ASSERT(isPrimarySelected);
+    ASSERT_EQUALS("b", host.host());
+}
+
+TEST(ReplSetMonitorReadPref, PrimaryOnlyExcludingPrimary) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    HostAndPort host = selectNode(
+        nodes, mongo::ReadPreference::PrimaryOnly, tags, 1, nullptr, {HostAndPort("b")});
+
+    ASSERT(host.empty());
+}
+
 TEST(ReplSetMonitorReadPref, NearestAllLocal) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getDefaultTagSet());
@@ -30,6 +30,7 @@
 
 #include "mongo/db/catalog/cursor_manager.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/base/data_cursor.h"
 #include "mongo/base/init.h"
 #include "mongo/db/audit.h"
@@ -39,6 +40,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/plan_executor.h"
@@ -84,6 +86,12 @@ public:
         _run(0xFFFFFFFF, 0xFFFFFFFF);
     }
 } idWorkTest;
+
+// Partition lock acquisitions which had to wait for another thread. Uncontended acquisitions are
+// deliberately not counted, as a shared counter bumped on every pin would itself be contended.
+Counter64 partitionLockContended;
+ServerStatusMetricField<Counter64> displayPartitionLockContended("cursor.partitionLockContended",
+                                                                 &partitionLockContended);
 }
 
 class GlobalCursorIdCache {
@@ -321,67 +329,82 @@ CursorManager::CursorManager(StringData ns) : _nss(ns) {
 CursorManager::~CursorManager() {
     invalidateAll(true, "collection going away");
     globalCursorIdCache->destroyed(_collectionCacheRuntimeId, _nss.ns());
+    delete[] _partitions.load();
 }
 
 void CursorManager::invalidateAll(bool collectionGoingAway, const std::string& reason) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
     fassert(28819, !BackgroundOperation::inProgForNs(_nss));
 
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        // we kill the executor, but it deletes itself
-        PlanExecutor* exec = *it;
-        exec->kill(reason);
+    Partition* partitions = _getPartitionsIfAllocated();
+    if (!partitions) {
+        return;
     }
-    _nonCachedExecutors.clear();
-
-    if (collectionGoingAway) {
-        // we're going to wipe out the world
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-            ClientCursor* cc = i->second;
 
-            cc->kill();
+    for (size_t p = 0; p < kNumPartitions; ++p) {
+        Partition& partition = partitions[p];
+        auto lk = _lockPartition(partition);
 
-            // If the CC is pinned, somebody is actively using it and we do not delete it.
-            // Instead we notify the holder that we killed it.  The holder will then delete the
-            // CC.
-            //
-            // If the CC is not pinned, there is nobody actively holding it.  We can safely
-            // delete it.
-            if (!cc->isPinned()) {
-                delete cc;
-            }
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
+             ++it) {
+            // we kill the executor, but it deletes itself
+            PlanExecutor* exec = *it;
+            exec->kill(reason);
         }
-    } else {
-        CursorMap newMap;
+        partition.nonCachedExecutors.clear();
 
-        // collection will still be around, just all PlanExecutors are invalid
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-            ClientCursor* cc = i->second;
+        if (collectionGoingAway) {
+            // we're going to wipe out the world
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
+                ClientCursor* cc = i->second;
 
-            // Note that a valid ClientCursor state is "no cursor no executor."  This is because
-            // the set of active cursor IDs in ClientCursor is used as representation of query
-            // state.  See sharding_block.h.  TODO(greg,hk): Move this out.
-            if (NULL == cc->getExecutor()) {
-                newMap.insert(*i);
-                continue;
-            }
-
-            if (cc->isPinned() || cc->isAggCursor()) {
-                // Pinned cursors need to stay alive, so we leave them around.  Aggregation
-                // cursors also can stay alive (since they don't have their lifetime bound to
-                // the underlying collection).  However, if they have an associated executor, we
-                // need to kill it, because it's now invalid.
-                if (cc->getExecutor())
-                    cc->getExecutor()->kill(reason);
-                newMap.insert(*i);
-            } else {
                 cc->kill();
-                delete cc;
+
+                // If the CC is pinned, somebody is actively using it and we do not delete it.
+                // Instead we notify the holder that we killed it.  The holder will then delete the
+                // CC.
+                //
+                // If the CC is not pinned, there is nobody actively holding it.  We can safely
+                // delete it.
+                if (!cc->isPinned()) {
+                    delete cc;
+                }
+            }
+        } else {
+            CursorMap newMap;
+
+            // collection will still be around, just all PlanExecutors are invalid
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
+                ClientCursor* cc = i->second;
+
+                // Note that a valid ClientCursor state is "no cursor no executor."  This is because
+                // the set of active cursor IDs in ClientCursor is used as representation of query
+                // state.  See sharding_block.h.  TODO(greg,hk): Move this out.
+                if (NULL == cc->getExecutor()) {
+                    newMap.insert(*i);
+                    continue;
+                }
+
+                if (cc->isPinned() || cc->isAggCursor()) {
+                    // Pinned cursors need to stay alive, so we leave them around.  Aggregation
+                    // cursors also can stay alive (since they don't have their lifetime bound to
+                    // the underlying collection).  However, if they have an associated executor,
+                    // we need to kill it, because it's now invalid.
+                    if (cc->getExecutor())
+                        cc->getExecutor()->kill(reason);
+                    newMap.insert(*i);
+                } else {
+                    cc->kill();
+                    delete cc;
+                }
             }
-        }
 
-        _cursors = newMap;
+            partition.cursors = newMap;
+        }
     }
 }
 
@@ -394,58 +417,89 @@ void CursorManager::invalidateDocument(OperationContext* txn,
         return;
     }
 
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        PlanExecutor* exec = *it;
-        exec->invalidate(txn, dl, type);
+    Partition* partitions = _getPartitionsIfAllocated();
+    if (!partitions) {
+        return;
     }
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        PlanExecutor* exec = i->second->getExecutor();
-        if (exec) {
+    for (size_t p = 0; p < kNumPartitions; ++p) {
+        Partition& partition = partitions[p];
+        auto lk = _lockPartition(partition);
+
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
+             ++it) {
+            PlanExecutor* exec = *it;
             exec->invalidate(txn, dl, type);
         }
+
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            PlanExecutor* exec = i->second->getExecutor();
+            if (exec) {
+                exec->invalidate(txn, dl, type);
+            }
+        }
     }
 }
 
 std::size_t CursorManager::timeoutCursors(int millisSinceLastCall) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    std::size_t numTimedOut = 0;
 
-    vector<ClientCursor*> toDelete;
-
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        if (cc->shouldTimeout(millisSinceLastCall))
-            toDelete.push_back(cc);
+    Partition* partitions = _getPartitionsIfAllocated();
+    if (!partitions) {
+        return numTimedOut;
     }
 
-    for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end(); ++i) {
-        ClientCursor* cc = *i;
-        _deregisterCursor_inlock(cc);
-        cc->kill();
-        delete cc;
+    for (size_t p = 0; p < kNumPartitions; ++p) {
+        Partition& partition = partitions[p];
+        auto lk = _lockPartition(partition);
+
+        vector<ClientCursor*> toDelete;
+
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            if (cc->shouldTimeout(millisSinceLastCall))
+                toDelete.push_back(cc);
+        }
+
+        for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end();
+             ++i) {
+            ClientCursor* cc = *i;
+            _deregisterCursor_inlock(&partition, cc);
+            cc->kill();
+            delete cc;
+        }
+
+        numTimedOut += toDelete.size();
     }
 
-    return toDelete.size();
+    return numTimedOut;
 }
 
 void CursorManager::registerExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    const std::pair<ExecSet::iterator, bool> result = _nonCachedExecutors.insert(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    auto lk = _lockPartition(partition);
+    const std::pair<ExecSet::iterator, bool> result = partition.nonCachedExecutors.insert(exec);
     invariant(result.second);  // make sure this was inserted
 }
 
 void CursorManager::deregisterExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _nonCachedExecutors.erase(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    auto lk = _lockPartition(partition);
+    partition.nonCachedExecutors.erase(exec);
 }
 
 ClientCursor* CursorManager::find(CursorId id, bool pin) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorMap::const_iterator it = _cursors.find(id);
-    if (it == _cursors.end())
+    if (!_getPartitionsIfAllocated()) {
+        return NULL;
+    }
+
+    Partition& partition = _partitionForCursorId(id);
+    auto lk = _lockPartition(partition);
+    CursorMap::const_iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end())
         return NULL;
 
     ClientCursor* cursor = it->second;
@@ -458,7 +512,7 @@ ClientCursor* CursorManager::find(CursorId id, bool pin) {
 }
 
 void CursorManager::unpin(ClientCursor* cursor) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    auto lk = _lockPartition(_partitionForCursorId(cursor->cursorid()));
 
     invariant(cursor->isPinned());
     cursor->unsetPinned();
@@ -469,47 +523,109 @@ bool CursorManager::ownsCursorId(CursorId cursorId) const {
 }
 
 void CursorManager::getCursorIds(std::set<CursorId>* openCursors) const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition* partitions = _getPartitionsIfAllocated();
+    if (!partitions) {
+        return;
+    }
+
+    for (size_t p = 0; p < kNumPartitions; ++p) {
+        const Partition& partition = partitions[p];
+        auto lk = _lockPartition(partition);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        openCursors->insert(cc->cursorid());
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            openCursors->insert(cc->cursorid());
+        }
     }
 }
 
 size_t CursorManager::numCursors() const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    return _cursors.size();
+    size_t numCursors = 0;
+    Partition* partitions = _getPartitionsIfAllocated();
+    if (!partitions) {
+        return numCursors;
+    }
+
+    for (size_t p = 0; p < kNumPartitions; ++p) {
+        auto lk = _lockPartition(partitions[p]);
+        numCursors += partitions[p].cursors.size();
+    }
+    return numCursors;
 }
 
-CursorId CursorManager::_allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        unsigned mypart = static_cast<unsigned>(_random->nextInt32());
-        CursorId id = cursorIdFromParts(_collectionCacheRuntimeId, mypart);
-        if (_cursors.count(id) == 0)
-            return id;
+stdx::unique_lock<stdx::mutex> CursorManager::_lockPartition(const Partition& partition) {
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        partitionLockContended.increment();
+        lk.lock();
     }
-    fassertFailed(17360);
+    return lk;
+}
+
+CursorManager::Partition* CursorManager::_getPartitions() {
+    Partition* partitions = _partitions.load();
+    if (partitions) {
+        return partitions;
+    }
+
+    // Threads registering the first cursors or executors concurrently may each allocate, in which
+    // case all but the first to publish their partitions free them again.
+    std::unique_ptr<Partition[]> newPartitions(new Partition[kNumPartitions]);
+    if (_partitions.compare_exchange_strong(partitions, newPartitions.get())) {
+        return newPartitions.release();
+    }
+    return partitions;
+}
+
+CursorManager::Partition* CursorManager::_getPartitionsIfAllocated() const {
+    return _partitions.load();
+}
+
+CursorManager::Partition& CursorManager::_partitionForCursorId(CursorId id) {
+    // Cursor ids are random, so their low bits spread the cursors evenly over the partitions.
+    return _getPartitions()[static_cast<size_t>(id) & (kNumPartitions - 1)];
+}
+
+CursorManager::Partition& CursorManager::_partitionForExecutor(PlanExecutor* exec) {
+    // Executors are heap allocated, so the low bits of their addresses carry little information.
+    // Multiplicative hashing moves the well distributed bits to the top.
+    const uint64_t hash = reinterpret_cast<uintptr_t>(exec) * 0x9E3779B97F4A7C15ULL;
+    return _getPartitions()[(hash >> 32) & (kNumPartitions - 1)];
+}
+
+CursorId CursorManager::_allocateCursorId() {
+    stdx::lock_guard<SimpleMutex> lk(_randomMutex);
+    unsigned mypart = static_cast<unsigned>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, mypart);
 }
 
 CursorId CursorManager::registerCursor(ClientCursor* cc) {
     invariant(cc);
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorId id = _allocateCursorId_inlock();
-    _cursors[id] = cc;
-    return id;
+    for (int i = 0; i < 10000; i++) {
+        CursorId id = _allocateCursorId();
+        Partition& partition = _partitionForCursorId(id);
+        auto lk = _lockPartition(partition);
+        if (partition.cursors.count(id) == 0) {
+            partition.cursors[id] = cc;
+            return id;
+        }
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _deregisterCursor_inlock(cc);
+    Partition& partition = _partitionForCursorId(cc->cursorid());
+    auto lk = _lockPartition(partition);
+    _deregisterCursor_inlock(&partition, cc);
 }
 
 Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shouldAudit) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition& partition = _partitionForCursorId(id);
+    auto lk = _lockPartition(partition);
 
-    CursorMap::iterator it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    CursorMap::iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end()) {
         if (shouldAudit) {
             audit::logKillCursorsAuthzCheck(txn->getClient(), _nss, id, ErrorCodes::CursorNotFound);
         }
@@ -531,14 +647,14 @@ Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shoul
     }
 
     cursor->kill();
-    _deregisterCursor_inlock(cursor);
+    _deregisterCursor_inlock(&partition, cursor);
     delete cursor;
     return Status::OK();
 }
 
-void CursorManager::_deregisterCursor_inlock(ClientCursor* cc) {
+void CursorManager::_deregisterCursor_inlock(Partition* partition, ClientCursor* cc) {
     invariant(cc);
     CursorId id = cc->cursorid();
-    _cursors.erase(id);
+    partition->cursors.erase(id);
 }
 }
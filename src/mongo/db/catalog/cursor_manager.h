@@ -30,12 +30,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
@@ -143,19 +146,61 @@ public:
     static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
 private:
-    CursorId _allocateCursorId_inlock();
-    void _deregisterCursor_inlock(ClientCursor* cc);
+    // Cursors are spread over the partitions by the low bits of their ids and executors by their
+    // address, so that pinning, registering and yielding on one collection rarely wait on each
+    // other. Must be a power of two.
+    static const size_t kNumPartitions = 16;
+
+    typedef unordered_set<PlanExecutor*> ExecSet;
+    typedef std::map<CursorId, ClientCursor*> CursorMap;
+
+    struct PartitionData {
+        mutable stdx::mutex mutex;
+        ExecSet nonCachedExecutors;
+        CursorMap cursors;
+    };
+
+    // Each partition fills whole cache lines, so no two partition locks share one. The partitions
+    // are padded rather than aligned because they are allocated with plain new, which does not
+    // honor over-aligned types before C++17.
+    static const size_t kCacheLineSize = 64;
+    struct Partition : PartitionData {
+        char padding[kCacheLineSize - sizeof(PartitionData) % kCacheLineSize];
+    };
+    static_assert(sizeof(Partition) % kCacheLineSize == 0,
+                  "cursor manager partitions must fill whole cache lines");
+
+    /**
+     * Locks 'partition', counting the acquisition in serverStatus if it had to wait.
+     */
+    static stdx::unique_lock<stdx::mutex> _lockPartition(const Partition& partition);
+
+    /**
+     * Returns the partitions, allocating them if this is the first cursor or executor registered
+     * with this manager.
+     */
+    Partition* _getPartitions();
+
+    /**
+     * Returns the partitions, or nullptr if nothing has ever been registered with this manager.
+     */
+    Partition* _getPartitionsIfAllocated() const;
+
+    Partition& _partitionForCursorId(CursorId id);
+    Partition& _partitionForExecutor(PlanExecutor* exec);
+
+    CursorId _allocateCursorId();
+    void _deregisterCursor_inlock(Partition* partition, ClientCursor* cc);
 
     NamespaceString _nss;
     unsigned _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
-
-    mutable SimpleMutex _mutex;
 
-    typedef unordered_set<PlanExecutor*> ExecSet;
-    ExecSet _nonCachedExecutors;
+    // Generates cursor ids. Guarded by _randomMutex, which is held only while drawing an id.
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;
 
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    // Many collections never register a cursor or executor, so the partitions are allocated on
+    // first use. Once set, this is never changed until the manager is destroyed.
+    std::atomic<Partition*> _partitions{nullptr};  // NOLINT
 };
 }
@@ -1164,6 +1164,18 @@ Status IndexCatalog::_indexFilteredRecords(OperationContext* txn,
     options.logIfError = false;
     options.dupsAllowed = isDupsAllowed(index->descriptor());
 
+    if (bsonRecords.size() > 1) {
+        int64_t inserted;
+        Status status = index->accessMethod()->insertBatch(txn, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
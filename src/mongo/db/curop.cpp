@@ -496,6 +496,9 @@ string OpDebug::report(const CurOp& curop, const SingleThreadedLockStats& lockSt
     if (responseLength > 0) {
         s << " reslen:" << responseLength;
     }
+    if (arenaBytes > 0) {
+        s << " arenaBytes:" << arenaBytes;
+    }
 
     {
         BSONObjBuilder locks;
@@ -596,6 +599,9 @@ void OpDebug::append(const CurOp& curop,
 
     OPDEBUG_APPEND_NUMBER(nreturned);
     OPDEBUG_APPEND_NUMBER(responseLength);
+    if (arenaBytes > 0) {
+        b.appendNumber("arenaBytes", arenaBytes);
+    }
     if (iscommand) {
         b.append("protocol", getProtoString(networkOp));
     }
@@ -125,6 +125,9 @@ public:
     int executionTime{0};
     long long nreturned{-1};
     int responseLength{-1};
+
+    // Bytes taken from the operation's arena for temporary objects.
+    long long arenaBytes{0};
 };
 
 /**
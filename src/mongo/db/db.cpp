@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <boost/optional.hpp>
 #include <fstream>
@@ -197,7 +198,7 @@ public:
                     MsgData::View header = dbresponse.response.header();
                     QueryResult::View qr = header.view2ptr();
                     long long cursorid = qr.getCursorId();
-                    if (cursorid) {
+                    if (cursorid || !dbresponse.exhaustCommand.isEmpty()) {
                         verify(dbresponse.exhaustNS.size() && dbresponse.exhaustNS[0]);
                         string ns = dbresponse.exhaustNS;  // before reset() free's it...
                         m.reset();
@@ -205,11 +206,22 @@ public:
                         b.appendNum((int)0 /*size set later*/);
                         b.appendNum(header.getId());
                         b.appendNum(header.getResponseToMsgId());
-                        b.appendNum((int)dbGetMore);
-                        b.appendNum((int)0);
-                        b.appendStr(ns);
-                        b.appendNum((int)0);  // ntoreturn
-                        b.appendNum(cursorid);
+                        if (dbresponse.exhaustCommand.isEmpty()) {
+                            b.appendNum((int)dbGetMore);
+                            b.appendNum((int)0);
+                            b.appendStr(ns);
+                            b.appendNum((int)0);  // ntoreturn
+                            b.appendNum(cursorid);
+                        } else {
+                            // The getMore command is sent as an exhaust OP_QUERY, so that its
+                            // reply in turn schedules the next batch.
+                            b.appendNum((int)dbQuery);
+                            b.appendNum((int)QueryOption_Exhaust);
+                            b.appendStr(ns);
+                            b.appendNum((int)0);   // ntoskip
+                            b.appendNum((int)-1);  // ntoreturn
+                            dbresponse.exhaustCommand.appendSelfToBufBuilder(b);
+                        }
 
                         MsgData::View header = b.buf();
                         header.setLen(b.len());
@@ -737,7 +749,7 @@ static void _initAndListen(int listenPort) {
         }
 
         if (!storageGlobalParams.readOnly) {
-            getDeleter()->startWorkers();
+            getDeleter()->startWorkers(std::max(rangeDeleterWorkers, 1));
 
             restartInProgressIndexesFromLastShutdown(startupOpCtx.get());
 
@@ -75,6 +75,7 @@
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/op_observer.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/internal_plans.h"
@@ -1420,7 +1421,7 @@ void Command::execCommand(OperationContext* txn,
                 txn, NamespaceString(sce.getns()), sce.getVersionReceived());
         }
 
-        BSONObjBuilder metadataBob;
+        BSONObjBuilder metadataBob(getOperationArena(txn));
         appendOpTimeMetadata(txn, request, &metadataBob);
 
         Command::generateErrorResponse(txn, replyBuilder, e, request, command, metadataBob.done());
@@ -1591,7 +1592,7 @@ bool Command::run(OperationContext* txn,
     appendCommandStatus(inPlaceReplyBob, result, errmsg);
     inPlaceReplyBob.doneFast();
 
-    BSONObjBuilder metadataBob;
+    BSONObjBuilder metadataBob(getOperationArena(txn));
     appendOpTimeMetadata(txn, request, &metadataBob);
     replyBuilder->setMetadata(metadataBob.done());
 
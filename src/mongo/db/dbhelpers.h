@@ -34,6 +34,7 @@
 #include "mongo/db/db.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/data_protector.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -162,20 +163,25 @@ struct Helpers {
      * keyPattern={a:1,b:1} since it can be extended to {a:100,b:minKey}, but
      * min={b:100} is not compatible).
      *
-     * Caller must hold a write lock on 'ns'
+     * Documents are deleted in batches of up to rangeDeleterBatchSize, each of which is done under
+     * a single lock acquisition and index scan. The write concern is waited for after each batch
+     * and, if specified, onBatchDeleted is then called with the number of documents and bytes
+     * removed by the batch, with no locks held.
      *
      * Returns -1 when no usable index exists
      *
      * Does oplog the individual document deletions.
      * // TODO: Refactor this mechanism, it is growing too large
      */
-    static long long removeRange(OperationContext* txn,
-                                 const KeyRange& range,
-                                 bool maxInclusive,
-                                 const WriteConcernOptions& secondaryThrottle,
-                                 RemoveSaver* callback = NULL,
-                                 bool fromMigrate = false,
-                                 bool onlyRemoveOrphanedDocs = false);
+    static long long removeRange(
+        OperationContext* txn,
+        const KeyRange& range,
+        bool maxInclusive,
+        const WriteConcernOptions& secondaryThrottle,
+        RemoveSaver* callback = NULL,
+        bool fromMigrate = false,
+        bool onlyRemoveOrphanedDocs = false,
+        const stdx::function<void(long long, long long)>& onBatchDeleted = nullptr);
 
     /**
      * Remove all documents from a collection.
@@ -315,6 +315,7 @@ struct DbResponse {
     Message response;
     int32_t responseToMsgId;
     std::string exhaustNS; /* points to ns if exhaust mode. 0=normal mode*/
+    BSONObj exhaustCommand; /* getMore command to run next if a command is being exhausted */
     DbResponse(Message r, int32_t rtId) : response(std::move(r)), responseToMsgId(rtId) {}
     DbResponse() = default;
 };
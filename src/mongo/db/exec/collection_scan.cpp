@@ -61,6 +61,7 @@ CollectionScan::CollectionScan(OperationContext* txn,
     : PlanStage(kStageType, txn),
       _workingSet(workingSet),
       _filter(filter),
+      _compiledFilter(filter ? CompiledMatchExpression::compile(filter) : nullptr),
       _params(params),
       _isDead(false),
       _wsidForFetch(_workingSet->allocate()) {
@@ -170,9 +171,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
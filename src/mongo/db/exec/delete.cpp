@@ -40,6 +40,7 @@
 #include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -81,7 +82,10 @@ DeleteStage::DeleteStage(OperationContext* txn,
       _ws(ws),
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
-      _idReturning(WorkingSet::INVALID_ID) {
+      _idReturning(WorkingSet::INVALID_ID),
+      _batchSize(params.isMulti && !params.returnDeleted && !params.isExplain
+                     ? std::max(1, internalQueryExecWriteBatchSize.load())
+                     : 1) {
     _children.emplace_back(child);
 }
 
@@ -93,7 +97,7 @@ bool DeleteStage::isEOF() {
         return true;
     }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _idsRetrying.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -102,6 +106,10 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     }
     invariant(_collection);  // If isEOF() returns false, we must have a collection.
 
+    if (_batchSize > 1) {
+        return doBatchedWork(out);
+    }
+
     // It is possible that after a delete was executed, a WriteConflictException occurred
     // and prevented us from returning ADVANCED with the old version of the document.
     if (_idReturning != WorkingSet::INVALID_ID) {
@@ -263,6 +271,130 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     return PlanStage::NEED_TIME;
 }
 
+PlanStage::StageState DeleteStage::doBatchedWork(WorkingSetID* out) {
+    invariant(_batch.empty());
+
+    // The child is worked at most '_batchSize' times per call so that a selective predicate does
+    // not keep the executor from yielding for long.
+    StageState childStatus = PlanStage::NEED_TIME;
+    WorkingSetID childId = WorkingSet::INVALID_ID;
+    size_t childWorks = 0;
+    bool needYield = false;
+    while (_batch.size() < _batchSize) {
+        WorkingSetID id;
+        if (!_idsRetrying.empty()) {
+            id = _idsRetrying.back();
+            _idsRetrying.pop_back();
+        } else if (childWorks < _batchSize) {
+            ++childWorks;
+            childStatus = child()->work(&childId);
+            if (PlanStage::NEED_TIME == childStatus) {
+                continue;
+            }
+            if (PlanStage::ADVANCED != childStatus) {
+                break;
+            }
+            id = childId;
+            childStatus = PlanStage::NEED_TIME;
+        } else {
+            break;
+        }
+
+        WorkingSetMember* member = _ws->get(id);
+        if (!member->hasRecordId()) {
+            // We expect to be here because of an invalidation causing a force-fetch.
+            ++_specificStats.nInvalidateSkips;
+            _ws->free(id);
+            continue;
+        }
+        invariant(member->hasObj());
+
+        bool docStillMatches;
+        try {
+            docStillMatches = write_stage_common::ensureStillMatches(
+                _collection, getOpCtx(), _ws, id, _params.canonicalQuery);
+        } catch (const WriteConflictException& wce) {
+            // Delete what we have so far, then yield and check this document again.
+            _idsRetrying.push_back(id);
+            needYield = true;
+            break;
+        }
+
+        if (!docStillMatches) {
+            _ws->free(id);
+            continue;
+        }
+        _batch.push_back(id);
+    }
+
+    if (!_batch.empty() && !deleteBatch()) {
+        needYield = true;
+    }
+
+    switch (childStatus) {
+        case PlanStage::FAILURE:
+        case PlanStage::DEAD:
+            *out = childId;
+            if (WorkingSet::INVALID_ID == childId) {
+                const std::string errmsg = "delete stage failed to read in results from child";
+                *out = WorkingSetCommon::allocateStatusMember(
+                    _ws, Status(ErrorCodes::InternalError, errmsg));
+            }
+            return childStatus;
+
+        case PlanStage::NEED_YIELD:
+            // Pass on the child's request, which also gives any documents to retry a new snapshot.
+            *out = childId;
+            return childStatus;
+
+        default:
+            if (needYield) {
+                *out = WorkingSet::INVALID_ID;
+                return PlanStage::NEED_YIELD;
+            }
+            return PlanStage::NEED_TIME;
+    }
+}
+
+bool DeleteStage::deleteBatch() {
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException& wce) {
+        std::terminate();
+    }
+
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (auto id : _batch) {
+            _collection->deleteDocument(
+                getOpCtx(), _ws->get(id)->recordId, _params.opDebug, _params.fromMigrate);
+        }
+        wunit.commit();
+    } catch (const WriteConflictException& wce) {
+        // None of the batch was deleted.
+        _idsRetrying.insert(_idsRetrying.end(), _batch.begin(), _batch.end());
+        _batch.clear();
+        return false;
+    }
+
+    _specificStats.docsDeleted += _batch.size();
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException& wce) {
+        // The deletes are already committed, so there is nothing to retry.
+        return false;
+    }
+    return true;
+}
+
 void DeleteStage::doRestoreState() {
     invariant(_collection);
     const NamespaceString& ns(_collection->ns());
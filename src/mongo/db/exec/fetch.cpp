@@ -58,6 +58,7 @@ FetchStage::FetchStage(OperationContext* txn,
       _collection(collection),
       _ws(ws),
       _filter(filter),
+      _compiledFilter(filter ? CompiledMatchExpression::compile(filter) : nullptr),
       _idRetrying(WorkingSet::INVALID_ID) {
     _children.emplace_back(child);
 }
@@ -201,7 +202,7 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
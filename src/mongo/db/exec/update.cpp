@@ -41,6 +41,7 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -461,6 +462,10 @@ UpdateStage::UpdateStage(OperationContext* txn,
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
       _idReturning(WorkingSet::INVALID_ID),
+      _batchSize(params.request->isMulti() && !params.request->shouldReturnAnyDocs() &&
+                         !params.request->isExplain()
+                     ? std::max(1, internalQueryExecWriteBatchSize.load())
+                     : 1),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : NULL),
       _doc(params.driver->getDocument()) {
     _children.emplace_back(child);
@@ -629,9 +634,6 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
             }
         }
 
-        invariant(oldObj.snapshotId() == getOpCtx()->recoveryUnit()->getSnapshotId());
-        wunit.commit();
-
         // If the document moved, we might see it again in a collection scan (maybe it's
         // a document after our current document).
         //
@@ -639,10 +641,16 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         // it again.  For an example, see the comment above near declaration of
         // updatedRecordIds.
         //
-        // This must be done after the wunit commits so we are sure we won't be rolling back.
+        // This must be done once the write commits so we are sure we won't be rolling back. For a
+        // batched multi-update that is when the whole batch commits, not when 'wunit' does.
         if (_updatedRecordIds && (newRecordId != recordId || driver->modsAffectIndices())) {
-            _updatedRecordIds->insert(newRecordId);
+            RecordIdSet* updatedRecordIds = _updatedRecordIds.get();
+            getOpCtx()->recoveryUnit()->onCommit(
+                [updatedRecordIds, newRecordId] { updatedRecordIds->insert(newRecordId); });
         }
+
+        invariant(oldObj.snapshotId() == getOpCtx()->recoveryUnit()->getSnapshotId());
+        wunit.commit();
     }
 
     // Only record doc modifications if they wrote (exclude no-ops). Explains get
@@ -777,6 +785,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _idsRetrying.empty() &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -831,6 +840,10 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     // updates to them. We should only get here if the collection exists.
     invariant(_collection);
 
+    if (_batchSize > 1) {
+        return doBatchedWork(out);
+    }
+
     // It is possible that after an update was applied, a WriteConflictException
     // occurred and prevented us from returning ADVANCED with the requested version
     // of the document.
@@ -1002,6 +1015,145 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState UpdateStage::doBatchedWork(WorkingSetID* out) {
+    invariant(_batch.empty());
+
+    // The child is worked at most '_batchSize' times per call so that a selective predicate does
+    // not keep the executor from yielding for long.
+    StageState childStatus = PlanStage::NEED_TIME;
+    WorkingSetID childId = WorkingSet::INVALID_ID;
+    size_t childWorks = 0;
+    bool needYield = false;
+    while (_batch.size() < _batchSize) {
+        WorkingSetID id;
+        if (!_idsRetrying.empty()) {
+            id = _idsRetrying.back();
+            _idsRetrying.pop_back();
+        } else if (childWorks < _batchSize) {
+            ++childWorks;
+            childStatus = child()->work(&childId);
+            if (PlanStage::NEED_TIME == childStatus) {
+                continue;
+            }
+            if (PlanStage::ADVANCED != childStatus) {
+                break;
+            }
+            id = childId;
+            childStatus = PlanStage::NEED_TIME;
+        } else {
+            break;
+        }
+
+        WorkingSetMember* member = _ws->get(id);
+        if (!member->hasRecordId()) {
+            // We expect to be here because of an invalidation causing a force-fetch.
+            ++_specificStats.nInvalidateSkips;
+            _ws->free(id);
+            continue;
+        }
+        invariant(member->hasObj());
+
+        if (_updatedRecordIds->count(member->recordId) > 0) {
+            // A document we have already updated. See the comment in doWork().
+            _ws->free(id);
+            continue;
+        }
+
+        bool docStillMatches;
+        try {
+            docStillMatches = write_stage_common::ensureStillMatches(
+                _collection, getOpCtx(), _ws, id, _params.canonicalQuery);
+        } catch (const WriteConflictException& wce) {
+            // Update what we have so far, then yield and check this document again.
+            _idsRetrying.push_back(id);
+            needYield = true;
+            break;
+        }
+
+        if (!docStillMatches) {
+            _ws->free(id);
+            continue;
+        }
+
+        // Ensure that the BSONObj underlying the WorkingSetMember is owned because saveState()
+        // is allowed to free the memory.
+        member->makeObjOwnedIfNeeded();
+        _batch.push_back(id);
+    }
+
+    if (!_batch.empty() && !updateBatch()) {
+        needYield = true;
+    }
+
+    switch (childStatus) {
+        case PlanStage::FAILURE:
+        case PlanStage::DEAD:
+            *out = childId;
+            if (WorkingSet::INVALID_ID == childId) {
+                const std::string errmsg = "update stage failed to read in results from child";
+                *out = WorkingSetCommon::allocateStatusMember(
+                    _ws, Status(ErrorCodes::InternalError, errmsg));
+                return PlanStage::FAILURE;
+            }
+            return childStatus;
+
+        case PlanStage::NEED_YIELD:
+            // Pass on the child's request, which also gives any documents to retry a new snapshot.
+            *out = childId;
+            return childStatus;
+
+        default:
+            // If the child is EOF we might still have to do an insert.
+            if (needYield) {
+                *out = WorkingSet::INVALID_ID;
+                return PlanStage::NEED_YIELD;
+            }
+            return PlanStage::NEED_TIME;
+    }
+}
+
+bool UpdateStage::updateBatch() {
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException& wce) {
+        std::terminate();
+    }
+
+    const UpdateStats statsBeforeBatch = _specificStats;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (auto id : _batch) {
+            WorkingSetMember* member = _ws->get(id);
+            RecordId recordId = member->recordId;
+            transformAndUpdate(member->obj, recordId);
+            ++_specificStats.nMatched;
+        }
+        wunit.commit();
+    } catch (const WriteConflictException& wce) {
+        // None of the batch was updated.
+        _specificStats = statsBeforeBatch;
+        _idsRetrying.insert(_idsRetrying.end(), _batch.begin(), _batch.end());
+        _batch.clear();
+        return false;
+    }
+
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException& wce) {
+        // The updates are already committed, so there is nothing to retry.
+        return false;
+    }
+    return true;
+}
+
 Status UpdateStage::restoreUpdateState() {
     const UpdateRequest& request = *_params.request;
     const NamespaceString& nsString(request.getNamespaceString());
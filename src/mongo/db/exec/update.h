@@ -181,6 +181,20 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Used instead of the rest of work() for multi-updates which write in batches. Gathers up to
+     * '_batchSize' matching documents from the retry list and the child, then updates them in a
+     * single WriteUnitOfWork.
+     */
+    StageState doBatchedWork(WorkingSetID* out);
+
+    /**
+     * Updates every document in '_batch' in one WriteUnitOfWork, saving and restoring the child
+     * around the write. Returns false if the caller must yield, either because the batch hit a
+     * write conflict and was moved to '_idsRetrying', or because restoring the child did.
+     */
+    bool updateBatch();
+
     UpdateStageParams _params;
 
     // Not owned by us.
@@ -195,6 +209,17 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The number of documents updated per WriteUnitOfWork. Only multi-updates which neither return
+    // documents nor are being explained use a size greater than one.
+    const size_t _batchSize;
+
+    // The documents to update in the current batch. Always empty between calls to work().
+    std::vector<WorkingSetID> _batch;
+
+    // Documents whose batch hit a write conflict. They are checked and updated again before we
+    // ask our child for anything else.
+    std::vector<WorkingSetID> _idsRetrying;
+
     // Stats
     UpdateStats _specificStats;
 
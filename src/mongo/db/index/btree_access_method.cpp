@@ -33,6 +33,7 @@
 #include "mongo/base/status.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/operation_arena.h"
 
 namespace mongo {
 
@@ -68,4 +69,11 @@ void BtreeAccessMethod::getKeys(const BSONObj& obj,
     _keyGenerator->getKeys(obj, keys, multikeyPaths);
 }
 
+void BtreeAccessMethod::getKeysInOperationArena(OperationContext* txn,
+                                                const BSONObj& obj,
+                                                BSONObjSet* keys,
+                                                MultikeyPaths* multikeyPaths) const {
+    _keyGenerator->getKeys(obj, keys, multikeyPaths, getOperationArena(txn));
+}
+
 }  // namespace mongo
@@ -50,6 +50,11 @@ public:
 private:
     void getKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const final;
 
+    void getKeysInOperationArena(OperationContext* txn,
+                                 const BSONObj& obj,
+                                 BSONObjSet* keys,
+                                 MultikeyPaths* multikeyPaths) const final;
+
     // Our keys differ for V0 and V1.
     std::unique_ptr<BtreeKeyGenerator> _keyGenerator;
 };
@@ -52,6 +52,14 @@ const BSONElement nullElt = nullObj.firstElement();
 const BSONObj undefinedObj = BSON("" << BSONUndefined);
 const BSONElement undefinedElt = undefinedObj.firstElement();
 
+/**
+ * Returns the key built by 'b'. A key built in an arena is left there, while one built on the heap
+ * is returned owned.
+ */
+BSONObj finishKey(BSONObjBuilder* b, Arena* arena) {
+    return arena ? b->done() : b->obj();
+}
+
 }  // namespace
 
 BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
@@ -69,10 +77,11 @@ BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
 
 void BtreeKeyGenerator::getKeys(const BSONObj& obj,
                                 BSONObjSet* keys,
-                                MultikeyPaths* multikeyPaths) const {
+                                MultikeyPaths* multikeyPaths,
+                                Arena* arena) const {
     // '_fieldNames' and '_fixed' are passed by value so that they can be mutated as part of the
     // getKeys call.  :|
-    getKeysImpl(_fieldNames, _fixed, obj, keys, multikeyPaths);
+    getKeysImpl(_fieldNames, _fixed, obj, keys, multikeyPaths, arena);
     if (keys->empty() && !_isSparse) {
         keys->insert(_nullKey);
     }
@@ -93,7 +102,8 @@ void BtreeKeyGeneratorV0::getKeysImpl(std::vector<const char*> fieldNames,
                                       std::vector<BSONElement> fixed,
                                       const BSONObj& obj,
                                       BSONObjSet* keys,
-                                      MultikeyPaths* multikeyPaths) const {
+                                      MultikeyPaths* multikeyPaths,
+                                      Arena* arena) const {
     if (_isIdIndex) {
         // we special case for speed
         BSONElement e = obj["_id"];
@@ -193,7 +203,7 @@ void BtreeKeyGeneratorV0::getKeysImpl(std::vector<const char*> fieldNames,
             while (i.more()) {
                 BSONElement e = i.next();
                 if (e.type() == Object) {
-                    getKeysImpl(fieldNames, fixed, e.embeddedObject(), keys, multikeyPaths);
+                    getKeysImpl(fieldNames, fixed, e.embeddedObject(), keys, multikeyPaths, arena);
                 }
             }
         } else {
@@ -274,7 +284,8 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNam
                                               const std::set<size_t>& arrIdxs,
                                               bool mayExpandArrayUnembedded,
                                               const std::vector<PositionalPathInfo>& positionalInfo,
-                                              MultikeyPaths* multikeyPaths) const {
+                                              MultikeyPaths* multikeyPaths,
+                                              Arena* arena) const {
     // Set up any terminal array values.
     for (const auto idx : arrIdxs) {
         if (*(*fieldNames)[idx] == '\0') {
@@ -289,23 +300,25 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNam
                          keys,
                          numNotFound,
                          positionalInfo,
-                         multikeyPaths);
+                         multikeyPaths,
+                         arena);
 }
 
 void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
                                       std::vector<BSONElement> fixed,
                                       const BSONObj& obj,
                                       BSONObjSet* keys,
-                                      MultikeyPaths* multikeyPaths) const {
+                                      MultikeyPaths* multikeyPaths,
+                                      Arena* arena) const {
     if (_isIdIndex) {
         // we special case for speed
         BSONElement e = obj["_id"];
         if (e.eoo()) {
             keys->insert(_nullKey);
         } else {
-            BSONObjBuilder b;
+            BSONObjBuilder b(arena);
             CollationIndexKey::collationAwareIndexKeyAppend(e, _collator, &b);
-            keys->insert(b.obj());
+            keys->insert(finishKey(&b, arena));
         }
 
         // The {_id: 1} index can never be multikey because the _id field isn't allowed to be an
@@ -320,7 +333,8 @@ void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
         invariant(multikeyPaths->empty());
         multikeyPaths->resize(fieldNames.size());
     }
-    getKeysImplWithArray(fieldNames, fixed, obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+    getKeysImplWithArray(
+        fieldNames, fixed, obj, keys, 0, _emptyPositionalInfo, multikeyPaths, arena);
 }
 
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
@@ -330,7 +344,8 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
     BSONObjSet* keys,
     unsigned numNotFound,
     const std::vector<PositionalPathInfo>& positionalInfo,
-    MultikeyPaths* multikeyPaths) const {
+    MultikeyPaths* multikeyPaths,
+    Arena* arena) const {
     BSONElement arrElt;
 
     // A set containing the position of any indexed fields in the key pattern that traverse through
@@ -399,11 +414,11 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         if (_isSparse && numNotFound == fieldNames.size()) {
             return;
         }
-        BSONObjBuilder b(_sizeTracker);
+        BSONObjBuilder b(arena, _sizeTracker);
         for (std::vector<BSONElement>::iterator i = fixed.begin(); i != fixed.end(); ++i) {
             CollationIndexKey::collationAwareIndexKeyAppend(*i, _collator, &b);
         }
-        keys->insert(b.obj());
+        keys->insert(finishKey(&b, arena));
     } else if (arrElt.embeddedObject().firstElement().eoo()) {
         // Empty array, so set matching fields to undefined.
         _getKeysArrEltFixed(&fieldNames,
@@ -415,7 +430,8 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
                             arrIdxs,
                             true,
                             _emptyPositionalInfo,
-                            multikeyPaths);
+                            multikeyPaths,
+                            arena);
     } else {
         BSONObj arrObj = arrElt.embeddedObject();
 
@@ -498,7 +514,8 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
                                 arrIdxs,
                                 mayExpandArrayUnembedded,
                                 subPositionalInfo,
-                                multikeyPaths);
+                                multikeyPaths,
+                                arena);
             ++nArrObjFields;
         }
 
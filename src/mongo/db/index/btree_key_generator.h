@@ -36,6 +36,7 @@
 
 namespace mongo {
 
+class Arena;
 class CollatorInterface;
 
 /**
@@ -50,7 +51,16 @@ public:
 
     virtual ~BtreeKeyGenerator() {}
 
-    void getKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const;
+    /**
+     * Generates the index keys for the document 'obj' and stores them in the set 'keys'.
+     *
+     * If 'arena' is non-null, the keys may be built in it instead of on the heap, in which case
+     * they are only valid until the arena's current scope ends.
+     */
+    void getKeys(const BSONObj& obj,
+                 BSONObjSet* keys,
+                 MultikeyPaths* multikeyPaths,
+                 Arena* arena = nullptr) const;
 
     static const int ParallelArraysCode;
 
@@ -67,7 +77,8 @@ private:
                              std::vector<BSONElement> fixed,
                              const BSONObj& obj,
                              BSONObjSet* keys,
-                             MultikeyPaths* multikeyPaths) const = 0;
+                             MultikeyPaths* multikeyPaths,
+                             Arena* arena) const = 0;
 
     std::vector<BSONElement> _fixed;
 };
@@ -86,13 +97,15 @@ private:
      *
      * It isn't possible to create a v0 index, so it's unnecessary to track the prefixes of the
      * indexed fields that cause the index to be mulitkey. This function therefore ignores its
-     * 'multikeyPaths' parameter.
+     * 'multikeyPaths' parameter. For the same reason, it always builds the keys on the heap and
+     * ignores its 'arena' parameter.
      */
     void getKeysImpl(std::vector<const char*> fieldNames,
                      std::vector<BSONElement> fixed,
                      const BSONObj& obj,
                      BSONObjSet* keys,
-                     MultikeyPaths* multikeyPaths) const final;
+                     MultikeyPaths* multikeyPaths,
+                     Arena* arena) const final;
 };
 
 class BtreeKeyGeneratorV1 : public BtreeKeyGenerator {
@@ -172,12 +185,15 @@ private:
      * 'multikeyPaths' to have the same number of elements as the index key pattern and fills each
      * element with the prefixes of the indexed field that would cause this index to be multikey as
      * a result of inserting 'keys'.
+     *
+     * If 'arena' is non-null, the keys are built in it rather than on the heap.
      */
     void getKeysImpl(std::vector<const char*> fieldNames,
                      std::vector<BSONElement> fixed,
                      const BSONObj& obj,
                      BSONObjSet* keys,
-                     MultikeyPaths* multikeyPaths) const final;
+                     MultikeyPaths* multikeyPaths,
+                     Arena* arena) const final;
 
     /**
      * This recursive method does the heavy-lifting for getKeysImpl().
@@ -188,7 +204,8 @@ private:
                               BSONObjSet* keys,
                               unsigned numNotFound,
                               const std::vector<PositionalPathInfo>& positionalInfo,
-                              MultikeyPaths* multikeyPaths) const;
+                              MultikeyPaths* multikeyPaths,
+                              Arena* arena) const;
     /**
      * A call to getKeysImplWithArray() begins by calling this for each field in the key
      * pattern. It uses extractAllElementsAlongPath() to traverse the path '*field' in 'obj'.
@@ -240,7 +257,8 @@ private:
                              const std::set<size_t>& arrIdxs,
                              bool mayExpandArrayUnembedded,
                              const std::vector<PositionalPathInfo>& positionalInfo,
-                             MultikeyPaths* multikeyPaths) const;
+                             MultikeyPaths* multikeyPaths,
+                             Arena* arena) const;
 
     const std::vector<PositionalPathInfo> _emptyPositionalInfo;
 
@@ -37,6 +37,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/arena.h"
 #include "mongo/util/log.h"
 
 using namespace mongo;
@@ -1092,4 +1093,25 @@ TEST(BtreeKeyGeneratorTest, GetCollationAwareKeysFromNestedArray) {
         testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths, false, &collator));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysInArenaMatchesHeapKeys) {
+    BSONObj genKeysFrom = fromjson("{a: [1, 2], b: 'foo'}");
+    BtreeKeyGeneratorV1 keyGen({"a", "b"}, {BSONElement(), BSONElement()}, false, nullptr);
+
+    BSONObjSet heapKeys;
+    MultikeyPaths heapMultikeyPaths;
+    keyGen.getKeys(genKeysFrom, &heapKeys, &heapMultikeyPaths);
+
+    Arena arena;
+    BSONObjSet arenaKeys;
+    MultikeyPaths arenaMultikeyPaths;
+    keyGen.getKeys(genKeysFrom, &arenaKeys, &arenaMultikeyPaths, &arena);
+
+    ASSERT(heapKeys == arenaKeys);
+    ASSERT(heapMultikeyPaths == arenaMultikeyPaths);
+    ASSERT_GREATER_THAN(arena.bytesAllocated(), 0U);
+    for (const auto& key : arenaKeys) {
+        ASSERT_FALSE(key.isOwned());
+    }
+}
+
 }  // namespace
@@ -42,10 +42,13 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/util/arena.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
 
@@ -115,6 +118,13 @@ bool IndexAccessMethod::ignoreKeyTooLong(OperationContext* txn) {
     return !canAcceptWritesForNs || !failIndexKeyTooLong;
 }
 
+void IndexAccessMethod::getKeysInOperationArena(OperationContext* txn,
+                                                const BSONObj& obj,
+                                                BSONObjSet* keys,
+                                                MultikeyPaths* multikeyPaths) const {
+    getKeys(obj, keys, multikeyPaths);
+}
+
 // Find the keys for obj, put them in the tree pointing to loc
 Status IndexAccessMethod::insert(OperationContext* txn,
                                  const BSONObj& obj,
@@ -123,10 +133,13 @@ Status IndexAccessMethod::insert(OperationContext* txn,
                                  int64_t* numInserted) {
     invariant(numInserted);
     *numInserted = 0;
+
+    // The keys are copied by the storage engine, so they are only needed until this returns.
+    Arena::Scope arenaScope(getOperationArena(txn));
     BSONObjSet keys;
     MultikeyPaths multikeyPaths;
     // Delegate to the subclass.
-    getKeys(obj, &keys, &multikeyPaths);
+    getKeysInOperationArena(txn, obj, &keys, &multikeyPaths);
 
     Status ret = Status::OK();
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
@@ -169,6 +182,94 @@ Status IndexAccessMethod::insert(OperationContext* txn,
     return ret;
 }
 
+Status IndexAccessMethod::insertBatch(OperationContext* txn,
+                                      const std::vector<BsonRecord>& bsonRecords,
+                                      const InsertDeleteOptions& options,
+                                      int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+
+    typedef BtreeExternalSortComparison::Data KeyAndLoc;
+    std::vector<KeyAndLoc> keysToInsert;
+    std::vector<size_t> docForKey;
+    std::vector<MultikeyPaths> multikeyPaths(bsonRecords.size());
+    keysToInsert.reserve(bsonRecords.size());
+    docForKey.reserve(bsonRecords.size());
+
+    // The keys are copied by the storage engine, so they are only needed until this returns.
+    Arena::Scope arenaScope(getOperationArena(txn));
+
+    for (size_t doc = 0; doc < bsonRecords.size(); ++doc) {
+        invariant(bsonRecords[doc].id != RecordId());
+
+        BSONObjSet keys;
+        // Delegate to the subclass.
+        getKeysInOperationArena(txn, *bsonRecords[doc].docPtr, &keys, &multikeyPaths[doc]);
+
+        for (const auto& key : keys) {
+            keysToInsert.push_back(KeyAndLoc(key, bsonRecords[doc].id));
+            docForKey.push_back(doc);
+        }
+    }
+
+    // Sort positions into 'keysToInsert' rather than the keys themselves, so that each key can
+    // still be attributed to the document it came from.
+    BtreeExternalSortComparison comparator(_descriptor->keyPattern(), _descriptor->version());
+    std::vector<size_t> order(keysToInsert.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+        return comparator(keysToInsert[l], keysToInsert[r]) < 0;
+    });
+
+    std::vector<int64_t> insertedForDoc(bsonRecords.size(), 0);
+    for (auto i = order.begin(); i != order.end(); ++i) {
+        const KeyAndLoc& keyAndLoc = keysToInsert[*i];
+        Status status =
+            _newInterface->insert(txn, keyAndLoc.first, keyAndLoc.second, options.dupsAllowed);
+
+        // Everything's OK, carry on.
+        if (status.isOK()) {
+            ++insertedForDoc[docForKey[*i]];
+            continue;
+        }
+
+        // Error cases.
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(txn)) {
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue) {
+            // A document might be indexed multiple times during a background index build
+            // if it moves ahead of the collection scan cursor (e.g. via an update).
+            if (!_btreeState->isReady(txn)) {
+                LOG(3) << "key " << keyAndLoc.first
+                       << " already in index during background indexing (ok)";
+                continue;
+            }
+        }
+
+        // Clean up after ourselves.
+        for (auto j = order.begin(); j != i; ++j) {
+            removeOneKey(txn, keysToInsert[*j].first, keysToInsert[*j].second, options.dupsAllowed);
+        }
+
+        return status;
+    }
+
+    // As in insert(), a document makes the index multikey only once its keys are all in.
+    for (size_t doc = 0; doc < bsonRecords.size(); ++doc) {
+        *numInserted += insertedForDoc[doc];
+        if (insertedForDoc[doc] > 1 || isMultikeyFromPaths(multikeyPaths[doc])) {
+            _btreeState->setMultikey(txn, multikeyPaths[doc]);
+        }
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* txn,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -201,12 +302,15 @@ Status IndexAccessMethod::remove(OperationContext* txn,
                                  int64_t* numDeleted) {
     invariant(numDeleted);
     *numDeleted = 0;
+
+    // The keys are only needed until they have been removed.
+    Arena::Scope arenaScope(getOperationArena(txn));
     BSONObjSet keys;
     // There's no need to compute the prefixes of the indexed fields that cause the index to be
     // multikey when removing a document since the index metadata isn't updated when keys are
     // deleted.
     MultikeyPaths* multikeyPaths = nullptr;
-    getKeys(obj, &keys, multikeyPaths);
+    getKeysInOperationArena(txn, obj, &keys, multikeyPaths);
 
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
         removeOneKey(txn, *i, loc, options.dupsAllowed);
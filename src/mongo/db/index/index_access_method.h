@@ -44,6 +44,7 @@ namespace mongo {
 extern std::atomic<bool> failIndexKeyTooLong;  // NOLINT
 
 class BSONObjBuilder;
+struct BsonRecord;
 class MatchExpression;
 class UpdateTicket;
 struct InsertDeleteOptions;
@@ -83,6 +84,18 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Analogous to above, but for a batch of documents. The keys for all of the documents are
+     * generated up front and inserted into the index in index key order, so that consecutive
+     * inserts land next to each other in the underlying tree instead of jumping around it.
+     * 'numInserted' will be set to the number of keys added to the index for the whole batch. If
+     * any key fails to be inserted, none of the keys for the batch will be.
+     */
+    Status insertBatch(OperationContext* txn,
+                       const std::vector<BsonRecord>& bsonRecords,
+                       const InsertDeleteOptions& options,
+                       int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -278,6 +291,16 @@ protected:
     // Determines whether it's OK to ignore ErrorCodes::KeyTooLong for this OperationContext
     bool ignoreKeyTooLong(OperationContext* txn);
 
+    /**
+     * Like getKeys(), but the keys may be built in the operation's arena rather than on the heap,
+     * in which case they are only valid until the arena's current scope ends. By default, the keys
+     * are built on the heap.
+     */
+    virtual void getKeysInOperationArena(OperationContext* txn,
+                                         const BSONObj& obj,
+                                         BSONObjSet* keys,
+                                         MultikeyPaths* multikeyPaths) const;
+
     IndexCatalogEntry* _btreeState;  // owned by IndexCatalogEntry
     const IndexDescriptor* _descriptor;
 
@@ -62,10 +62,12 @@
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/op_observer.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/getmore_request.h"
 #include "mongo/db/run_commands.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
@@ -212,6 +214,7 @@ void receivedCommand(OperationContext* txn,
     CurOp* op = CurOp::get(txn);
 
     rpc::LegacyReplyBuilder builder{};
+    BSONObj commandArgs;
 
     try {
         // This will throw if the request is on an invalid namespace.
@@ -219,7 +222,8 @@ void receivedCommand(OperationContext* txn,
         // Auth checking for Commands happens later.
         int nToReturn = queryMessage.ntoreturn;
 
-        beginCommandOp(txn, nss, request.getCommandArgs());
+        commandArgs = request.getCommandArgs();
+        beginCommandOp(txn, nss, commandArgs);
 
         {
             stdx::lock_guard<Client> lk(*txn->getClient());
@@ -242,6 +246,19 @@ void receivedCommand(OperationContext* txn,
 
     op->debug().responseLength = response.header().dataLen();
 
+    // A find or getMore run with the exhaust flag keeps streaming batches of its cursor: the
+    // message handler runs this getMore as soon as the reply has been sent. The reply is flagged
+    // so that the client knows to wait for the next one rather than send a getMore itself.
+    if (queryMessage.queryOptions & QueryOption_Exhaust) {
+        QueryResult::View qr = response.header().view2ptr();
+        auto getMore = GetMoreRequest::makeExhaustGetMore(commandArgs, BSONObj(qr.data()));
+        if (getMore) {
+            qr.setResultFlags(qr.getResultFlags() | ResultFlag_MoreToCome);
+            dbResponse.exhaustNS = nss.ns();
+            dbResponse.exhaustCommand = getMore->toBSON();
+        }
+    }
+
     dbResponse.response = std::move(response);
     dbResponse.responseToMsgId = responseToMsgId;
 }
@@ -318,14 +335,14 @@ void receivedPseudoCommand(OperationContext* txn,
     // reject the request if the client is not authorized.
     NamespaceString interposedNss("admin", "$cmd");
 
-    BSONObjBuilder cmdBob;
+    BSONObjBuilder cmdBob(getOperationArena(txn));
     cmdBob.append(realCommandName, 1);
     cmdBob.appendElements(cmdParams);
     auto cmd = cmdBob.done();
 
     // TODO: use OP_COMMAND here instead of constructing
     // a legacy OP_QUERY style command
-    BufBuilder cmdMsgBuf;
+    BufBuilder cmdMsgBuf(getOperationArena(txn));
 
     int32_t flags = DataView(message.header().data()).read<LittleEndian<int32_t>>();
     cmdMsgBuf.appendNum(flags);
@@ -685,6 +702,7 @@ void assembleResponse(OperationContext* txn,
     currentOp.ensureStarted();
     currentOp.done();
     debug.executionTime = currentOp.totalTimeMillis();
+    debug.arenaBytes = getOperationArena(txn)->bytesAllocated();
 
     logThreshold += currentOp.getExpectedLatencyMs();
     Top::get(txn->getServiceContext())
@@ -41,6 +41,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -81,10 +82,9 @@ void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSessi
 
 
 void profile(OperationContext* txn, NetworkOp op) {
-    // Initialize with 1kb at start in order to avoid realloc later
-    BufBuilder profileBufBuilder(1024);
-
-    BSONObjBuilder b(profileBufBuilder);
+    // Initialize with 1kb at start in order to avoid realloc later. The entry is only needed until
+    // it has been inserted, so it is built in the operation's arena.
+    BSONObjBuilder b(getOperationArena(txn), 1024);
 
     {
         Locker::LockerInfo lockerInfo;
@@ -0,0 +1,259 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/match_details.h"
+#include "mongo/db/matcher/matchable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+struct CompiledMatchExpression::TrieNode {
+    TrieNode* findOrAddChild(StringData childName) {
+        for (auto&& child : children) {
+            if (child->fieldName == childName) {
+                return child.get();
+            }
+        }
+        children.push_back(stdx::make_unique<TrieNode>());
+        children.back()->fieldName = childName.toString();
+        return children.back().get();
+    }
+
+    std::string fieldName;
+    std::vector<std::unique_ptr<TrieNode>> children;
+
+    // The index of this node in '_paths', once flattened.
+    size_t index = 0;
+};
+
+namespace {
+
+// Documents are matched without allocating as long as the program has at most this many paths.
+const size_t kInlinePaths = 16;
+
+/**
+ * Appends the children of 'expr' to 'out' if it is an $and, recursing into nested $ands, or
+ * 'expr' itself otherwise.
+ */
+void appendConjuncts(const MatchExpression* expr, std::vector<const MatchExpression*>* out) {
+    if (expr->matchType() != MatchExpression::AND) {
+        out->push_back(expr);
+        return;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        appendConjuncts(expr->getChild(i), out);
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* root) {
+    if (root->matchType() != MatchExpression::AND && _opCodeFor(root) == OpCode::kTree) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> conjuncts;
+    appendConjuncts(root, &conjuncts);
+
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression());
+    compiled->_isConjunction = root->matchType() == MatchExpression::AND;
+    TrieNode trie;
+    std::vector<TrieNode*> leaves;
+    for (auto&& expr : conjuncts) {
+        Instruction instruction{_opCodeFor(expr), 0, expr};
+        TrieNode* leaf = nullptr;
+        if (instruction.op != OpCode::kTree) {
+            FieldRef path;
+            path.parse(expr->path());
+            if (path.numParts() == 0) {
+                instruction.op = OpCode::kTree;
+            } else {
+                leaf = &trie;
+                for (size_t i = 0; i < path.numParts(); ++i) {
+                    leaf = leaf->findOrAddChild(path.getPart(i));
+                }
+                ++compiled->_numCompiledPredicates;
+            }
+        }
+        compiled->_program.push_back(instruction);
+        leaves.push_back(leaf);
+    }
+
+    if (compiled->_numCompiledPredicates == 0) {
+        // Matching through the tree directly is just as fast.
+        return nullptr;
+    }
+
+    compiled->_numTopLevelPaths = trie.children.size();
+    for (auto&& child : trie.children) {
+        compiled->_flatten(child.get(), kNoParent);
+    }
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        if (leaves[i]) {
+            compiled->_program[i].path = leaves[i]->index;
+        }
+    }
+    return compiled;
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc, MatchDetails* details) const {
+    boost::container::small_vector<BSONElement, kInlinePaths> elements(_paths.size());
+    _resolve(doc, 0, _numTopLevelPaths, elements.data());
+
+    // Only needed for the predicates which fall back to the tree.
+    boost::optional<BSONMatchableDocument> matchableDoc;
+
+    for (auto&& instruction : _program) {
+        bool matched = false;
+        if (instruction.op == OpCode::kTree || _reachesArray(instruction.path, elements.data())) {
+            if (!matchableDoc) {
+                matchableDoc.emplace(doc);
+            }
+            matched = instruction.expr->matches(matchableDoc.get_ptr(), details);
+        } else {
+            const BSONElement& elem = elements[instruction.path];
+
+            // The expressions are called non-virtually, as the type of each is known from its
+            // match type.
+            switch (instruction.op) {
+                case OpCode::kCompare:
+                    matched = static_cast<const ComparisonMatchExpression*>(instruction.expr)
+                                  ->ComparisonMatchExpression::matchesSingleElement(elem);
+                    break;
+                case OpCode::kExists:
+                    matched = static_cast<const ExistsMatchExpression*>(instruction.expr)
+                                  ->ExistsMatchExpression::matchesSingleElement(elem);
+                    break;
+                case OpCode::kIn:
+                    matched = static_cast<const InMatchExpression*>(instruction.expr)
+                                  ->InMatchExpression::matchesSingleElement(elem);
+                    break;
+                case OpCode::kLeaf:
+                    matched = static_cast<const LeafMatchExpression*>(instruction.expr)
+                                  ->matchesSingleElement(elem);
+                    break;
+                case OpCode::kTree:
+                    MONGO_UNREACHABLE;
+            }
+        }
+
+        if (!matched) {
+            if (details && _isConjunction) {
+                details->resetOutput();
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+CompiledMatchExpression::OpCode CompiledMatchExpression::_opCodeFor(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return OpCode::kCompare;
+        case MatchExpression::EXISTS:
+            return OpCode::kExists;
+        case MatchExpression::MATCH_IN:
+            return OpCode::kIn;
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::BITS_ALL_SET:
+        case MatchExpression::BITS_ALL_CLEAR:
+        case MatchExpression::BITS_ANY_SET:
+        case MatchExpression::BITS_ANY_CLEAR:
+            return OpCode::kLeaf;
+        default:
+            // Either not a leaf, or a leaf such as $type which does its own path traversal.
+            return OpCode::kTree;
+    }
+}
+
+void CompiledMatchExpression::_flatten(TrieNode* node, size_t parent) {
+    node->index = _paths.size();
+    _paths.push_back({node->fieldName, parent, 0, node->children.size()});
+    for (auto&& child : node->children) {
+        _flatten(child.get(), node->index);
+    }
+    _paths[node->index].subtreeEnd = _paths.size();
+}
+
+void CompiledMatchExpression::_resolve(const BSONObj& obj,
+                                       size_t begin,
+                                       size_t numChildren,
+                                       BSONElement* elements) const {
+    size_t remaining = numChildren;
+    BSONObjIterator it(obj);
+    while (remaining > 0 && it.more()) {
+        const BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+
+        size_t child = begin;
+        for (size_t i = 0; i < numChildren; ++i, child = _paths[child].subtreeEnd) {
+            const PathNode& node = _paths[child];
+
+            // As with BSONObj::getField(), only the first field with a given name is used.
+            if (!elements[child].eoo() || node.fieldName != fieldName) {
+                continue;
+            }
+
+            elements[child] = elem;
+            --remaining;
+            if (node.numChildren > 0 && elem.type() == Object) {
+                _resolve(elem.embeddedObject(), child + 1, node.numChildren, elements);
+            }
+            break;
+        }
+    }
+}
+
+bool CompiledMatchExpression::_reachesArray(size_t path, const BSONElement* elements) const {
+    for (size_t node = path; node != kNoParent; node = _paths[node].parent) {
+        if (elements[node].type() == Array) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace mongo
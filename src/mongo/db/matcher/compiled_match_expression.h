@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class MatchDetails;
+class MatchExpression;
+
+/**
+ * A flattened form of a conjunction of match predicates, which matches a document in a single
+ * pass over its fields instead of walking the document once per predicate.
+ *
+ * The paths of all of the leaf predicates are merged into a trie, so predicates that share a
+ * prefix, such as 'a.b' and 'a.c', look up 'a' only once. Each predicate then becomes one
+ * instruction of a flat program, which is run against the elements found for its path.
+ *
+ * Arrays are not handled by the compiled form. A predicate whose path reaches an array in a
+ * given document is evaluated for that document by its MatchExpression instead, as is any child
+ * of the conjunction which is not a simple leaf, such as $or or $elemMatch. Either way the
+ * result, including any MatchDetails, is the same as that of the original tree.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    /**
+     * Returns the compiled form of 'root', or nullptr if 'root' is neither an $and nor a leaf
+     * predicate. 'root' must outlive the returned object and must not be modified while it is
+     * in use.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* root);
+
+    /**
+     * Returns the same result as root->matchesBSON(doc, details).
+     */
+    bool matchesBSON(const BSONObj& doc, MatchDetails* details = nullptr) const;
+
+    /**
+     * Returns the number of predicates which are evaluated against the path trie, rather than by
+     * their MatchExpression. Exposed for testing.
+     */
+    size_t numCompiledPredicates() const {
+        return _numCompiledPredicates;
+    }
+
+private:
+    enum class OpCode {
+        // ComparisonMatchExpression: $eq, $lt, $lte, $gt and $gte.
+        kCompare,
+        kExists,
+        kIn,
+        // Any other LeafMatchExpression which matches one element at a time.
+        kLeaf,
+        // Evaluated by MatchExpression::matches() on the whole document.
+        kTree,
+    };
+
+    struct Instruction {
+        OpCode op;
+        // Index into '_paths' of the path of the predicate. Unused for kTree.
+        size_t path;
+        const MatchExpression* expr;
+    };
+
+    /**
+     * One component of a path in the trie. Nodes are stored in preorder, so the children of
+     * node 'i' are 'i + 1', then 'subtreeEnd' of that child, and so on up to the 'subtreeEnd' of
+     * node 'i'.
+     */
+    struct PathNode {
+        std::string fieldName;
+        // Index of the parent node, or kNoParent for a top-level field.
+        size_t parent;
+        size_t subtreeEnd;
+        size_t numChildren;
+    };
+
+    static const size_t kNoParent = static_cast<size_t>(-1);
+
+    /**
+     * The path trie as it is built by compile(), before it is flattened into '_paths'.
+     */
+    struct TrieNode;
+
+    CompiledMatchExpression() = default;
+
+    static OpCode _opCodeFor(const MatchExpression* expr);
+
+    /**
+     * Appends 'node' and its descendants to '_paths' in preorder.
+     */
+    void _flatten(TrieNode* node, size_t parent);
+
+    /**
+     * Finds the element of each of the 'numChildren' nodes starting at 'begin' in 'obj', and
+     * recursively those of their children, storing them in 'elements'.
+     */
+    void _resolve(const BSONObj& obj,
+                  size_t begin,
+                  size_t numChildren,
+                  BSONElement* elements) const;
+
+    /**
+     * Returns true if the element found for 'path', or for any of its ancestors, is an array.
+     */
+    bool _reachesArray(size_t path, const BSONElement* elements) const;
+
+    std::vector<PathNode> _paths;
+    size_t _numTopLevelPaths = 0;
+    size_t _numCompiledPredicates = 0;
+
+    // Like AndMatchExpression, a conjunction resets the MatchDetails output when it fails.
+    bool _isConjunction = false;
+
+    std::vector<Instruction> _program;
+};
+
+}  // namespace mongo
@@ -0,0 +1,202 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/db/matcher/match_details.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter,
+                                       const CollatorInterface* collator = nullptr) {
+    auto statusWithMatcher =
+        MatchExpressionParser::parse(filter, ExtensionsCallbackDisallowExtensions(), collator);
+    ASSERT_OK(statusWithMatcher.getStatus());
+    return std::move(statusWithMatcher.getValue());
+}
+
+/**
+ * Asserts that the compiled form of 'filter' gives the same result as the tree for each of
+ * 'docs'.
+ */
+void assertMatchesLikeTree(const BSONObj& filter,
+                           const std::vector<BSONObj>& docs,
+                           const CollatorInterface* collator = nullptr) {
+    auto expr = parse(filter, collator);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    for (auto&& doc : docs) {
+        ASSERT_EQUALS(expr->matchesBSON(doc), compiled->matchesBSON(doc))
+            << "filter: " << filter << ", document: " << doc;
+    }
+}
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: null}"),
+    fromjson("{a: 1, b: 'x'}"),
+    fromjson("{a: 2, b: 'y'}"),
+    fromjson("{a: NumberLong(1), b: 'x'}"),
+    fromjson("{a: {b: 1, c: 2}}"),
+    fromjson("{a: {b: 2, c: 3}}"),
+    fromjson("{a: {b: null}}"),
+    fromjson("{a: {b: {c: 1}}}"),
+    fromjson("{a: {c: 2}}"),
+    fromjson("{a: 5, b: {c: 2}}"),
+    fromjson("{a: [1, 2, 3]}"),
+    fromjson("{a: []}"),
+    fromjson("{a: [{b: 1, c: 2}, {b: 2, c: 3}]}"),
+    fromjson("{a: {b: [1, 2]}}"),
+    fromjson("{a: {'0': 1, b: 1}}"),
+    fromjson("{a: [[1], 2]}"),
+    fromjson("{a: 1, a: 2}"),
+    fromjson("{a: {b: 1}, a: {b: 2}}"),
+    fromjson("{b: 'x', a: {c: 2, b: 1}}"),
+    fromjson("{a: {$minKey: 1}, b: {$maxKey: 1}}"),
+    fromjson("{a: NaN}"),
+};
+
+TEST(CompiledMatchExpressionTest, DoesNotCompileDisjunction) {
+    auto expr = parse(fromjson("{$or: [{a: 1}, {b: 1}]}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+}
+
+TEST(CompiledMatchExpressionTest, DoesNotCompileConjunctionWithoutLeaves) {
+    auto expr = parse(fromjson("{$or: [{a: 1}, {b: 1}], c: {$elemMatch: {d: 1}}}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+}
+
+TEST(CompiledMatchExpressionTest, CompilesLeaf) {
+    auto expr = parse(fromjson("{'a.b': 1}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_EQUALS(1U, compiled->numCompiledPredicates());
+}
+
+TEST(CompiledMatchExpressionTest, CompilesLeavesOfNestedConjunctions) {
+    auto expr = parse(
+        fromjson("{a: 1, $and: [{b: {$gt: 1}}, {$and: [{c: {$exists: true}}]}], "
+                 "$or: [{d: 1}, {e: 1}], f: {$type: 'string'}}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_EQUALS(3U, compiled->numCompiledPredicates());
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsMatchLikeTree) {
+    assertMatchesLikeTree(fromjson("{a: 1}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: null}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$gt: 1}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$gte: 1, $lt: 3}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$lte: {$maxKey: 1}}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: NaN}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: 1, b: 'x'}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$ne: 1}, b: 'x'}"), kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, DottedPathsMatchLikeTree) {
+    assertMatchesLikeTree(fromjson("{'a.b': 1}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.b': null}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.b': 1, 'a.c': 2}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.b': {$gte: 1}, 'a.c': {$lte: 3}, b: 'x'}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.b.c': 1}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.0': 1}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.0': 1, 'a.b': 1}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'b.c': 2, a: 5}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {b: 1, c: 2}}"), kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, OtherLeavesMatchLikeTree) {
+    assertMatchesLikeTree(fromjson("{a: {$exists: true}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.b': {$exists: true}, 'a.c': {$exists: false}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$in: [1, null, 'x']}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{'a.b': {$in: [1, /^x/]}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{b: {$regex: '^x'}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$mod: [2, 0]}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$bitsAllSet: [0]}}"), kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, UncompiledChildrenMatchLikeTree) {
+    assertMatchesLikeTree(fromjson("{a: {$size: 3}, b: {$lt: 'z'}}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$elemMatch: {b: 2}}, 'a.c': 3}"), kDocs);
+    assertMatchesLikeTree(fromjson("{$or: [{a: 1}, {'a.b': 1}], b: 'x'}"), kDocs);
+    assertMatchesLikeTree(fromjson("{a: {$type: 'number'}, b: {$gt: 'w'}}"), kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, StringComparisonsRespectCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    auto expr = parse(fromjson("{b: 'z', a: {$exists: true}}"), &collator);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_TRUE(compiled->matchesBSON(fromjson("{a: 1, b: 'x'}")));
+    ASSERT_FALSE(compiled->matchesBSON(fromjson("{a: 1, b: 1}")));
+    assertMatchesLikeTree(fromjson("{b: {$in: ['z']}, a: {$gte: 1}}"), kDocs, &collator);
+}
+
+TEST(CompiledMatchExpressionTest, RecordsElemMatchKeyOfPredicateReachingArray) {
+    auto expr = parse(fromjson("{'a.b': 2, c: 1}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+
+    MatchDetails details;
+    details.requestElemMatchKey();
+    ASSERT_TRUE(compiled->matchesBSON(fromjson("{a: [{b: 1}, {b: 2}], c: 1}"), &details));
+    ASSERT_TRUE(details.hasElemMatchKey());
+    ASSERT_EQUALS("1", details.elemMatchKey());
+
+    ASSERT_FALSE(compiled->matchesBSON(fromjson("{a: [{b: 1}, {b: 2}], c: 2}"), &details));
+    ASSERT_FALSE(details.hasElemMatchKey());
+}
+
+TEST(CompiledMatchExpressionTest, MatchesDocumentWithManyPaths) {
+    BSONObjBuilder filter;
+    BSONObjBuilder doc;
+    for (int i = 0; i < 40; ++i) {
+        filter.append(std::string(str::stream() << "f" << i << ".x"), i);
+        doc.append(std::string(str::stream() << "f" << i), BSON("x" << i));
+    }
+    BSONObj docObj = doc.obj();
+    auto expr = parse(filter.obj());
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_EQUALS(40U, compiled->numCompiledPredicates());
+    ASSERT_TRUE(compiled->matchesBSON(docObj));
+    ASSERT_FALSE(compiled->matchesBSON(docObj.removeField("f39")));
+}
+
+}  // namespace
+}  // namespace mongo
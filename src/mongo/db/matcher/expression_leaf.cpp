@@ -30,6 +30,7 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <boost/functional/hash.hpp>
 #include <cmath>
 #include <pcrecpp.h>
 #include <unordered_map>
@@ -230,24 +231,6 @@ void ComparisonMatchExpression::serialize(BSONObjBuilder* out) const {
 
 // ---------------
 
-// TODO: move
-inline pcrecpp::RE_Options flags2options(const char* flags) {
-    pcrecpp::RE_Options options;
-    options.set_utf8(true);
-    while (flags && *flags) {
-        if (*flags == 'i')
-            options.set_caseless(true);
-        else if (*flags == 'm')
-            options.set_multiline(true);
-        else if (*flags == 'x')
-            options.set_extended(true);
-        else if (*flags == 's')
-            options.set_dotall(true);
-        flags++;
-    }
-    return options;
-}
-
 RegexMatchExpression::RegexMatchExpression() : LeafMatchExpression(REGEX) {}
 
 RegexMatchExpression::~RegexMatchExpression() {}
@@ -286,7 +269,7 @@ Status RegexMatchExpression::init(StringData path, StringData regex, StringData
 
     _regex = regex.toString();
     _flags = options.toString();
-    _re.reset(new pcrecpp::RE(_regex.c_str(), flags2options(_flags.c_str())));
+    _re = RegexCache::get()->getOrCompile(_regex, _flags);
 
     return setPath(path);
 }
@@ -295,11 +278,10 @@ bool RegexMatchExpression::matchesSingleElement(const BSONElement& e) const {
     switch (e.type()) {
         case String:
         case Symbol: {
-            // String values stored in documents can contain embedded NUL bytes. We construct a
-            // pcrecpp::StringPiece instance using the full length of the string to avoid truncating
-            // 'data' early.
-            pcrecpp::StringPiece data(e.valuestr(), e.valuestrsize() - 1);
-            return _re->PartialMatch(data);
+            // String values stored in documents can contain embedded NUL bytes. We use the full
+            // length of the string to avoid truncating 'data' early.
+            StringData data(e.valuestr(), e.valuestrsize() - 1);
+            return _re->partialMatch(data);
         }
         case RegEx:
             return _regex == e.regex() && _flags == e.regexFlags();
@@ -532,6 +514,61 @@ bool TypeMatchExpression::equivalent(const MatchExpression* other) const {
 
 // -----------
 
+namespace {
+
+// Below this many equalities, a few comparisons in the ordered set are cheaper than hashing.
+const size_t kMinEqualitiesForHashing = 16;
+
+}  // namespace
+
+size_t InMatchExpression::EqualityHasher::operator()(const BSONElement& elem) const {
+    if (collator && elem.canonicalType() == canonicalizeBSONType(String)) {
+        const auto comparisonKey = collator->getComparisonKey(elem.valueStringData());
+        size_t hash = 0;
+        boost::hash_combine(hash, elem.canonicalType());
+        boost::hash_combine(hash, StringData::Hasher()(comparisonKey.getKeyData()));
+        return hash;
+    }
+    return BSONElement::ValueHasher()(elem);
+}
+
+bool InMatchExpression::EqualityEq::operator()(const BSONElement& lhs,
+                                               const BSONElement& rhs) const {
+    const bool considerFieldName = false;
+    return lhs.woCompare(rhs, considerFieldName, collator) == 0;
+}
+
+bool InMatchExpression::_isHashable(const BSONElement& elem) const {
+    switch (elem.type()) {
+        case EOO:
+        case Undefined:
+            return false;
+        case Object:
+        case Array:
+        case CodeWScope:
+            // Strings nested in these compare with the collator, which ValueHasher does not know
+            // about
+            return !_collator;
+        default:
+            return true;
+    }
+}
+
+void InMatchExpression::_rebuildHashedEqualities() {
+    if (_equalitySet.size() < kMinEqualitiesForHashing) {
+        _hashedEqualities.reset();
+        return;
+    }
+
+    _hashedEqualities = stdx::make_unique<HashedEqualitySet>(
+        _equalitySet.size(), EqualityHasher{_collator}, EqualityEq{_collator});
+    for (auto&& equality : _equalitySet) {
+        if (_isHashable(equality)) {
+            _hashedEqualities->insert(equality);
+        }
+    }
+}
+
 Status InMatchExpression::init(StringData path) {
     return setPath(path);
 }
@@ -547,6 +584,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_rebuildHashedEqualities();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -559,7 +597,11 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e) const {
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (_hashedEqualities && _isHashable(e)) {
+        if (_hashedEqualities->find(e) != _hashedEqualities->end()) {
+            return true;
+        }
+    } else if (_equalitySet.find(e) != _equalitySet.end()) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -652,6 +694,7 @@ void InMatchExpression::setCollator(const CollatorInterface* collator) {
     BSONElementSet equalitiesWithNewComparator(
         _originalEqualityVector.begin(), _originalEqualityVector.end(), collator);
     _equalitySet = std::move(equalitiesWithNewComparator);
+    _rebuildHashedEqualities();
 }
 
 Status InMatchExpression::addEquality(const BSONElement& elt) {
@@ -668,8 +711,16 @@ Status InMatchExpression::addEquality(const BSONElement& elt) {
     if (elt.type() == BSONType::Array && elt.Obj().isEmpty()) {
         _hasEmptyArray = true;
     }
-    _equalitySet.insert(elt);
+    const bool inserted = _equalitySet.insert(elt).second;
     _originalEqualityVector.push_back(elt);
+
+    if (!_hashedEqualities) {
+        if (_equalitySet.size() >= kMinEqualitiesForHashing) {
+            _rebuildHashedEqualities();
+        }
+    } else if (inserted && _isHashable(elt)) {
+        _hashedEqualities->insert(elt);
+    }
     return Status::OK();
 }
 
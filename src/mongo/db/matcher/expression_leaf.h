@@ -31,16 +31,14 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/regex_cache.h"
 #include "mongo/stdx/memory.h"
 
-namespace pcrecpp {
-class RE;
-}  // namespace pcrecpp;
-
 namespace mongo {
 
 class CollatorInterface;
@@ -246,7 +244,9 @@ public:
 private:
     std::string _regex;
     std::string _flags;
-    std::unique_ptr<pcrecpp::RE> _re;
+
+    // Shared with other expressions which use the same regular expression.
+    std::shared_ptr<const CompiledRegex> _re;
 };
 
 class ModMatchExpression : public LeafMatchExpression {
@@ -357,6 +357,37 @@ public:
     }
 
 private:
+    /**
+     * Hash and equality functors for '_hashedEqualities', which compare element values the way
+     * '_equalitySet' does, using 'collator' for strings.
+     */
+    struct EqualityHasher {
+        size_t operator()(const BSONElement& elem) const;
+
+        const CollatorInterface* collator;
+    };
+
+    struct EqualityEq {
+        bool operator()(const BSONElement& lhs, const BSONElement& rhs) const;
+
+        const CollatorInterface* collator;
+    };
+
+    using HashedEqualitySet = std::unordered_set<BSONElement, EqualityHasher, EqualityEq>;
+
+    /**
+     * Returns whether equalities of the same type as 'elem' are kept in '_hashedEqualities'. Only
+     * depends on the canonical type of 'elem', since elements of different canonical types never
+     * compare equal.
+     */
+    bool _isHashable(const BSONElement& elem) const;
+
+    /**
+     * Builds '_hashedEqualities' from '_equalitySet' if there are enough equalities for hashing to
+     * pay off, or clears it otherwise.
+     */
+    void _rebuildHashedEqualities();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -374,6 +405,11 @@ private:
     // '_equalitySet' in case '_collator' changes after elements have been added.
     std::vector<BSONElement> _originalEqualityVector;
 
+    // The hashable elements of '_equalitySet', which matchesSingleElement() probes instead of the
+    // ordered set when present. Null for short lists. '_equalitySet' remains the authoritative
+    // container, since index bounds and serialization need the equalities in order.
+    std::unique_ptr<HashedEqualitySet> _hashedEqualities;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
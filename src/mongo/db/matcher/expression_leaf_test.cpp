@@ -1734,6 +1734,111 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities() == BSONElementSet({obj1.firstElement(), obj2.firstElement()}));
 }
 
+TEST(InMatchExpression, LargeListMatchesNumbersOfDifferentTypes) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 100; ++i) {
+        bab.append(i);
+    }
+    BSONArray operand = bab.arr();
+    InMatchExpression in;
+    for (auto&& elt : operand) {
+        in.addEquality(elt);
+    }
+
+    ASSERT(in.matchesSingleElement(BSON("a" << 5)["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << 5LL)["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << 5.0)["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << Decimal128(5))["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 5.5)["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 100)["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "5")["a"]));
+}
+
+TEST(InMatchExpression, LargeListMatchesNullAndMinKey) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 100; ++i) {
+        bab.append(i);
+    }
+    bab.appendNull();
+    bab.append(BSON("" << MINKEY).firstElement());
+    BSONArray operand = bab.arr();
+    InMatchExpression in;
+    for (auto&& elt : operand) {
+        in.addEquality(elt);
+    }
+
+    ASSERT(in.matchesSingleElement(BSON("a" << BSONNULL)["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << MINKEY)["a"]));
+    ASSERT(in.matchesSingleElement(BSONObj().firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << MAXKEY)["a"]));
+}
+
+TEST(InMatchExpression, LargeListStringMatchingRespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 100; ++i) {
+        bab.append(std::string(str::stream() << "string" << i));
+    }
+    BSONArray operand = bab.arr();
+    InMatchExpression in;
+    in.setCollator(&collator);
+    for (auto&& elt : operand) {
+        in.addEquality(elt);
+    }
+
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "string42")["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "string100")["a"]));
+
+    CollatorInterfaceMock collatorAlwaysEqual(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    in.setCollator(&collatorAlwaysEqual);
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "string100")["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 42)["a"]));
+}
+
+TEST(InMatchExpression, LargeListObjectMatchingRespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 100; ++i) {
+        bab.append(i);
+    }
+    bab.append(BSON("b"
+                    << "string"));
+    BSONArray operand = bab.arr();
+    InMatchExpression in;
+    in.setCollator(&collator);
+    for (auto&& elt : operand) {
+        in.addEquality(elt);
+    }
+
+    ASSERT(in.matchesSingleElement(BSON("a" << BSON("b"
+                                                    << "other"))["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a" << BSON("c"
+                                                     << "string"))["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << 42)["a"]));
+}
+
+TEST(InMatchExpression, ShallowCloneOfLargeListMatchesTheSameElements) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 100; ++i) {
+        bab.append(i);
+    }
+    BSONArray operand = bab.arr();
+    InMatchExpression in;
+    ASSERT_OK(in.init("a"));
+    for (auto&& elt : operand) {
+        in.addEquality(elt);
+    }
+
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesSingleElement(BSON("a" << 42)["a"]));
+    ASSERT(!clone->matchesSingleElement(BSON("a" << 100)["a"]));
+    ASSERT(clone->equivalent(&in));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
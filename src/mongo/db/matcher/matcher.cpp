@@ -52,12 +52,16 @@ Matcher::Matcher(const BSONObj& pattern,
             statusWithMatcher.isOK());
 
     _expression = std::move(statusWithMatcher.getValue());
+    _compiledExpression = CompiledMatchExpression::compile(_expression.get());
 }
 
 bool Matcher::matches(const BSONObj& doc, MatchDetails* details) const {
     if (!_expression)
         return true;
 
+    if (_compiledExpression)
+        return _compiledExpression->matchesBSON(doc, details);
+
     return _expression->matchesBSON(doc, details);
 }
 
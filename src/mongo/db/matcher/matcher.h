@@ -34,6 +34,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/match_details.h"
@@ -75,6 +76,9 @@ private:
     BSONObj _pattern;
 
     std::unique_ptr<MatchExpression> _expression;
+
+    // Compiled from '_expression' when it is a conjunction, otherwise null.
+    std::unique_ptr<CompiledMatchExpression> _compiledExpression;
 };
 
 }  // namespace mongo
@@ -0,0 +1,305 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/regex_cache.h"
+
+#include <cctype>
+#include <cstring>
+#include <pcrecpp.h>
+
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+pcrecpp::RE_Options flags2options(StringData flags) {
+    pcrecpp::RE_Options options;
+    options.set_utf8(true);
+    for (char flag : flags) {
+        if (flag == 'i')
+            options.set_caseless(true);
+        else if (flag == 'm')
+            options.set_multiline(true);
+        else if (flag == 'x')
+            options.set_extended(true);
+        else if (flag == 's')
+            options.set_dotall(true);
+    }
+    return options;
+}
+
+/**
+ * Returns true if 'c', following a backslash, is an escape for a class of characters, an anchor
+ * or a single character, which takes no further characters from the pattern.
+ */
+bool isSimpleEscape(char c) {
+    return std::strchr("dDwWsShHvVRbBAzZGntrfe", c) != nullptr;
+}
+
+/**
+ * Returns the offset just past a quantifier of the form {n}, {n,} or {n,m} starting at 'pos', or
+ * 'pos' if there is none there.
+ */
+size_t skipBraceQuantifier(StringData regex, size_t pos) {
+    size_t i = pos + 1;
+    const size_t minDigits = i;
+    while (i < regex.size() && std::isdigit(static_cast<unsigned char>(regex[i]))) {
+        ++i;
+    }
+    if (i == minDigits) {
+        return pos;
+    }
+    if (i < regex.size() && regex[i] == ',') {
+        ++i;
+        while (i < regex.size() && std::isdigit(static_cast<unsigned char>(regex[i]))) {
+            ++i;
+        }
+    }
+    if (i < regex.size() && regex[i] == '}') {
+        return i + 1;
+    }
+    return pos;
+}
+
+/**
+ * Returns true if 'haystack' contains 'needle'. Candidate positions are found with memchr(),
+ * which the C library vectorizes.
+ */
+bool containsLiteral(StringData haystack, StringData needle) {
+    if (needle.size() > haystack.size()) {
+        return false;
+    }
+    const char* pos = haystack.rawData();
+    const char* const last = haystack.rawData() + (haystack.size() - needle.size());
+    while (pos <= last) {
+        pos = static_cast<const char*>(std::memchr(pos, needle[0], last - pos + 1));
+        if (!pos) {
+            return false;
+        }
+        if (std::memcmp(pos + 1, needle.rawData() + 1, needle.size() - 1) == 0) {
+            return true;
+        }
+        ++pos;
+    }
+    return false;
+}
+
+}  // namespace
+
+CompiledRegex::CompiledRegex(StringData regex, StringData flags)
+    : _re(stdx::make_unique<pcrecpp::RE>(regex.toString(), flags2options(flags))),
+      _requiredLiteral(extractRequiredLiteral(regex, flags)) {}
+
+CompiledRegex::~CompiledRegex() = default;
+
+bool CompiledRegex::partialMatch(StringData str) const {
+    if (!_requiredLiteral.empty() && !containsLiteral(str, _requiredLiteral)) {
+        return false;
+    }
+    return _re->PartialMatch(pcrecpp::StringPiece(str.rawData(), str.size()));
+}
+
+std::string CompiledRegex::extractRequiredLiteral(StringData regex, StringData flags) {
+    // Case-insensitive and extended patterns match strings which differ from their literals.
+    if (flags.find('i') != std::string::npos || flags.find('x') != std::string::npos) {
+        return {};
+    }
+
+    std::string best;
+    std::string run;
+    // The offset in 'run' of its last character, which may take several bytes in UTF-8.
+    size_t lastCharStart = 0;
+    int depth = 0;
+
+    auto endRun = [&] {
+        if (run.size() > best.size()) {
+            best = run;
+        }
+        run.clear();
+    };
+    auto appendByte = [&](char c) {
+        if (depth > 0) {
+            return;
+        }
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            lastCharStart = run.size();
+        }
+        run.push_back(c);
+    };
+    auto dropLastChar = [&] {
+        if (!run.empty()) {
+            run.resize(lastCharStart);
+        }
+    };
+
+    size_t i = 0;
+    while (i < regex.size()) {
+        const char c = regex[i];
+        switch (c) {
+            case '\\': {
+                if (i + 1 == regex.size()) {
+                    return {};
+                }
+                const unsigned char escaped = regex[i + 1];
+                i += 2;
+                if (escaped >= 0x80) {
+                    return {};
+                } else if (std::isalnum(escaped)) {
+                    // Escapes such as \x41, \p{L} or \Q...\E consume more of the pattern.
+                    if (!isSimpleEscape(escaped)) {
+                        return {};
+                    }
+                    endRun();
+                } else {
+                    appendByte(escaped);
+                }
+                continue;
+            }
+            case '|':
+                if (depth == 0) {
+                    return {};
+                }
+                break;
+            case '(':
+                // Options set with (?i) apply to the rest of the enclosing group.
+                if (i + 1 < regex.size() && regex[i + 1] == '?' &&
+                    (i + 2 == regex.size() || !std::strchr(":=!<>P'", regex[i + 2]))) {
+                    return {};
+                }
+                endRun();
+                ++depth;
+                break;
+            case ')':
+                if (depth == 0) {
+                    return {};
+                }
+                --depth;
+                break;
+            case '[': {
+                endRun();
+                ++i;
+                if (i < regex.size() && regex[i] == '^') {
+                    ++i;
+                }
+                if (i < regex.size() && regex[i] == ']') {
+                    ++i;
+                }
+                while (i < regex.size() && regex[i] != ']') {
+                    if (regex[i] == '\\') {
+                        if (i + 1 < regex.size() && (regex[i + 1] == 'Q' || regex[i + 1] == 'E')) {
+                            return {};
+                        }
+                        i += 2;
+                    } else if (regex[i] == '[' && i + 1 < regex.size() &&
+                               std::strchr(":.=", regex[i + 1])) {
+                        // POSIX classes such as [:alpha:] contain a ']' of their own.
+                        return {};
+                    } else {
+                        ++i;
+                    }
+                }
+                if (i >= regex.size()) {
+                    return {};
+                }
+                break;
+            }
+            case '{': {
+                const size_t end = skipBraceQuantifier(regex, i);
+                if (end != i) {
+                    dropLastChar();
+                    endRun();
+                    i = end;
+                    continue;
+                }
+                // Otherwise the brace is a literal, which is left out.
+                endRun();
+                break;
+            }
+            case '?':
+            case '*':
+                dropLastChar();
+                endRun();
+                break;
+            case '+':
+                // The last character is still required, but may be repeated.
+                endRun();
+                break;
+            case '.':
+            case '^':
+            case '$':
+                endRun();
+                break;
+            default:
+                appendByte(c);
+                break;
+        }
+        ++i;
+    }
+    endRun();
+    return best;
+}
+
+RegexCache::RegexCache(size_t maxSize) : _cache(maxSize) {}
+
+RegexCache* RegexCache::get() {
+    // Leaked, so that it stays usable by threads which are still running at shutdown.
+    static RegexCache* cache = new RegexCache(kDefaultMaxSize);
+    return cache;
+}
+
+std::shared_ptr<const CompiledRegex> RegexCache::getOrCompile(StringData regex, StringData flags) {
+    // Patterns and flags cannot contain NUL bytes, so this key is unambiguous.
+    std::string key = regex.toString();
+    key.push_back('\0');
+    key.append(flags.rawData(), flags.size());
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        std::shared_ptr<const CompiledRegex>* cached;
+        if (_cache.get(key, &cached).isOK()) {
+            return *cached;
+        }
+    }
+
+    // Compile outside of the mutex, as it can be slow for long patterns.
+    std::shared_ptr<const CompiledRegex> compiled = std::make_shared<CompiledRegex>(regex, flags);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cache.add(key, new std::shared_ptr<const CompiledRegex>(compiled));
+    return compiled;
+}
+
+size_t RegexCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _cache.size();
+}
+
+}  // namespace mongo
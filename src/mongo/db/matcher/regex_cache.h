@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/stdx/mutex.h"
+
+namespace pcrecpp {
+class RE;
+}  // namespace pcrecpp
+
+namespace mongo {
+
+/**
+ * A regular expression compiled for matching, along with a literal substring which every string
+ * it matches contains. Strings without that substring are rejected without running PCRE.
+ *
+ * Safe to use from multiple threads at once.
+ */
+class CompiledRegex {
+    MONGO_DISALLOW_COPYING(CompiledRegex);
+
+public:
+    CompiledRegex(StringData regex, StringData flags);
+    ~CompiledRegex();
+
+    /**
+     * Returns true if the regular expression matches some part of 'str', which may contain
+     * embedded NUL bytes.
+     */
+    bool partialMatch(StringData str) const;
+
+    const std::string& requiredLiteral() const {
+        return _requiredLiteral;
+    }
+
+    /**
+     * Returns the longest run of characters which appears unmodified in every string that 'regex'
+     * matches with 'flags', or the empty string if none is found. Only the parts of the pattern
+     * outside of groups are considered, and patterns using features which the scan does not
+     * understand, such as case-insensitivity or top-level alternation, yield no literal.
+     */
+    static std::string extractRequiredLiteral(StringData regex, StringData flags);
+
+private:
+    std::unique_ptr<pcrecpp::RE> _re;
+    std::string _requiredLiteral;
+};
+
+/**
+ * A cache of compiled regular expressions, keyed by pattern and flags, which evicts the least
+ * recently used one when full. Expressions which use the same regular expression, such as those
+ * of repeated queries or clones made while planning, share one compiled copy.
+ */
+class RegexCache {
+    MONGO_DISALLOW_COPYING(RegexCache);
+
+public:
+    static const size_t kDefaultMaxSize = 1000;
+
+    explicit RegexCache(size_t maxSize);
+
+    /**
+     * Returns the cache shared by all match expressions in the process.
+     */
+    static RegexCache* get();
+
+    /**
+     * Returns the compiled form of 'regex' with 'flags', compiling it if it is not cached.
+     */
+    std::shared_ptr<const CompiledRegex> getOrCompile(StringData regex, StringData flags);
+
+    size_t size() const;
+
+private:
+    mutable stdx::mutex _mutex;
+    LRUKeyValue<std::string, std::shared_ptr<const CompiledRegex>> _cache;
+};
+
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/regex_cache.h"
+
+#include <pcrecpp.h>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::string literalOf(StringData regex, StringData flags = "") {
+    return CompiledRegex::extractRequiredLiteral(regex, flags);
+}
+
+TEST(CompiledRegexTest, ExtractsLiteralOfPlainPattern) {
+    ASSERT_EQUALS("abc", literalOf("abc"));
+    ASSERT_EQUALS("abc", literalOf("^abc$"));
+    ASSERT_EQUALS("a.b", literalOf("a\\.b"));
+    ASSERT_EQUALS("caf\xc3\xa9", literalOf("caf\xc3\xa9"));
+}
+
+TEST(CompiledRegexTest, ExtractsLongestRun) {
+    ASSERT_EQUALS("error", literalOf("^.*error.*$"));
+    ASSERT_EQUALS("timeout", literalOf("ab.timeout\\d+x"));
+    ASSERT_EQUALS("quux", literalOf("fo.bar[0-9]+quux"));
+}
+
+TEST(CompiledRegexTest, QuantifiersMakeLastCharacterOptional) {
+    ASSERT_EQUALS("abc", literalOf("abcd?"));
+    ASSERT_EQUALS("abc", literalOf("abcd*"));
+    ASSERT_EQUALS("abc", literalOf("abcd{0,2}"));
+    ASSERT_EQUALS("abcd", literalOf("abcd+e"));
+    ASSERT_EQUALS("caf", literalOf("caf\xc3\xa9?"));
+    ASSERT_EQUALS("ab", literalOf("ab\\.?c"));
+}
+
+TEST(CompiledRegexTest, IgnoresGroupsAndClasses) {
+    ASSERT_EQUALS("fix", literalOf("(abcdef)?fix"));
+    ASSERT_EQUALS("fix", literalOf("(?:abcdef|ghijkl)fix"));
+    ASSERT_EQUALS("suffix", literalOf("[abcdefgh]suffix"));
+    ASSERT_EQUALS("suffix", literalOf("[]abcdefgh]suffix"));
+    ASSERT_EQUALS("suffix", literalOf("[a\\]bcdefgh]suffix"));
+}
+
+TEST(CompiledRegexTest, ExtractsNoLiteralFromUnsupportedPatterns) {
+    ASSERT_EQUALS("", literalOf("abc", "i"));
+    ASSERT_EQUALS("", literalOf("a b c", "x"));
+    ASSERT_EQUALS("", literalOf("abc|def"));
+    ASSERT_EQUALS("", literalOf("(?i)abc"));
+    ASSERT_EQUALS("", literalOf("\\x41bc"));
+    ASSERT_EQUALS("", literalOf("\\p{L}bc"));
+    ASSERT_EQUALS("", literalOf("\\Qa.b\\E"));
+    ASSERT_EQUALS("", literalOf("[[:alpha:]]x"));
+    ASSERT_EQUALS("", literalOf("a)b"));
+    ASSERT_EQUALS("", literalOf("[abc"));
+    ASSERT_EQUALS("", literalOf(".*"));
+}
+
+TEST(CompiledRegexTest, MatchesLikePcre) {
+    const std::vector<std::string> patterns = {
+        "abc", "^abc", "abc$", "ab+c", "ab?c", "a.c", "a\\.c", "x(abc)?y", "[ab]cd", "c\\d+d",
+        "abc{2}", "abc{2,}", "a{b", "caf\xc3\xa9", "caf\xc3\xa9?x",
+    };
+    const std::vector<std::string> subjects = {
+        "", "abc", "xabcx", "ac", "abbbc", "a.c", "axc", "xy", "xabcy", "bcd", "c12d", "abcc",
+        "abccc", "a{b", "caf\xc3\xa9", "cafx", std::string("ab\0c", 4),
+    };
+
+    for (auto&& pattern : patterns) {
+        CompiledRegex compiled(pattern, "");
+        pcrecpp::RE re(pattern, pcrecpp::UTF8());
+        for (auto&& subject : subjects) {
+            ASSERT_EQUALS(re.PartialMatch(pcrecpp::StringPiece(subject.data(), subject.size())),
+                          compiled.partialMatch(subject))
+                << "pattern: " << pattern << ", subject: " << subject;
+        }
+    }
+}
+
+TEST(RegexCacheTest, ReturnsSameCompiledRegexForSamePatternAndFlags) {
+    RegexCache cache(10);
+    auto first = cache.getOrCompile("abc", "i");
+    ASSERT_EQUALS(first.get(), cache.getOrCompile("abc", "i").get());
+    ASSERT_NOT_EQUALS(first.get(), cache.getOrCompile("abc", "").get());
+    ASSERT_NOT_EQUALS(first.get(), cache.getOrCompile("abci", "").get());
+    ASSERT_EQUALS(3U, cache.size());
+}
+
+TEST(RegexCacheTest, EvictsLeastRecentlyUsed) {
+    RegexCache cache(2);
+    auto a = cache.getOrCompile("a", "");
+    auto b = cache.getOrCompile("b", "");
+    ASSERT_EQUALS(a.get(), cache.getOrCompile("a", "").get());
+    cache.getOrCompile("c", "");
+    ASSERT_EQUALS(2U, cache.size());
+
+    ASSERT_EQUALS(a.get(), cache.getOrCompile("a", "").get());
+    auto newB = cache.getOrCompile("b", "");
+    ASSERT_NOT_EQUALS(b.get(), newB.get());
+
+    // Evicted entries remain usable by their holders.
+    ASSERT_TRUE(b->partialMatch("abc"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -46,6 +46,7 @@
 #include "mongo/db/exec/update.h"
 #include "mongo/db/introspect.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/ops/delete_request.h"
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/ops/parsed_delete.h"
@@ -83,6 +84,7 @@ void finishCurOp(OperationContext* txn, CurOp* curOp) {
         curOp->done();
         int executionTimeMs = curOp->totalTimeMillis();
         curOp->debug().executionTime = executionTimeMs;
+        curOp->debug().arenaBytes = getOperationArena(txn)->bytesAllocated();
 
         recordCurOpMetrics(txn);
         Top::get(txn->getServiceContext())
@@ -241,7 +243,7 @@ static WriteResult::SingleResult createIndex(OperationContext* txn,
                           << systemIndexes.ns(),
             ns.db() == systemIndexes.db());
 
-    BSONObjBuilder cmdBuilder;
+    BSONObjBuilder cmdBuilder(getOperationArena(txn));
     cmdBuilder << "createIndexes" << ns.coll();
     cmdBuilder << "indexes" << BSON_ARRAY(spec);
     BSONObj cmd = cmdBuilder.done();
@@ -44,6 +44,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
@@ -533,11 +534,11 @@ std::string runQuery(OperationContext* txn,
         BufBuilder bb;
         bb.skip(sizeof(QueryResult::Value));
 
-        BSONObjBuilder explainBob;
+        BSONObjBuilder explainBob(getOperationArena(txn));
         Explain::explainStages(exec.get(), collection, ExplainCommon::EXEC_ALL_PLANS, &explainBob);
 
         // Add the resulting object to the return buffer.
-        BSONObj explainObj = explainBob.obj();
+        BSONObj explainObj = explainBob.done();
         bb.appendBuf((void*)explainObj.objdata(), explainObj.objsize());
 
         // Set query result fields.
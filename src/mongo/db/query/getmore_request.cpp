@@ -215,4 +215,50 @@ BSONObj GetMoreRequest::toBSON() const {
     return builder.obj();
 }
 
+bool GetMoreRequest::isExhaustCommand(const BSONObj& query) {
+    BSONObj cmdObj = query;
+    BSONElement e = cmdObj.firstElement();
+    if (e.type() == Object &&
+        (str::equals("query", e.fieldName()) || str::equals("$query", e.fieldName()))) {
+        cmdObj = e.embeddedObject();
+    }
+
+    StringData commandName = cmdObj.firstElementFieldName();
+    return commandName == "find" || commandName == kGetMoreCommandName;
+}
+
+boost::optional<GetMoreRequest> GetMoreRequest::makeExhaustGetMore(const BSONObj& cmdObj,
+                                                                   const BSONObj& reply) {
+    if (!isExhaustCommand(cmdObj)) {
+        return boost::none;
+    }
+
+    BSONElement cursorElt = reply["cursor"];
+    if (!reply["ok"].trueValue() || cursorElt.type() != BSONType::Object) {
+        return boost::none;
+    }
+
+    BSONObj cursorObj = cursorElt.embeddedObject();
+    CursorId id = cursorObj["id"].numberLong();
+    BSONElement nsElt = cursorObj["ns"];
+    if (id == 0 || nsElt.type() != BSONType::String) {
+        return boost::none;
+    }
+
+    // Every streamed batch has the size the client asked for. A find with a batchSize of 0 only
+    // opens the cursor, so its getMores fall back to the default batch size.
+    boost::optional<long long> batchSize;
+    BSONElement batchSizeElt = cmdObj[kBatchSizeField];
+    if (batchSizeElt.isNumber() && batchSizeElt.numberLong() > 0) {
+        batchSize = batchSizeElt.numberLong();
+    }
+
+    return GetMoreRequest(NamespaceString(nsElt.valueStringData()),
+                          id,
+                          batchSize,
+                          boost::none,
+                          boost::none,
+                          boost::none);
+}
+
 }  // namespace mongo
@@ -69,6 +69,22 @@ struct GetMoreRequest {
      */
     BSONObj toBSON() const;
 
+    /**
+     * Returns whether the command in 'query', which may be wrapped in a $query field, accepts the
+     * exhaust flag. Only find and getMore do, by streaming the batches of their cursor. Clients,
+     * mongod and mongos all use this check, so that a client only waits for streamed replies to
+     * commands that the server streams.
+     */
+    static bool isExhaustCommand(const BSONObj& query);
+
+    /**
+     * Given a find or getMore command 'cmdObj' that was run with the exhaust flag and its 'reply',
+     * returns the getMore which fetches the next batch of the same cursor. Returns boost::none if
+     * 'cmdObj' is some other command, or if it failed or left no cursor open.
+     */
+    static boost::optional<GetMoreRequest> makeExhaustGetMore(const BSONObj& cmdObj,
+                                                              const BSONObj& reply);
+
     static std::string parseNs(const std::string& dbname, const BSONObj& cmdObj);
 
     const NamespaceString nss;
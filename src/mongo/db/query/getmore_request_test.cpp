@@ -280,4 +280,83 @@ TEST(GetMoreRequestTest, toBSONHasMaxTimeMS) {
     ASSERT_EQ(requestObj, expectedRequest);
 }
 
+TEST(GetMoreRequestTest, makeExhaustGetMoreFromFindReply) {
+    BSONObj reply = BSON("cursor" << BSON("id" << CursorId(123) << "ns"
+                                               << "testdb.testcoll"
+                                               << "firstBatch"
+                                               << BSONArray())
+                                  << "ok"
+                                  << 1);
+    auto request = GetMoreRequest::makeExhaustGetMore(BSON("find"
+                                                           << "testcoll"
+                                                           << "batchSize"
+                                                           << 99),
+                                                      reply);
+    ASSERT(request);
+    ASSERT_EQ(request->toBSON(),
+              BSON("getMore" << CursorId(123) << "collection"
+                             << "testcoll"
+                             << "batchSize"
+                             << 99LL));
+}
+
+TEST(GetMoreRequestTest, makeExhaustGetMoreIgnoresZeroBatchSize) {
+    BSONObj reply = BSON("cursor" << BSON("id" << CursorId(123) << "ns"
+                                               << "testdb.testcoll"
+                                               << "firstBatch"
+                                               << BSONArray())
+                                  << "ok"
+                                  << 1);
+    auto request = GetMoreRequest::makeExhaustGetMore(BSON("find"
+                                                           << "testcoll"
+                                                           << "batchSize"
+                                                           << 0),
+                                                      reply);
+    ASSERT(request);
+    ASSERT_FALSE(request->batchSize);
+}
+
+TEST(GetMoreRequestTest, makeExhaustGetMoreStopsWhenCursorIsExhausted) {
+    BSONObj reply = BSON("cursor" << BSON("id" << CursorId(0) << "ns"
+                                               << "testdb.testcoll"
+                                               << "nextBatch"
+                                               << BSONArray())
+                                  << "ok"
+                                  << 1);
+    ASSERT_FALSE(GetMoreRequest::makeExhaustGetMore(BSON("getMore" << CursorId(123)
+                                                                   << "collection"
+                                                                   << "testcoll"),
+                                                    reply));
+}
+
+TEST(GetMoreRequestTest, makeExhaustGetMoreRejectsOtherCommandsAndErrors) {
+    BSONObj reply = BSON("cursor" << BSON("id" << CursorId(123) << "ns"
+                                               << "testdb.testcoll"
+                                               << "firstBatch"
+                                               << BSONArray())
+                                  << "ok"
+                                  << 1);
+    ASSERT_FALSE(GetMoreRequest::makeExhaustGetMore(BSON("aggregate"
+                                                         << "testcoll"),
+                                                    reply));
+    ASSERT_FALSE(GetMoreRequest::makeExhaustGetMore(BSON("find"
+                                                         << "testcoll"),
+                                                    BSON("ok" << 0 << "errmsg"
+                                                              << "failed")));
+}
+
+TEST(GetMoreRequestTest, isExhaustCommandOnlyAcceptsFindAndGetMore) {
+    ASSERT_TRUE(GetMoreRequest::isExhaustCommand(BSON("find"
+                                                      << "testcoll")));
+    ASSERT_TRUE(GetMoreRequest::isExhaustCommand(BSON("getMore" << CursorId(123) << "collection"
+                                                                << "testcoll")));
+    ASSERT_TRUE(GetMoreRequest::isExhaustCommand(BSON("$query" << BSON("find"
+                                                                       << "testcoll"))));
+    ASSERT_FALSE(GetMoreRequest::isExhaustCommand(BSON("aggregate"
+                                                       << "testcoll")));
+    ASSERT_FALSE(GetMoreRequest::isExhaustCommand(BSON("listIndexes"
+                                                       << "testcoll")));
+    ASSERT_FALSE(GetMoreRequest::isExhaustCommand(BSON("$query" << BSON("listCollections" << 1))));
+}
+
 }  // namespace
@@ -32,6 +32,7 @@
 
 #include "mongo/db/range_deleter.h"
 
+#include <algorithm>
 #include <boost/date_time/posix_time/posix_time_duration.hpp>
 #include <memory>
 
@@ -178,9 +179,13 @@ RangeDeleter::~RangeDeleter() {
     }
 }
 
-void RangeDeleter::startWorkers() {
-    if (!_worker) {
-        _worker.reset(new stdx::thread(stdx::bind(&RangeDeleter::doWork, this)));
+void RangeDeleter::startWorkers(size_t numWorkers) {
+    if (!_workers.empty()) {
+        return;
+    }
+
+    for (size_t i = 0; i < std::max<size_t>(numWorkers, 1); i++) {
+        _workers.emplace_back(stdx::bind(&RangeDeleter::doWork, this));
     }
 }
 
@@ -190,8 +195,8 @@ void RangeDeleter::stopWorkers() {
         _stopRequested = true;
     }
 
-    if (_worker) {
-        _worker->join();
+    for (auto& worker : _workers) {
+        worker.join();
     }
 
     stdx::unique_lock<stdx::mutex> sl(_queueMutex);
@@ -421,7 +426,8 @@ void RangeDeleter::doWork() {
 
         {
             stdx::unique_lock<stdx::mutex> sl(_queueMutex);
-            while (_taskQueue.empty()) {
+            TaskList::iterator nextTaskIt;
+            while ((nextTaskIt = nextReadyTask_inlock()) == _taskQueue.end()) {
                 _taskQueueNotEmptyCV.wait_for(
                     sl, Milliseconds(kNotEmptyTimeoutMillis).toSystemDuration());
 
@@ -430,7 +436,7 @@ void RangeDeleter::doWork() {
                     return;
                 }
 
-                if (_taskQueue.empty()) {
+                if (nextReadyTask_inlock() == _taskQueue.end()) {
                     // Try to check if some deletes are ready and move them to the
                     // ready queue.
 
@@ -471,9 +477,10 @@ void RangeDeleter::doWork() {
                 return;
             }
 
-            nextTask = _taskQueue.front();
-            _taskQueue.pop_front();
+            nextTask = *nextTaskIt;
+            _taskQueue.erase(nextTaskIt);
 
+            _nssInProgress.insert(nextTask->options.range.ns);
             _deletesInProgress++;
         }
 
@@ -504,11 +511,15 @@ void RangeDeleter::doWork() {
                               nextTask->options.range.minKey,
                               nextTask->options.range.maxKey);
             deletePtrElement(&_deleteSet, &setEntry);
+            _nssInProgress.erase(nextTask->options.range.ns);
             _deletesInProgress--;
 
             if (nextTask->doneSignal) {
                 nextTask->doneSignal->set();
             }
+
+            // Other workers may be waiting for a task of the same collection
+            _taskQueueNotEmptyCV.notify_all();
         }
 
         recordDelStats(new DeleteJobStats(nextTask->stats));
@@ -517,6 +528,12 @@ void RangeDeleter::doWork() {
     }
 }
 
+RangeDeleter::TaskList::iterator RangeDeleter::nextReadyTask_inlock() {
+    return std::find_if(_taskQueue.begin(), _taskQueue.end(), [this](RangeDeleteEntry* entry) {
+        return !_nssInProgress.count(entry->options.range.ns);
+    });
+}
+
 bool RangeDeleter::canEnqueue_inlock(StringData ns,
                                      const BSONObj& min,
                                      const BSONObj& max,
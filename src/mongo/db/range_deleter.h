@@ -61,9 +61,11 @@ struct RangeDeleterOptions;
  *
  * Threading assumptions:
  *
- *   This class has (currently) one worker thread attacking the queue, one
- *   job at a time. If we want an immediate deletion, that job is going to
- *   be performed on the thread that is requesting it.
+ *   This class has a pool of worker threads attacking the queue, each one
+ *   working on one job at a time. Queued deletes for different collections
+ *   proceed in parallel, but a collection has at most one queued delete in
+ *   progress at any time. If we want an immediate deletion, that job is
+ *   going to be performed on the thread that is requesting it.
  *
  *   All calls regarding deletion are synchronized.
  *
@@ -96,15 +98,15 @@ public:
     //
 
     /**
-     * Starts the background thread to work on this queue. Does nothing if the worker
-     * thread is already active.
+     * Starts the background threads to work on this queue. Does nothing if the worker
+     * threads are already active.
      *
      * This call is _not_ thread safe and must be issued before any other call.
      */
-    void startWorkers();
+    void startWorkers(size_t numWorkers = 1);
 
     /**
-     * Stops the background thread working on this queue. This will block if there are
+     * Stops the background threads working on this queue. This will block if there are
      * tasks that are being deleted, but will leave the pending tasks in the queue.
      *
      * Steps:
@@ -117,7 +119,7 @@ public:
      *
      * + restarting this deleter with startWorkers after stopping it is not supported.
      *
-     * + the worker thread could be running a call in the environment. The thread is
+     * + the worker threads could be running a call in the environment. A thread is
      *   only going to be returned when the environment decides so. In production,
      *   KillCurrentOp::killAll can be used to get the thread back from the environment.
      */
@@ -184,9 +186,15 @@ private:
 
     typedef std::set<NSMinMax*, NSMinMaxCmp> NSMinMaxSet;  // owned here
 
-    /** Body of the worker thread */
+    /** Body of the worker threads */
     void doWork();
 
+    /**
+     * Returns the first task of _taskQueue whose collection does not have another queued
+     * delete in progress, or _taskQueue.end() if there is none.
+     */
+    TaskList::iterator nextReadyTask_inlock();
+
     /** Returns true if the range doesn't intersect with one other range */
     bool canEnqueue_inlock(StringData ns,
                            const BSONObj& min,
@@ -199,7 +207,7 @@ private:
     std::unique_ptr<RangeDeleterEnv> _env;
 
     // Initially not active. Must be started explicitly.
-    std::unique_ptr<stdx::thread> _worker;
+    std::vector<stdx::thread> _workers;
 
     // Protects _stopRequested.
     mutable stdx::mutex _stopMutex;
@@ -238,6 +246,9 @@ private:
     // Keeps track of number of tasks that are in progress, including the inline deletes.
     size_t _deletesInProgress;
 
+    // Namespaces, which have a queued delete in progress on one of the worker threads.
+    std::set<std::string> _nssInProgress;
+
     // Protects _statsHistory
     mutable stdx::mutex _statsHistoryMutex;
     std::deque<DeleteJobStats*> _statsHistory;
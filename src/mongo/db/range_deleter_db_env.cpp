@@ -41,13 +41,81 @@
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/operation_sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 using std::string;
 
+// Upper bounds on the rate at which all range deleter workers combined remove documents. Zero
+// means unlimited.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxDocsPerSecond, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBytesPerSecond, long long, 0);
+
+namespace {
+
+const Milliseconds kMaxThrottleSleep(100);
+
+AtomicInt64 totalDeletedDocs;
+AtomicInt64 totalDeletedBytes;
+AtomicInt64 totalThrottledMillis;
+
+/**
+ * Spreads the deletes of all workers over time according to the configured rate limits. Each
+ * deleted batch reserves a slot proportional to its size; a worker whose slot starts in the
+ * future sleeps until then.
+ */
+class DeleteThrottle {
+public:
+    void onBatchDeleted(OperationContext* txn, long long numDocs, long long numBytes) {
+        totalDeletedDocs.addAndFetch(numDocs);
+        totalDeletedBytes.addAndFetch(numBytes);
+
+        const long long maxDocs = rangeDeleterMaxDocsPerSecond;
+        const long long maxBytes = rangeDeleterMaxBytesPerSecond;
+
+        long long costMillis = 0;
+        if (maxDocs > 0) {
+            costMillis = std::max(costMillis, numDocs * 1000 / maxDocs);
+        }
+        if (maxBytes > 0) {
+            costMillis = std::max(costMillis, numBytes * 1000 / maxBytes);
+        }
+
+        if (costMillis == 0) {
+            return;
+        }
+
+        Date_t wakeUp;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            const Date_t now = Date_t::now();
+            wakeUp = std::max(_nextBatchStart, now);
+            _nextBatchStart = wakeUp + Milliseconds(costMillis);
+        }
+
+        for (Date_t now = Date_t::now(); now < wakeUp; now = Date_t::now()) {
+            const Milliseconds sleepFor = std::min(kMaxThrottleSleep, wakeUp - now);
+            sleepmillis(durationCount<Milliseconds>(sleepFor));
+            totalThrottledMillis.addAndFetch(durationCount<Milliseconds>(sleepFor));
+            txn->checkForInterrupt();
+        }
+    }
+
+private:
+    stdx::mutex _mutex;
+    Date_t _nextBatchStart;
+};
+
+DeleteThrottle deleteThrottle;
+
+}  // namespace
+
 /**
  * Outline of the delete process:
  * 1. Initialize the client for this thread if there is no client. This is for the worker
@@ -94,7 +162,10 @@ bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
                                  writeConcern,
                                  removeSaverPtr,
                                  fromMigrate,
-                                 onlyRemoveOrphans);
+                                 onlyRemoveOrphans,
+                                 [txn](long long numDocs, long long numBytes) {
+                                     deleteThrottle.onBatchDeleted(txn, numDocs, numBytes);
+                                 });
 
         if (*deletedDocs < 0) {
             *errMsg = "collection or index dropped before data could be cleaned";
@@ -116,6 +187,12 @@ bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
     return true;
 }
 
+void RangeDeleterDBEnv::appendStats(BSONObjBuilder* builder) {
+    builder->append("deletedDocs", totalDeletedDocs.load());
+    builder->append("deletedBytes", totalDeletedBytes.load());
+    builder->append("throttledMillis", totalThrottledMillis.load());
+}
+
 void RangeDeleterDBEnv::getCursorIds(OperationContext* txn,
                                      StringData ns,
                                      std::set<CursorId>* openCursors) {
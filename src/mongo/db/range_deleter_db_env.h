@@ -61,5 +61,11 @@ struct RangeDeleterDBEnv : public RangeDeleterEnv {
     virtual void getCursorIds(OperationContext* txn,
                               StringData ns,
                               std::set<CursorId>* openCursors);
+
+    /**
+     * Appends the number of documents and bytes removed by all range deletes so far, and the
+     * time spent throttled by rangeDeleterMaxDocsPerSecond/rangeDeleterMaxBytesPerSecond.
+     */
+    static void appendStats(BSONObjBuilder* builder);
 };
 }
@@ -32,6 +32,12 @@
 
 namespace mongo {
 
+/**
+ * Number of worker threads started by the global RangeDeleter. Deletes on different collections
+ * run concurrently, up to this limit.
+ */
+extern int rangeDeleterWorkers;
+
 /**
  * Gets the global instance of the deleter and starts it.
  */
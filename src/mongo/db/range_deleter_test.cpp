@@ -42,6 +42,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -361,5 +362,60 @@ TEST(MixedDeletes, MultipleDeletes) {
     deleter.stopWorkers();
 }
 
+// Tests that with several workers, deletes on different collections run concurrently while
+// deletes on the same collection are still performed one at a time.
+TEST(MixedDeletes, ConcurrentDeletesOnDifferentCollections) {
+    const string ns1("test.user");
+    const string ns2("foo.bar");
+
+    RangeDeleterMockEnv* env = new RangeDeleterMockEnv();
+    RangeDeleter deleter(env);
+
+    std::unique_ptr<mongo::repl::ReplicationCoordinatorMock> mock(
+        new mongo::repl::ReplicationCoordinatorMock(replSettings));
+
+    mongo::repl::ReplicationCoordinator::set(mongo::getGlobalServiceContext(), std::move(mock));
+
+    deleter.startWorkers(2);
+
+    env->pauseDeletes();
+
+    Notification<void> doneSignal1;
+    RangeDeleterOptions deleterOption1(
+        KeyRange(ns1, BSON("x" << 10), BSON("x" << 20), BSON("x" << 1)));
+    ASSERT_TRUE(
+        deleter.queueDelete(noTxn, deleterOption1, &doneSignal1, NULL /* don't care errMsg */));
+
+    Notification<void> doneSignal2;
+    RangeDeleterOptions deleterOption2(
+        KeyRange(ns2, BSON("x" << 10), BSON("x" << 20), BSON("x" << 1)));
+    ASSERT_TRUE(
+        deleter.queueDelete(noTxn, deleterOption2, &doneSignal2, NULL /* don't care errMsg */));
+
+    // Both workers should now be blocked in the middle of a delete.
+    env->waitForNthPausedDelete(2u);
+    ASSERT_EQUALS(2U, deleter.getDeletesInProgress());
+
+    Notification<void> doneSignal3;
+    RangeDeleterOptions deleterOption3(
+        KeyRange(ns1, BSON("x" << 30), BSON("x" << 40), BSON("x" << 1)));
+    ASSERT_TRUE(
+        deleter.queueDelete(noTxn, deleterOption3, &doneSignal3, NULL /* don't care errMsg */));
+
+    // The third delete must wait for the one in progress on the same collection.
+    ASSERT_EQUALS(3U, deleter.getTotalDeletes());
+    ASSERT_EQUALS(1U, deleter.getPendingDeletes());
+    ASSERT_EQUALS(2U, deleter.getDeletesInProgress());
+
+    while (!doneSignal1 || !doneSignal2 || !doneSignal3) {
+        env->resumeOneDelete();
+        sleepmillis(10);
+    }
+
+    ASSERT_EQUALS(0U, deleter.getTotalDeletes());
+
+    deleter.stopWorkers();
+}
+
 }  // unnamed namespace
 }  // namespace mongo
@@ -0,0 +1,270 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_splitter.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/s/chunk_write_stats.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/balancer/balancer_configuration.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/shard_key_pattern.h"
+#include "mongo/s/shard_util.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitOnShard, bool, false);
+
+namespace {
+
+// Splits are not latency sensitive, so only a few of them run at a time
+const size_t kMaxSplitThreads = 4;
+
+ThreadPool::Options makeDefaultThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "ChunkSplitter";
+    options.minThreads = 0;
+    options.maxThreads = kMaxSplitThreads;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    return options;
+}
+
+/**
+ * Returns the write statistics of collection 'nss' if its metadata still contains the chunk
+ * [min, max), otherwise nullptr. Must be called with the collection locked.
+ */
+ChunkWriteStats* getWriteStatsIfChunkExists(OperationContext* txn,
+                                            const NamespaceString& nss,
+                                            const BSONObj& min,
+                                            const BSONObj& max) {
+    auto css = CollectionShardingState::get(txn, nss);
+
+    auto metadata = css->getMetadata();
+    if (!metadata) {
+        return nullptr;
+    }
+
+    ChunkType chunk;
+    if (!metadata->getNextChunk(min, &chunk) || chunk.getMin().woCompare(min) != 0 ||
+        chunk.getMax().woCompare(max) != 0) {
+        return nullptr;
+    }
+
+    return css->getWriteStats();
+}
+
+/**
+ * Returns whether the chunk [min, max) of 'collection' holds more than 'maxChunkSizeBytes' of
+ * data, estimated from its number of shard key index entries and the average object size. Stops
+ * scanning the index as soon as the answer is known. Must be called with the collection locked.
+ */
+bool chunkExceedsSize(OperationContext* txn,
+                      Collection* collection,
+                      const BSONObj& keyPattern,
+                      const BSONObj& min,
+                      const BSONObj& max,
+                      long long maxChunkSizeBytes) {
+    if (!collection) {
+        return false;
+    }
+
+    const long long avgObjSize = collection->averageObjectSize(txn);
+    if (avgObjSize <= 0) {
+        return false;
+    }
+
+    IndexDescriptor* idx =
+        collection->getIndexCatalog()->findShardKeyPrefixedIndex(txn, keyPattern, false);
+    if (!idx) {
+        return false;
+    }
+
+    KeyPattern kp(idx->keyPattern());
+    auto exec = InternalPlanner::indexScan(txn,
+                                           collection,
+                                           idx,
+                                           Helpers::toKeyFormat(kp.extendRangeBound(min, false)),
+                                           Helpers::toKeyFormat(kp.extendRangeBound(max, false)),
+                                           false,  // endKeyInclusive
+                                           PlanExecutor::YIELD_MANUAL,
+                                           InternalPlanner::FORWARD);
+
+    const long long maxNumDocs = maxChunkSizeBytes / avgObjSize;
+
+    long long numDocs = 0;
+    BSONObj key;
+    while (exec->getNext(&key, NULL) == PlanExecutor::ADVANCED) {
+        if (++numDocs > maxNumDocs) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}  // namespace
+
+ChunkSplitter::ChunkSplitter() : _threadPool(makeDefaultThreadPoolOptions()) {
+    _threadPool.startup();
+}
+
+ChunkSplitter::~ChunkSplitter() = default;
+
+void ChunkSplitter::trySplitting(const NamespaceString& nss,
+                                 const BSONObj& min,
+                                 const BSONObj& max) {
+    Status status = _threadPool.schedule(
+        [ nss, min = min.getOwned(), max = max.getOwned() ]() { _runAutosplit(nss, min, max); });
+    if (!status.isOK()) {
+        LOG(1) << "Unable to schedule autosplit of chunk [" << min << ", " << max << ") of "
+               << nss.ns() << causedBy(status);
+    }
+}
+
+void ChunkSplitter::shutDown() {
+    _threadPool.shutdown();
+    _threadPool.join();
+}
+
+void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
+                                  const BSONObj& min,
+                                  const BSONObj& max) {
+    auto txn = cc().makeOperationContext();
+
+    try {
+        // The chunk size used to trigger the split may have been stale, so pick up any change to
+        // it before choosing split points
+        const auto balancerConfig = Grid::get(txn.get())->getBalancerConfiguration();
+        Status refreshStatus = balancerConfig->refreshAndCheck(txn.get());
+        if (!refreshStatus.isOK()) {
+            warning() << "Unable to refresh balancer settings" << causedBy(refreshStatus);
+        }
+
+        const long long maxChunkSizeBytes = balancerConfig->getMaxChunkSizeBytes();
+
+        std::vector<BSONObj> splitPoints;
+        BSONObj keyPattern;
+        ChunkVersion collVersion;
+
+        {
+            AutoGetCollection autoColl(txn.get(), nss, MODE_IS);
+
+            auto writeStats = getWriteStatsIfChunkExists(txn.get(), nss, min, max);
+            if (!writeStats) {
+                LOG(1) << "Chunk [" << min << ", " << max << ") of " << nss.ns()
+                       << " changed before it could be autosplit";
+                return;
+            }
+
+            auto metadata = CollectionShardingState::get(txn.get(), nss)->getMetadata();
+            keyPattern = metadata->getKeyPattern();
+            collVersion = metadata->getCollVersion();
+
+            // Updates count the whole document as written without growing the chunk, so make sure
+            // it actually holds too much data before splitting it
+            if (!chunkExceedsSize(txn.get(),
+                                  autoColl.getCollection(),
+                                  keyPattern,
+                                  min,
+                                  max,
+                                  maxChunkSizeBytes)) {
+                LOG(1) << "Chunk [" << min << ", " << max << ") of " << nss.ns()
+                       << " is not large enough to be autosplit";
+                writeStats->splitAttemptFinished(min);
+                return;
+            }
+
+            // Aim for half-full chunks, so that the new chunks do not immediately need splitting
+            splitPoints = writeStats->selectSplitPoints(min, maxChunkSizeBytes / 2);
+            if (splitPoints.empty()) {
+                LOG(1) << "Not enough distinct shard keys written to chunk [" << min << ", " << max
+                       << ") of " << nss.ns() << " to autosplit it";
+                writeStats->splitAttemptFinished(min);
+                return;
+            }
+        }
+
+        const ShardId shardId(ShardingState::get(txn.get())->getShardName());
+        auto splitStatus = shardutil::splitChunkAtMultiplePoints(txn.get(),
+                                                                 shardId,
+                                                                 nss,
+                                                                 ShardKeyPattern(keyPattern),
+                                                                 collVersion,
+                                                                 min,
+                                                                 max,
+                                                                 splitPoints);
+        if (splitStatus.isOK()) {
+            // The split command installs the new metadata, which discards the statistics of the
+            // chunk that was split
+            log() << "autosplitted " << nss.ns() << " chunk [" << min << ", " << max << ") into "
+                  << (splitPoints.size() + 1) << " (maxChunkSizeBytes " << maxChunkSizeBytes
+                  << ")";
+            return;
+        }
+
+        warning() << "Autosplit of chunk [" << min << ", " << max << ") of " << nss.ns()
+                  << " failed" << causedBy(splitStatus.getStatus());
+    } catch (const DBException& ex) {
+        warning() << "Autosplit of chunk [" << min << ", " << max << ") of " << nss.ns()
+                  << " failed" << causedBy(ex.toStatus());
+    }
+
+    // Allow another attempt once enough data has been written to the chunk again
+    try {
+        AutoGetCollection autoColl(txn.get(), nss, MODE_IS);
+
+        auto writeStats = getWriteStatsIfChunkExists(txn.get(), nss, min, max);
+        if (writeStats) {
+            writeStats->splitAttemptFinished(min);
+        }
+    } catch (const DBException& ex) {
+        warning() << "Unable to reset the write statistics of chunk [" << min << ", " << max
+                  << ") of " << nss.ns() << causedBy(ex.toStatus());
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class BSONObj;
+class NamespaceString;
+class OperationContext;
+
+// Whether shards split their own chunks, based on the writes they receive. Should be combined with
+// --noAutoSplit on the mongos instances, so that chunks are not split from both sides.
+extern std::atomic<bool> autoSplitOnShard;  // NOLINT
+
+/**
+ * Splits the chunks of this shard, which the write statistics kept in the CollectionShardingState
+ * have designated as too large. Splits run asynchronously on a small thread pool so that they are
+ * never performed on the write path. There is only one instance of this object per shard.
+ */
+class ChunkSplitter {
+    MONGO_DISALLOW_COPYING(ChunkSplitter);
+
+public:
+    ChunkSplitter();
+    ~ChunkSplitter();
+
+    /**
+     * Schedules an attempt to split the chunk [min, max) of collection 'nss', at the split points
+     * suggested by its write statistics. Once the attempt is over, successful or not,
+     * ChunkWriteStats::splitAttemptFinished is invoked for the chunk, unless it no longer exists.
+     */
+    void trySplitting(const NamespaceString& nss, const BSONObj& min, const BSONObj& max);
+
+    /**
+     * Stops accepting new split requests and waits for the ones in progress to complete.
+     */
+    void shutDown();
+
+private:
+    /**
+     * Runs on the thread pool and performs a split requested through trySplitting.
+     */
+    static void _runAutosplit(const NamespaceString& nss, const BSONObj& min, const BSONObj& max);
+
+    // Thread pool on which the splits run
+    ThreadPool _threadPool;
+};
+
+}  // namespace mongo
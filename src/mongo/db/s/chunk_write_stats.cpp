@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_write_stats.h"
+
+#include <algorithm>
+
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+const size_t ChunkWriteStats::kMaxSampledKeys = 128;
+
+ChunkWriteStats::ChunkWriteStats()
+    : _random(static_cast<int64_t>(Date_t::now().toMillisSinceEpoch())) {}
+
+ChunkWriteStats::~ChunkWriteStats() = default;
+
+bool ChunkWriteStats::recordWrite(const BSONObj& chunkMin,
+                                  const BSONObj& chunkMax,
+                                  const BSONObj& shardKey,
+                                  long long bytes,
+                                  long long splitThreshold) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _chunks.find(chunkMin);
+    if (it == _chunks.end()) {
+        it = _chunks.emplace(chunkMin.getOwned(), ChunkStats()).first;
+        it->second.max = chunkMax.getOwned();
+    } else if (it->second.max.woCompare(chunkMax) != 0) {
+        // The chunk's bounds changed before the new metadata was installed, so start over
+        it->second = ChunkStats();
+        it->second.max = chunkMax.getOwned();
+    }
+
+    auto& stats = it->second;
+    stats.bytesWritten += bytes;
+
+    // Reservoir sampling, so that every write so far has the same chance of being in the sample
+    ++stats.numWrites;
+    if (stats.sampledKeys.size() < kMaxSampledKeys) {
+        stats.sampledKeys.push_back(shardKey.getOwned());
+    } else {
+        const long long slot = _random.nextInt64(stats.numWrites);
+        if (slot < static_cast<long long>(kMaxSampledKeys)) {
+            stats.sampledKeys[slot] = shardKey.getOwned();
+        }
+    }
+
+    if (stats.splitPending || stats.bytesWritten < splitThreshold) {
+        return false;
+    }
+
+    stats.splitPending = true;
+    return true;
+}
+
+std::vector<BSONObj> ChunkWriteStats::selectSplitPoints(const BSONObj& chunkMin,
+                                                        long long maxChunkBytes) {
+    invariant(maxChunkBytes > 0);
+
+    std::vector<BSONObj> sampledKeys;
+    long long bytesWritten;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        auto it = _chunks.find(chunkMin);
+        if (it == _chunks.end()) {
+            return {};
+        }
+
+        sampledKeys = it->second.sampledKeys;
+        bytesWritten = it->second.bytesWritten;
+    }
+
+    std::sort(sampledKeys.begin(), sampledKeys.end(), BSONObjCmp());
+
+    // Never produce more chunks than there are samples to tell them apart
+    const size_t numChunks = std::min(
+        static_cast<size_t>(std::max(bytesWritten / maxChunkBytes, 2LL)), sampledKeys.size());
+
+    std::vector<BSONObj> splitPoints;
+    for (size_t i = 1; i < numChunks; ++i) {
+        const BSONObj& key = sampledKeys[i * sampledKeys.size() / numChunks];
+        if (key.woCompare(chunkMin) <= 0) {
+            continue;
+        }
+
+        if (!splitPoints.empty() && key.woCompare(splitPoints.back()) <= 0) {
+            continue;
+        }
+
+        splitPoints.push_back(key);
+    }
+
+    return splitPoints;
+}
+
+void ChunkWriteStats::splitAttemptFinished(const BSONObj& chunkMin) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _chunks.find(chunkMin);
+    if (it == _chunks.end()) {
+        return;
+    }
+
+    it->second.bytesWritten = 0;
+    it->second.splitPending = false;
+}
+
+void ChunkWriteStats::retainChunks(const CollectionMetadata* metadata) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    if (!metadata) {
+        _chunks.clear();
+        return;
+    }
+
+    for (auto it = _chunks.begin(); it != _chunks.end();) {
+        ChunkType chunk;
+        if (metadata->getNextChunk(it->first, &chunk) && chunk.getMin().woCompare(it->first) == 0 &&
+            chunk.getMax().woCompare(it->second.max) == 0) {
+            ++it;
+        } else {
+            it = _chunks.erase(it);
+        }
+    }
+}
+
+long long ChunkWriteStats::getBytesWritten(const BSONObj& chunkMin) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _chunks.find(chunkMin);
+    return it == _chunks.end() ? 0 : it->second.bytesWritten;
+}
+
+}  // namespace mongo
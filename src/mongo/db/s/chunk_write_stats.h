@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class CollectionMetadata;
+
+/**
+ * Tracks, for each chunk of a sharded collection owned by this shard, the number of bytes written
+ * to it and a uniform sample of the shard keys of the written documents. This is what the shard
+ * uses to decide by itself when a chunk has grown enough to be split and where to split it,
+ * without having to scan the shard key index.
+ *
+ * Chunks are identified by their bounds. Statistics for a chunk are only kept for as long as a
+ * chunk with the same bounds exists in the collection's metadata, so after a split, merge or
+ * migration they start over for the resulting chunks.
+ *
+ * This class is thread-safe.
+ */
+class ChunkWriteStats {
+    MONGO_DISALLOW_COPYING(ChunkWriteStats);
+
+public:
+    // Maximum number of shard keys sampled per chunk.
+    static const size_t kMaxSampledKeys;
+
+    ChunkWriteStats();
+    ~ChunkWriteStats();
+
+    /**
+     * Records a write of 'bytes' to the document with shard key 'shardKey', which belongs to the
+     * chunk [chunkMin, chunkMax).
+     *
+     * Returns true if the bytes written to the chunk have reached 'splitThreshold', in which case
+     * the caller is expected to attempt a split and call splitAttemptFinished() once done. Returns
+     * false while that attempt is pending.
+     */
+    bool recordWrite(const BSONObj& chunkMin,
+                     const BSONObj& chunkMax,
+                     const BSONObj& shardKey,
+                     long long bytes,
+                     long long splitThreshold);
+
+    /**
+     * Chooses split points among the sampled shard keys of the chunk starting at 'chunkMin', so
+     * that each resulting chunk received about 'maxChunkBytes' of the recorded writes. The split
+     * points are in increasing order and never equal to the chunk's lower bound.
+     *
+     * Returns an empty vector if nothing is known about the chunk or its writes went to too few
+     * distinct shard keys to be split.
+     */
+    std::vector<BSONObj> selectSplitPoints(const BSONObj& chunkMin, long long maxChunkBytes);
+
+    /**
+     * Ends the split attempt started when recordWrite() returned true. If the chunk was not split,
+     * its byte count is reset so that another attempt is only made after as many bytes have been
+     * written again. Sampled keys are kept.
+     */
+    void splitAttemptFinished(const BSONObj& chunkMin);
+
+    /**
+     * Discards the statistics of all chunks that do not exist with the same bounds in
+     * 'metadata'. If 'metadata' is null, discards everything.
+     */
+    void retainChunks(const CollectionMetadata* metadata);
+
+    /**
+     * Returns the number of bytes recorded for the chunk starting at 'chunkMin'. For testing.
+     */
+    long long getBytesWritten(const BSONObj& chunkMin);
+
+private:
+    struct ChunkStats {
+        BSONObj max;
+
+        // Bytes written since the statistics for this chunk started or were last reset
+        long long bytesWritten{0};
+
+        // Number of writes considered for sampling, and the reservoir of sampled shard keys
+        long long numWrites{0};
+        std::vector<BSONObj> sampledKeys;
+
+        // Whether a split has been requested and not finished yet
+        bool splitPending{false};
+    };
+
+    using ChunkStatsMap = std::map<BSONObj, ChunkStats, BSONObjCmp>;
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    // Statistics, keyed by the chunk's min key
+    ChunkStatsMap _chunks;
+
+    // Used for the reservoir sampling of shard keys
+    PseudoRandom _random;
+};
+
+}  // namespace mongo
@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_write_stats.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const long long kSplitThreshold = 1000;
+
+TEST(ChunkWriteStats, SplitRequestedOnceThresholdReached) {
+    ChunkWriteStats stats;
+    const BSONObj min = BSON("a" << 0);
+    const BSONObj max = BSON("a" << 100);
+
+    for (int i = 0; i < 9; i++) {
+        ASSERT_FALSE(stats.recordWrite(min, max, BSON("a" << i), 100, kSplitThreshold));
+    }
+    ASSERT_EQUALS(900, stats.getBytesWritten(min));
+
+    ASSERT_TRUE(stats.recordWrite(min, max, BSON("a" << 9), 100, kSplitThreshold));
+
+    // No more split requests while the first one is pending
+    ASSERT_FALSE(stats.recordWrite(min, max, BSON("a" << 10), 100, kSplitThreshold));
+
+    stats.splitAttemptFinished(min);
+    ASSERT_EQUALS(0, stats.getBytesWritten(min));
+    ASSERT_FALSE(stats.recordWrite(min, max, BSON("a" << 11), 100, kSplitThreshold));
+}
+
+TEST(ChunkWriteStats, ChunksAreTrackedSeparately) {
+    ChunkWriteStats stats;
+
+    ASSERT_FALSE(
+        stats.recordWrite(BSON("a" << 0), BSON("a" << 10), BSON("a" << 5), 600, kSplitThreshold));
+    ASSERT_FALSE(
+        stats.recordWrite(BSON("a" << 10), BSON("a" << 20), BSON("a" << 15), 600, kSplitThreshold));
+
+    ASSERT_EQUALS(600, stats.getBytesWritten(BSON("a" << 0)));
+    ASSERT_EQUALS(600, stats.getBytesWritten(BSON("a" << 10)));
+}
+
+TEST(ChunkWriteStats, ChangedBoundsResetStatistics) {
+    ChunkWriteStats stats;
+
+    stats.recordWrite(BSON("a" << 0), BSON("a" << 100), BSON("a" << 5), 600, kSplitThreshold);
+    stats.recordWrite(BSON("a" << 0), BSON("a" << 50), BSON("a" << 5), 100, kSplitThreshold);
+
+    ASSERT_EQUALS(100, stats.getBytesWritten(BSON("a" << 0)));
+}
+
+TEST(ChunkWriteStats, SplitPointsFollowWriteDistribution) {
+    ChunkWriteStats stats;
+    const BSONObj min = BSON("a" << 0);
+    const BSONObj max = BSON("a" << 1000);
+
+    // Fewer writes than the sample size, so every key is sampled
+    for (int i = 0; i < 100; i++) {
+        stats.recordWrite(min, max, BSON("a" << i), 100, 1000 * 1000);
+    }
+
+    // 10000 bytes written with a maximum of 2500 per chunk
+    auto splitPoints = stats.selectSplitPoints(min, 2500);
+    ASSERT_EQUALS(3U, splitPoints.size());
+    ASSERT_EQUALS(BSON("a" << 25), splitPoints[0]);
+    ASSERT_EQUALS(BSON("a" << 50), splitPoints[1]);
+    ASSERT_EQUALS(BSON("a" << 75), splitPoints[2]);
+}
+
+TEST(ChunkWriteStats, SplitPointsSkipChunkMinAndDuplicates) {
+    ChunkWriteStats stats;
+    const BSONObj min = BSON("a" << 0);
+    const BSONObj max = BSON("a" << 1000);
+
+    for (int i = 0; i < 50; i++) {
+        stats.recordWrite(min, max, min, 100, 1000 * 1000);
+    }
+
+    ASSERT(stats.selectSplitPoints(min, 1000).empty());
+
+    for (int i = 0; i < 50; i++) {
+        stats.recordWrite(min, max, BSON("a" << 7), 100, 1000 * 1000);
+    }
+
+    auto splitPoints = stats.selectSplitPoints(min, 1000);
+    ASSERT_EQUALS(1U, splitPoints.size());
+    ASSERT_EQUALS(BSON("a" << 7), splitPoints[0]);
+}
+
+TEST(ChunkWriteStats, SampleSizeIsBounded) {
+    ChunkWriteStats stats;
+    const BSONObj min = BSON("a" << 0);
+    const BSONObj max = BSON("a" << 100000);
+
+    for (int i = 0; i < 10000; i++) {
+        stats.recordWrite(min, max, BSON("a" << i), 100, 1000 * 1000 * 1000);
+    }
+
+    // Asking for many more chunks than there are samples yields at most one split point per sample
+    auto splitPoints = stats.selectSplitPoints(min, 1);
+    ASSERT_LESS_THAN_OR_EQUALS(splitPoints.size(), ChunkWriteStats::kMaxSampledKeys);
+    ASSERT_GREATER_THAN(splitPoints.size(), 0U);
+
+    for (size_t i = 1; i < splitPoints.size(); i++) {
+        ASSERT_LESS_THAN(splitPoints[i - 1].woCompare(splitPoints[i]), 0);
+    }
+}
+
+TEST(ChunkWriteStats, RetainChunksDropsChangedChunks) {
+    ChunkWriteStats stats;
+
+    stats.recordWrite(BSON("a" << 0), BSON("a" << 10), BSON("a" << 5), 100, kSplitThreshold);
+    stats.recordWrite(BSON("a" << 10), BSON("a" << 20), BSON("a" << 15), 100, kSplitThreshold);
+
+    // The second chunk was split
+    auto metadata = CollectionMetadata().clonePlusChunk(
+        BSON("a" << 0), BSON("a" << 10), ChunkVersion(1, 0, OID()));
+    metadata = metadata->clonePlusChunk(
+        BSON("a" << 10), BSON("a" << 15), ChunkVersion(1, 1, OID()));
+
+    stats.retainChunks(metadata.get());
+    ASSERT_EQUALS(100, stats.getBytesWritten(BSON("a" << 0)));
+    ASSERT_EQUALS(0, stats.getBytesWritten(BSON("a" << 10)));
+
+    stats.retainChunks(nullptr);
+    ASSERT_EQUALS(0, stats.getBytesWritten(BSON("a" << 0)));
+}
+
+}  // namespace
+}  // namespace mongo
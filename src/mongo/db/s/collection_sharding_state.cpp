@@ -36,6 +36,7 @@
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_source_manager.h"
@@ -44,7 +45,11 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/type_shard_identity.h"
 #include "mongo/db/server_options.h"
+#include "mongo/s/balancer/balancer_configuration.h"
+#include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk_version.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/s/stale_exception.h"
 
 namespace mongo {
@@ -104,6 +109,7 @@ void CollectionShardingState::setMetadata(std::shared_ptr<CollectionMetadata> ne
         invariant(!newMetadata->getShardVersion().isWriteCompatibleWith(ChunkVersion::UNSHARDED()));
     }
 
+    _writeStats.retainChunks(newMetadata.get());
     _metadata = std::move(newMetadata);
 }
 
@@ -170,6 +176,8 @@ void CollectionShardingState::onInsertOp(OperationContext* txn, const BSONObj& i
     if (_sourceMgr) {
         _sourceMgr->getCloner()->onInsertOp(txn, insertedDoc);
     }
+
+    _recordChunkWrite(txn, insertedDoc);
 }
 
 void CollectionShardingState::onUpdateOp(OperationContext* txn, const BSONObj& updatedDoc) {
@@ -180,6 +188,8 @@ void CollectionShardingState::onUpdateOp(OperationContext* txn, const BSONObj& u
     if (_sourceMgr) {
         _sourceMgr->getCloner()->onUpdateOp(txn, updatedDoc);
     }
+
+    _recordChunkWrite(txn, updatedDoc);
 }
 
 void CollectionShardingState::onDeleteOp(OperationContext* txn, const BSONObj& deletedDocId) {
@@ -201,6 +211,45 @@ void CollectionShardingState::onDeleteOp(OperationContext* txn, const BSONObj& d
     }
 }
 
+void CollectionShardingState::_recordChunkWrite(OperationContext* txn, const BSONObj& doc) {
+    if (!autoSplitOnShard.load() || !_metadata) {
+        return;
+    }
+
+    if (!repl::ReplicationCoordinator::get(txn)->canAcceptWritesForDatabase(_nss.db())) {
+        return;
+    }
+
+    const BSONObj shardKey =
+        ShardKeyPattern(_metadata->getKeyPattern()).extractShardKeyFromDoc(doc);
+    if (shardKey.isEmpty() || !_metadata->keyBelongsToMe(shardKey)) {
+        return;
+    }
+
+    ChunkType chunk;
+    if (!_metadata->getNextChunk(shardKey, &chunk)) {
+        return;
+    }
+
+    const long long maxChunkSizeBytes =
+        Grid::get(txn)->getBalancerConfiguration()->getMaxChunkSizeBytes();
+
+    // Writes which roll back leave the chunk as it was, so only count those which commit. The
+    // collection is still locked when the callback runs, but its sharding state is looked up again
+    // rather than captured.
+    const NamespaceString nss = _nss;
+    const BSONObj chunkMin = chunk.getMin().getOwned();
+    const BSONObj chunkMax = chunk.getMax().getOwned();
+    const long long bytes = doc.objsize();
+    txn->recoveryUnit()->onCommit(
+        [txn, nss, chunkMin, chunkMax, shardKey, bytes, maxChunkSizeBytes]() {
+            auto writeStats = CollectionShardingState::get(txn, nss)->getWriteStats();
+            if (writeStats->recordWrite(chunkMin, chunkMax, shardKey, bytes, maxChunkSizeBytes)) {
+                ShardingState::get(txn)->chunkSplitter()->trySplitting(nss, chunkMin, chunkMax);
+            }
+        });
+}
+
 bool CollectionShardingState::_checkShardVersionOk(OperationContext* txn,
                                                    string* errmsg,
                                                    ChunkVersion* expectedShardVersion,
@@ -34,6 +34,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_write_stats.h"
 
 namespace mongo {
 
@@ -84,6 +85,13 @@ public:
      */
     void setMetadata(std::shared_ptr<CollectionMetadata> newMetadata);
 
+    /**
+     * Returns the write statistics of the chunks of this collection owned by this shard.
+     */
+    ChunkWriteStats* getWriteStats() {
+        return &_writeStats;
+    }
+
     /**
      * Returns the active migration source manager, if one is available.
      */
@@ -144,6 +152,13 @@ private:
                               ChunkVersion* expectedShardVersion,
                               ChunkVersion* actualShardVersion) const;
 
+    /**
+     * Records a write of 'doc' in the statistics of the chunk it belongs to, once the write unit
+     * of work of 'txn' commits, and schedules a split of that chunk if it may have grown too large.
+     * Only does anything if shard-side autosplit is enabled and this node is primary.
+     */
+    void _recordChunkWrite(OperationContext* txn, const BSONObj& doc);
+
     // Namespace to which this state belongs.
     const NamespaceString _nss;
 
@@ -157,6 +172,10 @@ private:
     //
     // NOTE: The value is not owned by this class.
     MigrationSourceManager* _sourceMgr{nullptr};
+
+    // Per-chunk write statistics, which drive the shard-side autosplit. Only the chunks present in
+    // '_metadata' are tracked.
+    ChunkWriteStats _writeStats;
 };
 
 }  // namespace mongo
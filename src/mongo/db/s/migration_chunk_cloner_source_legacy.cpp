@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 
+#include <vector>
+
 #include "mongo/base/status.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/client/remote_command_targeter.h"
@@ -403,31 +405,74 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
                            internalQueryExecYieldIterations,
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    // Only the selection of record ids happens under the mutex. The documents are fetched and
+    // serialized outside of it, so that concurrent _migrateClone requests, issued by the parallel
+    // fetch streams of the recipient, can produce their batches at the same time. The collection
+    // IS lock held by the caller prevents the record ids from being reused while they are read.
+    std::vector<RecordId> locs;
+    const int arrSizeAtStart = arrBuilder->arrSize();
+
+    while (true) {
+        {
+            stdx::lock_guard<stdx::mutex> sl(_mutex);
+            if (_cloneLocs.empty()) {
+                break;
+            }
 
-    std::set<RecordId>::iterator it;
+            // A batch ends when the tracker's iteration budget is spent, so never take more ids
+            // than that. Larger slices would only be put back below, and would leave the other
+            // fetch streams without work.
+            const uint64_t avgObjSize = std::max<uint64_t>(_averageObjectSizeForCloneLocs, 1);
+            const uint64_t bytesLeft = std::max(0, BSONObjMaxUserSize - arrBuilder->len());
+            const uint64_t iterationBudget = std::max(1, internalQueryExecYieldIterations.load());
+            const size_t maxLocs =
+                std::max<uint64_t>(1, std::min(iterationBudget, bytesLeft / avgObjSize));
+
+            auto sliceEnd = _cloneLocs.begin();
+            for (size_t i = 0; i < maxLocs && sliceEnd != _cloneLocs.end(); ++i, ++sliceEnd) {
+                locs.push_back(*sliceEnd);
+            }
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
-        // We must always make progress in this method by at least one document because empty return
-        // indicates there is no more initial clone data.
-        if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
-            break;
+            _cloneLocs.erase(_cloneLocs.begin(), sliceEnd);
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(txn, *it, &doc)) {
-            // Use the builder size instead of accumulating the document sizes directly so that we
-            // take into consideration the overhead of BSONArray indices.
-            if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+        auto it = locs.begin();
+
+        for (; it != locs.end(); ++it) {
+            // We must always make progress in this method by at least one document because empty
+            // return indicates there is no more initial clone data.
+            if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            Snapshotted<BSONObj> doc;
+            if (collection->findDoc(txn, *it, &doc)) {
+                // Use the builder size instead of accumulating the document sizes directly so that
+                // we take into consideration the overhead of BSONArray indices.
+                if (arrBuilder->arrSize() &&
+                    (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                    break;
+                }
+
+                arrBuilder->append(doc.value());
+            }
+        }
+
+        if (it != locs.end()) {
+            // Return the record ids which did not fit in this batch, so they are sent with the
+            // next one
+            stdx::lock_guard<stdx::mutex> sl(_mutex);
+            _cloneLocs.insert(it, locs.end());
+            break;
         }
-    }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+        // Only take another slice if all documents of this one have been deleted in the meantime
+        if (arrBuilder->arrSize() > arrSizeAtStart) {
+            break;
+        }
+
+        locs.clear();
+    }
 
     return Status::OK();
 }
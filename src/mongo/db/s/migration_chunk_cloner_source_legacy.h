@@ -103,6 +103,9 @@ public:
      * give a chance to the caller to perform some form of yielding. It does not free or acquire any
      * locks on its own.
      *
+     * May be called concurrently by multiple clone requests from the recipient, in which case each
+     * call returns a disjoint set of documents.
+     *
      * NOTE: Must be called with the collection lock held in at least IS mode.
      */
     Status nextCloneBatch(OperationContext* txn,
@@ -184,7 +187,8 @@ private:
     // double commit or double cancel
     bool _cloneCompleted{false};
 
-    // List of record ids that needs to be transferred (initial clone)
+    // List of record ids that needs to be transferred (initial clone). Record ids are removed from
+    // here before the corresponding documents are read.
     std::set<RecordId> _cloneLocs;
 
     // The estimated average object size during the clone phase. Used for buffer size
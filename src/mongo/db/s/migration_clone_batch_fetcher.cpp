@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/migration_clone_batch_fetcher.h"
+
+#include "mongo/base/status_with.h"
+#include "mongo/client/connpool.h"
+#include "mongo/db/auth/authorization_manager_global.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+CloneBatchFetcher::CloneBatchFetcher(StreamFactory makeStream, int numStreams)
+    : _makeStream(std::move(makeStream)),
+      _maxBufferedBatches(2 * numStreams),
+      _activeStreams(numStreams) {
+    for (int i = 0; i < numStreams; i++) {
+        _streams.emplace_back([this] { _fetch(); });
+    }
+}
+
+CloneBatchFetcher::~CloneBatchFetcher() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown = true;
+    }
+
+    _cv.notify_all();
+
+    for (auto& stream : _streams) {
+        stream.join();
+    }
+}
+
+std::unique_ptr<CloneBatchFetcher> CloneBatchFetcher::makeForShard(
+    const std::string& fromShard, const BSONObj& migrateCloneRequest, int numStreams) {
+    auto makeStream = [fromShard, migrateCloneRequest]() -> FetchBatchFn {
+        Client::initThread("migrateCloneFetcher");
+
+        if (getGlobalAuthorizationManager()->isAuthEnabled()) {
+            AuthorizationSession::get(cc())->grantInternalAuthorization();
+        }
+
+        // Shared, since stdx::function requires a copyable target. The connection is only
+        // returned to the pool once the donor has been drained.
+        auto conn = std::make_shared<ScopedDbConnection>(fromShard);
+
+        return [conn, migrateCloneRequest]() -> StatusWith<BSONObj> {
+            BSONObj res;
+            if (!(*conn)->runCommand("admin", migrateCloneRequest, res)) {
+                return {ErrorCodes::OperationFailed,
+                        str::stream() << "_migrateClone failed: " << res};
+            }
+
+            if (res["objects"].Obj().isEmpty()) {
+                conn->done();
+                return BSONObj();
+            }
+
+            return res;
+        };
+    };
+
+    return stdx::make_unique<CloneBatchFetcher>(std::move(makeStream), numStreams);
+}
+
+StatusWith<BSONObj> CloneBatchFetcher::next(OperationContext* txn) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    while (_batches.empty() && _activeStreams > 0 && _status.isOK()) {
+        _cv.wait_for(lk, Milliseconds(100).toSystemDuration());
+
+        // Checks for interruption without releasing the lock, which is safe since the exception
+        // will unwind it
+        txn->checkForInterrupt();
+    }
+
+    if (!_status.isOK()) {
+        return _status;
+    }
+
+    if (_batches.empty()) {
+        return BSONObj();
+    }
+
+    BSONObj res = std::move(_batches.front());
+    _batches.pop_front();
+
+    _cv.notify_all();
+    return res;
+}
+
+void CloneBatchFetcher::_fetch() {
+    Status status = Status::OK();
+
+    try {
+        FetchBatchFn fetchBatch = _makeStream();
+
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                while (!_shutdown && _status.isOK() && _batches.size() >= _maxBufferedBatches) {
+                    _cv.wait(lk);
+                }
+
+                if (_shutdown || !_status.isOK()) {
+                    break;
+                }
+            }
+
+            auto swBatch = fetchBatch();
+            if (!swBatch.isOK()) {
+                status = swBatch.getStatus();
+                break;
+            }
+
+            if (swBatch.getValue().isEmpty()) {
+                break;
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _batches.push_back(std::move(swBatch.getValue()));
+            _cv.notify_all();
+        }
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!status.isOK() && _status.isOK()) {
+        _status = status;
+    }
+
+    _activeStreams--;
+    _cv.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class OperationContext;
+template <typename T>
+class StatusWith;
+
+/**
+ * Fetches the initial clone batches of a migration over several streams at once, so that the next
+ * batches are already being read and transferred while the current one is inserted. Each stream
+ * repeatedly fetches batches until it sees the end of the clone data. At most two batches per
+ * stream are buffered.
+ *
+ * The destructor stops and joins all the streams.
+ */
+class CloneBatchFetcher {
+    MONGO_DISALLOW_COPYING(CloneBatchFetcher);
+
+public:
+    /**
+     * Fetches the next batch of one stream. Returns an empty object once the source has no more
+     * data, or a failed status. May throw.
+     */
+    using FetchBatchFn = stdx::function<StatusWith<BSONObj>()>;
+
+    /**
+     * Invoked on the thread of each stream to set up the stream and return its fetch function,
+     * which is only called from that thread. May throw.
+     */
+    using StreamFactory = stdx::function<FetchBatchFn()>;
+
+    CloneBatchFetcher(StreamFactory makeStream, int numStreams);
+    ~CloneBatchFetcher();
+
+    /**
+     * Returns a fetcher whose streams issue the _migrateClone command against 'fromShard' over
+     * separate connections.
+     */
+    static std::unique_ptr<CloneBatchFetcher> makeForShard(const std::string& fromShard,
+                                                           const BSONObj& migrateCloneRequest,
+                                                           int numStreams);
+
+    /**
+     * Returns the next fetched batch, or an empty object once all the streams have seen the end
+     * of the clone data. Returns a failed status if any of the streams failed. Throws if 'txn' is
+     * interrupted while waiting.
+     */
+    StatusWith<BSONObj> next(OperationContext* txn);
+
+private:
+    /**
+     * Body of each stream's thread.
+     */
+    void _fetch();
+
+    const StreamFactory _makeStream;
+    const size_t _maxBufferedBatches;
+
+    // Protects the state below
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+
+    // Batches which have been fetched, but not yet returned by next()
+    std::deque<BSONObj> _batches;
+
+    // Number of streams which have not yet seen the end of the clone data or failed
+    int _activeStreams;
+
+    // The first error encountered by any of the streams
+    Status _status{Status::OK()};
+
+    bool _shutdown{false};
+
+    std::vector<stdx::thread> _streams;
+};
+
+}  // namespace mongo
@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/migration_clone_batch_fetcher.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/notification.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+using unittest::assertGet;
+
+/**
+ * Hands out the batches { n: 0 } to { n: numBatches - 1 } to whichever stream asks next, followed
+ * by an empty object once they are exhausted.
+ */
+class BatchSource {
+public:
+    explicit BatchSource(int numBatches) : _numBatches(numBatches) {}
+
+    CloneBatchFetcher::StreamFactory streamFactory() {
+        return [this] { return [this]() -> StatusWith<BSONObj> { return _nextBatch(); }; };
+    }
+
+    int numFetched() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _numFetched;
+    }
+
+private:
+    BSONObj _nextBatch() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_numFetched == _numBatches) {
+            return BSONObj();
+        }
+
+        return BSON("n" << _numFetched++);
+    }
+
+    const int _numBatches;
+
+    stdx::mutex _mutex;
+    int _numFetched{0};
+};
+
+class CloneBatchFetcherTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _client = _serviceContext.makeClient("CloneBatchFetcherTest");
+        _opCtx = _serviceContext.makeOperationContext(_client.get());
+    }
+
+    void tearDown() override {
+        _opCtx.reset();
+        _client.reset();
+    }
+
+    OperationContext* getTxn() const {
+        return _opCtx.get();
+    }
+
+private:
+    ServiceContextNoop _serviceContext;
+    ServiceContext::UniqueClient _client;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+TEST_F(CloneBatchFetcherTest, ReturnsEachBatchOnceAcrossStreams) {
+    BatchSource source(50);
+    CloneBatchFetcher fetcher(source.streamFactory(), 4);
+
+    std::set<int> seen;
+    while (true) {
+        BSONObj batch = assertGet(fetcher.next(getTxn()));
+        if (batch.isEmpty()) {
+            break;
+        }
+
+        ASSERT(seen.insert(batch["n"].numberInt()).second);
+    }
+
+    ASSERT_EQ(50U, seen.size());
+    ASSERT_EQ(0, *seen.begin());
+    ASSERT_EQ(49, *seen.rbegin());
+
+    // The end of the data is sticky
+    ASSERT(assertGet(fetcher.next(getTxn())).isEmpty());
+}
+
+TEST_F(CloneBatchFetcherTest, NoBatches) {
+    BatchSource source(0);
+    CloneBatchFetcher fetcher(source.streamFactory(), 2);
+
+    ASSERT(assertGet(fetcher.next(getTxn())).isEmpty());
+}
+
+TEST_F(CloneBatchFetcherTest, BuffersAtMostTwoBatchesPerStream) {
+    BatchSource source(100);
+    CloneBatchFetcher fetcher(source.streamFactory(), 1);
+
+    // Give the stream the opportunity to run ahead of the consumer
+    sleepmillis(100);
+    ASSERT_LTE(source.numFetched(), 2);
+
+    ASSERT_EQ(0, assertGet(fetcher.next(getTxn()))["n"].numberInt());
+
+    sleepmillis(100);
+    ASSERT_LTE(source.numFetched(), 3);
+
+    // Destroying the fetcher stops the streams which are waiting for buffer space
+}
+
+TEST_F(CloneBatchFetcherTest, FailedStreamIsReported) {
+    stdx::mutex mutex;
+    int numFetched = 0;
+
+    CloneBatchFetcher fetcher(
+        [&] {
+            return [&]() -> StatusWith<BSONObj> {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (numFetched == 3) {
+                    return {ErrorCodes::HostUnreachable, "donor went away"};
+                }
+
+                return BSON("n" << numFetched++);
+            };
+        },
+        2);
+
+    while (true) {
+        auto swBatch = fetcher.next(getTxn());
+        if (!swBatch.isOK()) {
+            ASSERT_EQ(ErrorCodes::HostUnreachable, swBatch.getStatus());
+            break;
+        }
+
+        ASSERT(!swBatch.getValue().isEmpty());
+    }
+
+    // The failure is sticky
+    ASSERT_EQ(ErrorCodes::HostUnreachable, fetcher.next(getTxn()).getStatus());
+}
+
+TEST_F(CloneBatchFetcherTest, ExceptionWhileSettingUpStreamIsReported) {
+    CloneBatchFetcher fetcher(
+        []() -> CloneBatchFetcher::FetchBatchFn {
+            uasserted(ErrorCodes::HostUnreachable, "cannot connect to donor");
+        },
+        2);
+
+    ASSERT_EQ(ErrorCodes::HostUnreachable, fetcher.next(getTxn()).getStatus());
+}
+
+TEST_F(CloneBatchFetcherTest, InterruptedWhileWaitingForBatch) {
+    Notification<void> release;
+
+    CloneBatchFetcher fetcher(
+        [&] {
+            return [&]() -> StatusWith<BSONObj> {
+                release.get();
+                return BSONObj();
+            };
+        },
+        1);
+
+    // Unblocks the stream before the fetcher joins it
+    ON_BLOCK_EXIT([&] { release.set(); });
+
+    getTxn()->markKilled();
+    ASSERT_THROWS_CODE(fetcher.next(getTxn()), UserException, ErrorCodes::Interrupted);
+}
+
+}  // namespace
+}  // namespace mongo
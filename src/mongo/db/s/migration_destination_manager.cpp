@@ -42,8 +42,10 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
+#include "mongo/db/keypattern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/delete.h"
@@ -52,9 +54,11 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/migration_clone_batch_fetcher.h"
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
 #include "mongo/logger/ramlog.h"
@@ -64,6 +68,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -186,6 +191,51 @@ BSONObj createTransferModsRequest(const MigrationSessionId& sessionId) {
     return builder.obj();
 }
 
+/**
+ * Builds the indexes described by 'indexSpecs' over the documents which are currently in
+ * 'collection' and replicates their creation. Must be called with the database locked in X mode.
+ */
+Status buildIndexes(OperationContext* txn,
+                    Database* db,
+                    Collection* collection,
+                    const std::vector<BSONObj>& indexSpecs) {
+    MultiIndexBlock indexer(txn, collection);
+
+    Status status = indexer.init(indexSpecs);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    status = indexer.insertAllDocumentsInCollection();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    WriteUnitOfWork wunit(txn);
+    indexer.commit();
+
+    for (size_t i = 0; i < indexSpecs.size(); i++) {
+        // make sure to create index on secondaries as well
+        getGlobalServiceContext()->getOpObserver()->onCreateIndex(
+            txn, db->getSystemIndexesName(), indexSpecs[i], true /* fromMigrate */);
+    }
+
+    wunit.commit();
+    return Status::OK();
+}
+
+// Number of connections over which the initial clone data of a migration is fetched concurrently
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneFetchStreams, int, 2);
+
+// Maximum number of cloned documents inserted under one lock acquisition and storage transaction
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertBatchSize, int, 100);
+
+// Whether indexes missing on the recipient are built in bulk after the initial clone, instead of
+// being created up front and maintained through each insert. Only applies if the recipient owns
+// no chunks of the collection, and never to unique indexes. The build holds the database lock
+// exclusively.
+MONGO_EXPORT_SERVER_PARAMETER(migrateDeferIndexBuilds, bool, false);
+
 // Enabling / disabling these fail points pauses / resumes MigrateStatus::_go(), the thread which
 // receives a chunk migration from the donor.
 MONGO_FP_DECLARE(migrateThreadHangAtStep1);
@@ -351,6 +401,60 @@ bool MigrationDestinationManager::startCommit(const MigrationSessionId& sessionI
     return false;
 }
 
+long long MigrationDestinationManager::insertClonedDocuments(
+    OperationContext* txn,
+    const string& ns,
+    const BSONObj& min,
+    const BSONObj& max,
+    const BSONObj& shardKeyPattern,
+    std::vector<BSONObj>::const_iterator begin,
+    std::vector<BSONObj>::const_iterator end) {
+    long long totalBytes = 0;
+
+    OldClientWriteContext cx(txn, ns);
+
+    for (auto it = begin; it != end; ++it) {
+        BSONObj localDoc;
+        if (willOverrideLocalId(txn, ns, min, max, shardKeyPattern, cx.db(), *it, &localDoc)) {
+            string errMsg = str::stream() << "cannot migrate chunk, local document " << localDoc
+                                          << " has same _id as cloned "
+                                          << "remote document " << *it;
+
+            warning() << errMsg;
+
+            // Exception will abort migration cleanly
+            uasserted(16976, errMsg);
+        }
+
+        totalBytes += it->objsize();
+    }
+
+    // The range was emptied before the clone started, so the documents can usually be inserted as
+    // a whole. Fall back to upserting them one by one otherwise.
+    Status insertStatus(ErrorCodes::NamespaceNotFound, "collection dropped");
+
+    MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+        Collection* const collection = cx.getCollection();
+        if (collection) {
+            WriteUnitOfWork wunit(txn);
+            insertStatus = collection->insertDocuments(
+                txn, begin, end, nullptr, false, true /* fromMigrate */);
+            if (insertStatus.isOK()) {
+                wunit.commit();
+            }
+        }
+    }
+    MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "migrateClone", ns);
+
+    if (!insertStatus.isOK()) {
+        for (auto it = begin; it != end; ++it) {
+            Helpers::upsert(txn, ns, *it, true);
+        }
+    }
+
+    return totalBytes;
+}
+
 void MigrationDestinationManager::_migrateThread(std::string ns,
                                                  MigrationSessionId sessionId,
                                                  BSONObj min,
@@ -396,6 +500,21 @@ void MigrationDestinationManager::_migrateThread(std::string ns,
         }
     }
 
+    bool clonedWithDeferredIndexes;
+    {
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
+        clonedWithDeferredIndexes = _clonedWithDeferredIndexes;
+        _clonedWithDeferredIndexes = false;
+    }
+
+    if (clonedWithDeferredIndexes) {
+        // The operation context of the migration may have been killed along with it, so clean up
+        // on a fresh one.
+        opCtx.reset();
+        opCtx = getGlobalServiceContext()->makeOperationContext(&cc());
+        _removeClonedDocuments(opCtx.get(), ns, shardKeyPattern, writeConcern);
+    }
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _sessionId = boost::none;
     _isActiveCV.notify_all();
@@ -467,6 +586,9 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
         }
     }
 
+    // Indexes which are missing on this shard and are to be built after the initial clone
+    std::vector<BSONObj> deferredIndexSpecs;
+
     {
         // 1. copy indexes
 
@@ -512,34 +634,46 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                 return;
             }
 
-            Status status = indexer.init(indexSpecs);
-            if (!status.isOK()) {
-                errmsg = str::stream() << "failed to create index before migrating data. "
-                                       << " error: " << status.toString();
-                warning() << errmsg;
-                setState(FAIL);
-                return;
-            }
-
-            status = indexer.insertAllDocumentsInCollection();
-            if (!status.isOK()) {
-                errmsg = str::stream() << "failed to create index before migrating data. "
-                                       << " error: " << status.toString();
-                warning() << errmsg;
-                setState(FAIL);
-                return;
-            }
+            // An empty collection may still receive writes during the clone, unless this shard
+            // owns no chunks of it, and those writes must not skip any index.
+            auto metadata = CollectionShardingState::get(txn, nss)->getMetadata();
+            const bool ownsNoChunks =
+                !metadata || (metadata->getNumChunks() == 0 && metadata->getNumPending() == 0);
+
+            if (migrateDeferIndexBuilds && ownsNoChunks) {
+                // Building the indexes in bulk once the initial clone has completed is cheaper
+                // than maintaining them on each cloned document. Indexes on the shard key are still
+                // built now, since removing the cloned documents again if the migration fails
+                // relies on them, and so are unique indexes, which must reject duplicates as the
+                // documents are cloned.
+                std::vector<BSONObj> immediateIndexSpecs;
+                for (auto&& spec : indexSpecs) {
+                    if (shardKeyPattern.isPrefixOf(spec["key"].Obj()) ||
+                        spec["unique"].trueValue()) {
+                        immediateIndexSpecs.push_back(spec);
+                    } else {
+                        deferredIndexSpecs.push_back(spec);
+                    }
+                }
 
-            WriteUnitOfWork wunit(txn);
-            indexer.commit();
+                indexSpecs = std::move(immediateIndexSpecs);
 
-            for (size_t i = 0; i < indexSpecs.size(); i++) {
-                // make sure to create index on secondaries as well
-                getGlobalServiceContext()->getOpObserver()->onCreateIndex(
-                    txn, db->getSystemIndexesName(), indexSpecs[i], true /* fromMigrate */);
+                if (!deferredIndexSpecs.empty()) {
+                    stdx::lock_guard<stdx::mutex> sl(_mutex);
+                    _clonedWithDeferredIndexes = true;
+                }
             }
 
-            wunit.commit();
+            if (!indexSpecs.empty()) {
+                Status status = buildIndexes(txn, db, collection, indexSpecs);
+                if (!status.isOK()) {
+                    errmsg = str::stream() << "failed to create index before migrating data. "
+                                           << " error: " << status.toString();
+                    warning() << errmsg;
+                    setState(FAIL);
+                    return;
+                }
+            }
         }
 
         timing.done(1);
@@ -604,24 +738,37 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
 
         const BSONObj migrateCloneRequest = createMigrateCloneRequest(sessionId);
 
+        // Gets arrays of objects to copy, over several streams whose batches arrive in no
+        // particular order
+        auto fetcher = CloneBatchFetcher::makeForShard(
+            fromShard, migrateCloneRequest, std::max(1, migrateCloneFetchStreams.load()));
+
+        long long clonedDocs = 0;
+        long long clonedBytes = 0;
+
         while (true) {
-            BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
+            auto batchStatus = fetcher->next(txn);
+            if (!batchStatus.isOK()) {
                 setState(FAIL);
-                errmsg = "_migrateClone failed: ";
-                errmsg += res.toString();
+                errmsg = batchStatus.getStatus().reason();
                 error() << errmsg << migrateLog;
                 conn.done();
                 return;
             }
 
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            const BSONObj res = std::move(batchStatus.getValue());
+            if (res.isEmpty()) {
+                break;
+            }
 
-            BSONObjIterator i(arr);
-            while (i.more()) {
+            std::vector<BSONObj> docs;
+            for (const auto& elem : res["objects"].Obj()) {
+                docs.push_back(elem.Obj());
+            }
+
+            const size_t insertBatchSize = std::max(1, migrateCloneInsertBatchSize.load());
+
+            for (size_t batchStart = 0; batchStart < docs.size(); batchStart += insertBatchSize) {
                 txn->checkForInterrupt();
 
                 if (getState() == ABORT) {
@@ -631,52 +778,80 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     return;
                 }
 
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(txn, ns);
-
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(
-                            txn, ns, min, max, shardKeyPattern, cx.db(), docToClone, &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << localDoc << " has same _id as cloned "
-                                                      << "remote document " << docToClone;
-
-                        warning() << errMsg;
+                const auto begin = docs.cbegin() + batchStart;
+                const auto end =
+                    docs.cbegin() + std::min(batchStart + insertBatchSize, docs.size());
 
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
-                    }
+                const long long batchBytes =
+                    insertClonedDocuments(txn, ns, min, max, shardKeyPattern, begin, end);
 
-                    Helpers::upsert(txn, ns, docToClone, true);
-                }
-                thisTime++;
+                clonedDocs += end - begin;
+                clonedBytes += batchBytes;
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += end - begin;
+                    _clonedBytes += batchBytes;
                 }
+            }
 
-                if (writeConcern.shouldWaitForOtherNodes()) {
-                    repl::ReplicationCoordinator::StatusAndDuration replStatus =
-                        repl::getGlobalReplicationCoordinator()->awaitReplication(
-                            txn,
-                            repl::ReplClientInfo::forClient(txn->getClient()).getLastOp(),
-                            writeConcern);
-                    if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
-                        warning() << "secondaryThrottle on, but doc insert timed out; "
-                                     "continuing";
-                    } else {
-                        massertStatusOK(replStatus.status);
-                    }
+            if (writeConcern.shouldWaitForOtherNodes()) {
+                repl::ReplicationCoordinator::StatusAndDuration replStatus =
+                    repl::getGlobalReplicationCoordinator()->awaitReplication(
+                        txn,
+                        repl::ReplClientInfo::forClient(txn->getClient()).getLastOp(),
+                        writeConcern);
+                if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
+                    warning() << "secondaryThrottle on, but doc insert timed out; "
+                                 "continuing";
+                } else {
+                    massertStatusOK(replStatus.status);
                 }
             }
+        }
 
-            if (thisTime == 0)
-                break;
+        if (!deferredIndexSpecs.empty()) {
+            ScopedTransaction scopedXact(txn, MODE_IX);
+            Lock::DBLock lk(txn->lockState(), nsToDatabaseSubstring(ns), MODE_X);
+            OldClientContext ctx(txn, ns);
+
+            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
+                errmsg = str::stream() << "Not primary during migration: " << ns;
+                warning() << errmsg;
+                setState(FAIL);
+                return;
+            }
+
+            Database* db = ctx.db();
+            Collection* collection = db->getCollection(ns);
+            if (!collection) {
+                errmsg = str::stream() << "collection dropped during migration: " << ns;
+                warning() << errmsg;
+                setState(FAIL);
+                return;
+            }
+
+            MultiIndexBlock indexer(txn, collection);
+            indexer.removeExistingIndexes(&deferredIndexSpecs);
+
+            if (!deferredIndexSpecs.empty()) {
+                Status status = buildIndexes(txn, db, collection, deferredIndexSpecs);
+                if (!status.isOK()) {
+                    errmsg = str::stream() << "failed to create index after migrating data. "
+                                           << " error: " << status.toString();
+                    warning() << errmsg;
+                    setState(FAIL);
+                    return;
+                }
+
+                deferredIndexSpecs.clear();
+            }
+
+            stdx::lock_guard<stdx::mutex> sl(_mutex);
+            _clonedWithDeferredIndexes = false;
         }
 
+        timing.noteStepData(clonedDocs, clonedBytes);
         timing.done(3);
 
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
@@ -1011,6 +1186,35 @@ Status MigrationDestinationManager::_notePending(OperationContext* txn,
     return Status::OK();
 }
 
+void MigrationDestinationManager::_removeClonedDocuments(OperationContext* txn,
+                                                         const std::string& ns,
+                                                         const BSONObj& shardKeyPattern,
+                                                         const WriteConcernOptions& writeConcern) {
+    // This shard owned no chunks of the collection when the migration started, so its documents
+    // are all orphans, and not only those in the range of the migration.
+    KeyPattern kp(shardKeyPattern);
+    RangeDeleterOptions deleterOptions(
+        KeyRange(ns, kp.globalMin(), kp.globalMax(), shardKeyPattern));
+    deleterOptions.writeConcern = writeConcern;
+    deleterOptions.waitForOpenCursors = false;
+    deleterOptions.fromMigrate = true;
+    deleterOptions.onlyRemoveOrphanedDocs = true;
+    deleterOptions.removeSaverReason = "deferredIndexCleanup";
+
+    string errMsg;
+    bool deleted = false;
+    try {
+        deleted = getDeleter()->deleteNow(txn, deleterOptions, &errMsg);
+    } catch (const DBException& ex) {
+        errMsg = ex.toString();
+    }
+
+    if (!deleted) {
+        warning() << "Failed to remove the documents cloned before the indexes of " << ns
+                  << " were built: " << errMsg;
+    }
+}
+
 Status MigrationDestinationManager::_forgetPending(OperationContext* txn,
                                                    const NamespaceString& nss,
                                                    const BSONObj& min,
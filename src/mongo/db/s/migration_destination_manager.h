@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/bsonobj.h"
@@ -89,6 +90,22 @@ public:
 
     bool startCommit(const MigrationSessionId& sessionId);
 
+    /**
+     * Inserts the documents [begin, end) of the initial clone of the chunk [min, max) into 'ns'
+     * under one lock acquisition and storage transaction. Falls back to upserting them one by one
+     * if they cannot be inserted as a whole, e.g. because some of them were already cloned.
+     * Throws if a document has the same _id as a local document outside of the chunk.
+     *
+     * Returns the total size of the documents.
+     */
+    static long long insertClonedDocuments(OperationContext* txn,
+                                           const std::string& ns,
+                                           const BSONObj& min,
+                                           const BSONObj& max,
+                                           const BSONObj& shardKeyPattern,
+                                           std::vector<BSONObj>::const_iterator begin,
+                                           std::vector<BSONObj>::const_iterator end);
+
 private:
     /**
      * Thread which drives the migration apply process on the recipient side.
@@ -143,6 +160,16 @@ private:
                         const BSONObj& max,
                         const OID& epoch);
 
+    /**
+     * Removes the orphaned documents of 'ns' after a migration which cloned them before building
+     * some of the collection's indexes failed. Until then, those documents would prevent any
+     * further chunk from being migrated to this shard, since its indexes are missing.
+     */
+    void _removeClonedDocuments(OperationContext* txn,
+                                const std::string& ns,
+                                const BSONObj& shardKeyPattern,
+                                const WriteConcernOptions& writeConcern);
+
     /**
      * Stops tracking a chunk range between 'min' and 'max' that previously was having data
      * migrated into it.  This data is no longer protected against cleanup of orphaned data.
@@ -181,6 +208,10 @@ private:
     // failure we can perform the appropriate cleanup.
     bool _chunkMarkedPending{false};
 
+    // Set while the documents cloned by the current migration lack some indexes whose builds were
+    // deferred. Used so that on failure those documents are removed again.
+    bool _clonedWithDeferredIndexes{false};
+
     long long _numCloned{0};
     long long _clonedBytes{0};
     long long _numCatchup{0};
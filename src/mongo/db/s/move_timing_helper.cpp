@@ -72,6 +72,11 @@ MoveTimingHelper::~MoveTimingHelper() {
             _b.append("from", _from.toString());
         }
 
+        BSONObj throughput = _throughput.done();
+        if (!throughput.isEmpty()) {
+            _b.append("throughput", throughput);
+        }
+
         if (_nextStep != _totalNumSteps) {
             _b.append("note", "aborted");
         } else {
@@ -102,8 +107,22 @@ void MoveTimingHelper::done(int step) {
         op->setMessage_inlock(s.c_str());
     }
 
-    _b.appendNumber(s, _t.millis());
+    const long long millis = _t.millis();
+    _b.appendNumber(s, millis);
     _t.reset();
+
+    if (_stepDocs >= 0) {
+        _throughput.append(s,
+                           BSON("docs" << _stepDocs << "bytes" << _stepBytes << "bytesPerSec"
+                                       << (millis > 0 ? _stepBytes * 1000 / millis : _stepBytes)));
+        _stepDocs = -1;
+        _stepBytes = 0;
+    }
+}
+
+void MoveTimingHelper::noteStepData(long long numDocs, long long numBytes) {
+    _stepDocs = numDocs;
+    _stepBytes = numBytes;
 }
 
 }  // namespace mongo
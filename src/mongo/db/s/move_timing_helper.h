@@ -54,6 +54,12 @@ public:
 
     void done(int step);
 
+    /**
+     * Records the amount of data processed by the step currently in progress. It is reported
+     * together with the throughput of that step when the step is marked as done.
+     */
+    void noteStepData(long long numDocs, long long numBytes);
+
 private:
     // Measures how long the receiving of a chunk takes
     Timer _t;
@@ -68,6 +74,13 @@ private:
 
     int _nextStep;
     BSONObjBuilder _b;
+
+    // Data processed by the step in progress, as recorded through noteStepData
+    long long _stepDocs{-1};
+    long long _stepBytes{0};
+
+    // Per-step amount of data and throughput, for the steps which recorded it
+    BSONObjBuilder _throughput;
 };
 
 }  // namespace mongo
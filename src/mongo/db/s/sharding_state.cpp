@@ -209,6 +209,9 @@ void ShardingState::shutDown(OperationContext* txn) {
                    "Sharding state unavailable because the system is shutting down"));
     }
 
+    // Must be stopped before the executors, which the splits in progress may be waiting on
+    _chunkSplitter.shutDown();
+
     if (_getInitializationState() == InitializationState::kInitialized) {
         grid.getExecutorPool()->shutdownAndJoin();
         grid.catalogClient(txn)->shutDown(txn);
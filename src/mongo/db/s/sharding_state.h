@@ -36,6 +36,7 @@
 #include "mongo/bson/oid.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/active_migrations_registry.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/memory.h"
@@ -94,6 +95,10 @@ public:
         return &_migrationDestManager;
     }
 
+    ChunkSplitter* chunkSplitter() {
+        return &_chunkSplitter;
+    }
+
     /**
      * Initializes sharding state and begins authenticating outgoing connections and handling shard
      * versions. If this is not run before sharded operations occur auth will not work and versions
@@ -323,6 +328,9 @@ private:
     // Tracks the active move chunk operations running on this shard
     ActiveMigrationsRegistry _activeMigrationsRegistry;
 
+    // Performs the splits of chunks, which have grown too large
+    ChunkSplitter _chunkSplitter;
+
     // Protects state below
     stdx::mutex _mutex;
 
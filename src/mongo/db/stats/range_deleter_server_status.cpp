@@ -28,6 +28,7 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/range_deleter_db_env.h"
 #include "mongo/db/range_deleter_service.h"
 
 namespace mongo {
@@ -38,6 +39,12 @@ namespace mongo {
  * Sample format:
  *
  * rangeDeleter: {
+ *   totalDeletes: NumberLong(3),
+ *   pendingDeletes: NumberLong(1),
+ *   deletesInProgress: NumberLong(2),
+ *   deletedDocs: NumberLong(1500),
+ *   deletedBytes: NumberLong(245760),
+ *   throttledMillis: NumberLong(0),
  *   lastDeleteStats: [
  *     {
  *       deleteDocs: NumberLong(5);
@@ -65,6 +72,11 @@ public:
         }
 
         BSONObjBuilder result;
+        result.append("totalDeletes", static_cast<long long>(deleter->getTotalDeletes()));
+        result.append("pendingDeletes", static_cast<long long>(deleter->getPendingDeletes()));
+        result.append("deletesInProgress",
+                      static_cast<long long>(deleter->getDeletesInProgress()));
+        RangeDeleterDBEnv::appendStats(&result);
 
         OwnedPointerVector<DeleteJobStats> statsList;
         deleter->getStatsHistory(&statsList.mutableVector());
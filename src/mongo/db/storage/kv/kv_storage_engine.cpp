@@ -38,6 +38,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -105,6 +106,7 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
                                  _options.directoryForIndexes));
     _catalog->init(&opCtx);
 
+    Timer timer;
     std::vector<std::string> collections;
     _catalog->getAllCollections(&collections);
 
@@ -124,6 +126,9 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
 
     opCtx.recoveryUnit()->abandonSnapshot();
 
+    log() << "Loaded " << collections.size() << " collections in " << _dbs.size()
+          << " databases from the catalog in " << timer.millis() << "ms";
+
     // now clean up orphaned idents
     // we don't do this in readOnly mode.
     if (storageGlobalParams.readOnly) {
@@ -128,6 +128,10 @@ public:
 
     void setJournalListener(JournalListener* jl) final;
 
+    WiredTigerSessionCache* getSessionCache() const {
+        return _sessionCache.get();
+    }
+
     // wiredtiger specific
     // Calls WT_CONNECTION::reconfigure on the underlying WT_CONNECTION
     // held by this class
@@ -145,9 +149,19 @@ public:
      * Initializes a background job to remove excess documents in the oplog collections.
      * This applies to the capped collections in the local.oplog.* namespaces (specifically
      * local.oplog.rs for replica sets and local.oplog.$main for master/slave replication).
+     * Returns true if a background job is running for the namespace. 'uri' is the table of the
+     * record store.
+     */
+    static bool initRsOplogBackgroundThread(StringData ns, StringData uri);
+
+    /**
+     * Initializes a background job to remove excess documents in a capped collection that was
+     * created with the 'backgroundCappedTruncation' option, so that inserts never have to delete
+     * old documents themselves. The job exits once the collection, whose record store uses the
+     * table 'uri', is dropped.
      * Returns true if a background job is running for the namespace.
      */
-    static bool initRsOplogBackgroundThread(StringData ns);
+    static bool initRsCappedBackgroundThread(StringData ns, StringData uri);
 
     static void appendGlobalStats(BSONObjBuilder& b);
 
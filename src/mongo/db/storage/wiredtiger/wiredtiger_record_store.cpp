@@ -79,6 +79,10 @@ static_assert(kCurrentRecordStoreVersion >= kMinimumRecordStoreVersion,
 static_assert(kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion,
               "kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion");
 
+// Most records a capped collection other than the oplog deletes per write unit of work when it is
+// truncated in the background, since the capped callback is notified of each of them.
+const int64_t kMaxRecordsPerCappedTruncate = 1000;
+
 bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
     StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
     if (!appMetadata.isOK()) {
@@ -88,6 +92,15 @@ bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
     return (appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
 
+bool shouldUseBackgroundCappedTruncation(OperationContext* opCtx, const std::string& uri) {
+    StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
+    if (!appMetadata.isOK()) {
+        return false;
+    }
+
+    return (appMetadata.getValue().getIntField("backgroundCappedTruncation") == 1);
+}
+
 }  // namespace
 
 MONGO_FP_DECLARE(WTWriteConflictException);
@@ -290,7 +303,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* txn)
     long long numRecords = _rs->numRecords(txn);
     long long dataSize = _rs->dataSize(txn);
 
-    log() << "The size storer reports that the oplog contains " << numRecords
+    log() << "The size storer reports that " << _rs->ns() << " contains " << numRecords
           << " records totaling to " << dataSize << " bytes";
 
     // Only use sampling to estimate where to place the oplog stones if the number of samples drawn
@@ -316,7 +329,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* txn)
 }
 
 void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* txn) {
-    log() << "Scanning the oplog to determine where to place markers for truncation";
+    log() << "Scanning " << _rs->ns() << " to determine where to place markers for truncation";
 
     long long numRecords = 0;
     long long dataSize = 0;
@@ -646,6 +659,15 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == "backgroundCappedTruncation") {
+            // Not a WiredTiger option, see generateCreateString().
+            if (!elem.isBoolean()) {
+                return StatusWith<std::string>(ErrorCodes::TypeMismatch,
+                                               str::stream()
+                                                   << "'backgroundCappedTruncation' must be a "
+                                                      "boolean, not "
+                                                   << typeName(elem.type()));
+            }
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -779,6 +801,12 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
     ss << ",app_metadata=(formatVersion=" << kCurrentRecordStoreVersion;
     if (NamespaceString::oplog(ns)) {
         ss << ",oplogKeyExtractionVersion=1";
+    } else if (options.capped && !options.cappedMaxDocs &&
+               options.storageEngine.getObjectField(engineName)["backgroundCappedTruncation"]
+                   .trueValue()) {
+        // Capped collections limited by a maximum number of documents need exact enforcement, so
+        // only size-limited ones may have their old documents removed in the background.
+        ss << ",backgroundCappedTruncation=1";
     }
     ss << ")";
 
@@ -832,6 +860,19 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
         invariant(_cappedMaxDocs == -1);
     }
 
+    if (_sizeStorer && !_isCapped) {
+        // The size storer already knows the number of records and data size, so finding the
+        // largest RecordId in use can wait until the first insert.
+        long long numRecords;
+        long long dataSize;
+        _sizeStorer->loadFromCache(uri, &numRecords, &dataSize);
+        _numRecords.store(numRecords);
+        _dataSize.store(dataSize);
+        _sizeStorer->onCreate(this, numRecords, dataSize);
+        _nextIdNum.store(0);
+        return;
+    }
+
     // Find the largest RecordId currently in use and estimate the number of records.
     Cursor cursor(ctx, *this, /*forward=*/false);
     if (auto record = cursor.next()) {
@@ -866,7 +907,12 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
             _sizeStorer->onCreate(this, 0, 0);
     }
 
-    if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns)) {
+    if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns, _uri)) {
+        _oplogStones = std::make_shared<OplogStones>(ctx, this);
+    } else if (_isCapped && _cappedMaxDocs == -1 && shouldUseBackgroundCappedTruncation(ctx, _uri) &&
+               WiredTigerKVEngine::initRsCappedBackgroundThread(ns, _uri)) {
+        // Inserts into this capped collection only record where stones are placed; the background
+        // thread takes care of truncating the oldest ones, the same way it does for the oplog.
         _oplogStones = std::make_shared<OplogStones>(ctx, this);
     }
 }
@@ -1223,7 +1269,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isNormal());
 
-        LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
+        LOG(1) << "Truncating " << ns() << " between " << _oplogStones->firstRecord << " and "
                << stone->lastRecord << " to remove approximately " << stone->records
                << " records totaling to " << stone->bytes << " bytes";
 
@@ -1233,32 +1279,98 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
         try {
             WriteUnitOfWork wuow(txn);
 
+            // The oplog is truncated a whole stone at a time. Other capped collections may only
+            // get through part of the stone, since every record the capped callback is notified
+            // of adds to the write unit of work.
+            RecordId truncateEnd = stone->lastRecord;
+            int64_t records = stone->records;
+            int64_t bytes = stone->bytes;
+            if (!_isOplog && _cappedCallback) {
+                truncateEnd = _notifyCappedCallbackOfRange(txn,
+                                                           _oplogStones->firstRecord,
+                                                           stone->lastRecord,
+                                                           kMaxRecordsPerCappedTruncate,
+                                                           &records,
+                                                           &bytes);
+            }
+
             WiredTigerCursor startwrap(_uri, _tableId, true, txn);
             WT_CURSOR* start = startwrap.get();
             start->set_key(start, _makeKey(_oplogStones->firstRecord));
 
             WiredTigerCursor endwrap(_uri, _tableId, true, txn);
             WT_CURSOR* end = endwrap.get();
-            end->set_key(end, _makeKey(stone->lastRecord));
+            end->set_key(end, _makeKey(truncateEnd));
 
             invariantWTOK(session->truncate(session, nullptr, start, end, nullptr));
-            _changeNumRecords(txn, -stone->records);
-            _increaseDataSize(txn, -stone->bytes);
+            _changeNumRecords(txn, -records);
+            _increaseDataSize(txn, -bytes);
 
             wuow.commit();
 
-            // Remove the stone after a successful truncation.
-            _oplogStones->popOldestStone();
+            // Remove the stone after it has been truncated entirely.
+            if (truncateEnd == stone->lastRecord) {
+                _oplogStones->popOldestStone();
+            }
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
-            _oplogStones->firstRecord = stone->lastRecord;
+            _oplogStones->firstRecord = truncateEnd;
         } catch (const WriteConflictException& wce) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
     }
 
-    LOG(1) << "Finished truncating the oplog, it now contains approximately " << _numRecords.load()
-           << " records totaling to " << _dataSize.load() << " bytes";
+    LOG(1) << "Finished truncating " << ns() << ", it now contains approximately "
+           << _numRecords.load() << " records totaling to " << _dataSize.load() << " bytes";
+}
+
+RecordId WiredTigerRecordStore::_notifyCappedCallbackOfRange(OperationContext* txn,
+                                                             const RecordId& first,
+                                                             const RecordId& last,
+                                                             int64_t maxRecords,
+                                                             int64_t* records,
+                                                             int64_t* bytes) {
+    // Unlike the oplog, other capped collections may have indexes and cursors that need to hear
+    // about every record before it disappears underneath them with the truncate.
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    WT_CURSOR* c = curwrap.get();
+    c->set_key(c, _makeKey(first));
+
+    *records = 0;
+    *bytes = 0;
+
+    int cmp;
+    int ret = WT_OP_CHECK(c->search_near(c, &cmp));
+    if (ret == 0 && cmp < 0) {
+        ret = WT_OP_CHECK(c->next(c));
+    }
+
+    while (ret == 0) {
+        int64_t key;
+        invariantWTOK(c->get_key(c, &key));
+        const RecordId id = _fromKey(key);
+        if (id > last) {
+            return last;
+        }
+
+        WT_ITEM value;
+        invariantWTOK(c->get_value(c, &value));
+        uassertStatusOK(_cappedCallback->aboutToDeleteCapped(
+            txn, id, RecordData(static_cast<const char*>(value.data), value.size)));
+
+        ++*records;
+        *bytes += value.size;
+        if (*records == maxRecords && id < last) {
+            return id;
+        }
+
+        ret = WT_OP_CHECK(c->next(c));
+    }
+
+    if (ret != WT_NOTFOUND) {
+        invariantWTOK(ret);
+    }
+    return last;
 }
 
 Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
@@ -1297,10 +1409,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* txn,
             record.id = status.getValue();
         } else if (_isCapped) {
             stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-            record.id = _nextId();
+            record.id = _nextId(txn);
             _addUncommitedRecordId_inlock(txn, record.id);
         } else {
-            record.id = _nextId();
+            record.id = _nextId(txn);
         }
         dassert(record.id > highestId);
         highestId = record.id;
@@ -1424,7 +1536,15 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* txn,
     int64_t old_length = old_value.size;
 
     if (_oplogStones && len != old_length) {
-        return {ErrorCodes::IllegalOperation, "Cannot change the size of a document in the oplog"};
+        if (_isOplog) {
+            return {ErrorCodes::IllegalOperation,
+                    "Cannot change the size of a document in the oplog"};
+        }
+        return {ErrorCodes::CannotGrowDocumentInCappedNamespace,
+                str::stream() << "Cannot change the size of a document in a capped collection: "
+                              << old_length
+                              << " != "
+                              << len};
     }
 
     c->set_key(c, _makeKey(id));
@@ -1442,7 +1562,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* txn,
 }
 
 bool WiredTigerRecordStore::updateWithDamagesSupported() const {
-    return false;
+    return true;
 }
 
 StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
@@ -1451,7 +1571,31 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const RecordData& oldRec,
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
-    MONGO_UNREACHABLE;
+    // WiredTiger cannot overwrite part of a value, so the new value is made by patching a copy of
+    // the old one. This is still far cheaper than serializing the updated document again and
+    // comparing its index keys, which is what a full updateRecord() costs the caller.
+    const int size = oldRec.size();
+    SharedBuffer data = SharedBuffer::allocate(size);
+    std::memcpy(data.get(), oldRec.data(), size);
+    for (auto&& damage : damages) {
+        invariant(damage.targetOffset + damage.size <= static_cast<size_t>(size));
+        std::memcpy(
+            data.get() + damage.targetOffset, damageSource + damage.sourceOffset, damage.size);
+    }
+
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+    c->set_key(c, _makeKey(id));
+    WiredTigerItem value(data.get(), size);
+    c->set_value(c, value.Get());
+    int ret = WT_OP_CHECK(c->insert(c));
+    invariantWTOK(ret);
+
+    // Damages never change the size of the record, so there is no data size or capped
+    // bookkeeping to do.
+    return RecordData(std::move(data), size);
 }
 
 void WiredTigerRecordStore::_oplogSetStartHack(WiredTigerRecoveryUnit* wru) const {
@@ -1740,13 +1884,33 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* txn,
     }
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+RecordId WiredTigerRecordStore::_nextId(OperationContext* txn) {
     invariant(!_useOplogHack);
+    if (MONGO_unlikely(_nextIdNum.load() == 0)) {
+        _initNextIdNum(txn);
+    }
     RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
     invariant(out.isNormal());
     return out;
 }
 
+void WiredTigerRecordStore::_initNextIdNum(OperationContext* txn) {
+    stdx::lock_guard<stdx::mutex> lk(_nextIdNumMutex);
+    if (_nextIdNum.load() != 0) {
+        return;
+    }
+
+    LOG(1) << "Finding the largest RecordId in use for " << ns();
+
+    // Need to start at 1 so we are always higher than RecordId::min()
+    int64_t next = 1;
+    Cursor cursor(txn, *this, /*forward=*/false);
+    if (auto record = cursor.next()) {
+        next = 1 + _makeKey(record->id);
+    }
+    _nextIdNum.store(next);
+}
+
 WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext* txn) {
     return checked_cast<WiredTigerRecoveryUnit*>(txn->recoveryUnit());
 }
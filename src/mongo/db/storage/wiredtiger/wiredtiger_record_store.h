@@ -259,7 +259,8 @@ private:
 
     Status _insertRecords(OperationContext* txn, Record* records, size_t nRecords);
 
-    RecordId _nextId();
+    RecordId _nextId(OperationContext* txn);
+    void _initNextIdNum(OperationContext* txn);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     void _changeNumRecords(OperationContext* txn, int64_t diff);
@@ -267,6 +268,18 @@ private:
     RecordData _getData(const WiredTigerCursor& cursor) const;
     void _oplogSetStartHack(WiredTigerRecoveryUnit* wru) const;
 
+    /**
+     * Notifies the capped callback of the records from 'first' to 'last', stopping after
+     * 'maxRecords' of them. Returns the last record id of the range that was covered, and sets
+     * '*records' and '*bytes' to the number and size of the records it contains.
+     */
+    RecordId _notifyCappedCallbackOfRange(OperationContext* txn,
+                                          const RecordId& first,
+                                          const RecordId& last,
+                                          int64_t maxRecords,
+                                          int64_t* records,
+                                          int64_t* bytes);
+
     const std::string _uri;
     const uint64_t _tableId;  // not persisted
 
@@ -297,7 +310,11 @@ private:
     RecordId _oplog_highestSeen;
     mutable stdx::mutex _uncommittedRecordIdsMutex;
 
+    // Zero until the largest RecordId in use has been found. For collections whose size and count
+    // come from the size storer, that lookup is deferred until the first insert so that opening
+    // the collection at startup does not need to open its table.
     AtomicInt64 _nextIdNum;
+    stdx::mutex _nextIdNumMutex;
     AtomicInt64 _dataSize;
     AtomicInt64 _numRecords;
 
@@ -306,7 +323,8 @@ private:
 
     bool _shuttingDown;
 
-    // Non-null if this record store is underlying the active oplog.
+    // Non-null if this record store is underlying the active oplog, or is a capped collection
+    // created with the 'backgroundCappedTruncation' option.
     std::shared_ptr<OplogStones> _oplogStones;
 };
 
@@ -41,10 +41,15 @@
 namespace mongo {
 
 // static
-bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
+bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns, StringData uri) {
     return NamespaceString::oplog(ns);
 }
 
+// static
+bool WiredTigerKVEngine::initRsCappedBackgroundThread(StringData ns, StringData uri) {
+    return true;
+}
+
 MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
     setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
     return Status::OK();
@@ -44,6 +44,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -58,8 +59,8 @@ stdx::mutex _backgroundThreadMutex;
 
 class WiredTigerRecordStoreThread : public BackgroundJob {
 public:
-    WiredTigerRecordStoreThread(const NamespaceString& ns)
-        : BackgroundJob(true /* deleteSelf */), _ns(ns) {
+    WiredTigerRecordStoreThread(const NamespaceString& ns, StringData uri)
+        : BackgroundJob(true /* deleteSelf */), _ns(ns), _uri(uri.toString()) {
         _name = std::string("WT RecordStoreThread: ") + _ns.toString();
     }
 
@@ -68,7 +69,7 @@ public:
     }
 
     /**
-     * Returns true iff there was an oplog to delete from.
+     * Returns true iff there was an oplog or capped collection to delete from.
      */
     bool _deleteExcessDocuments() {
         if (!getGlobalServiceContext()->getGlobalStorageEngine()) {
@@ -85,7 +86,8 @@ public:
             AutoGetDb autoDb(&txn, _ns.db(), MODE_IX);
             Database* db = autoDb.getDb();
             if (!db) {
-                LOG(2) << "no local database yet";
+                LOG(2) << "no " << _ns.db() << " database yet";
+                _retireIfDropped(&txn);
                 return false;
             }
 
@@ -93,17 +95,32 @@ public:
             Collection* collection = db->getCollection(_ns);
             if (!collection) {
                 LOG(2) << "no collection " << _ns;
+                _retireIfDropped(&txn);
                 return false;
             }
 
             OldClientContext ctx(&txn, _ns.ns(), false);
             WiredTigerRecordStore* rs =
                 checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+            if (!rs->oplogStones()) {
+                // The collection was recreated without the 'backgroundCappedTruncation' option.
+                _retireIfNotOplog();
+                return false;
+            }
+
+            // The collection may have been recreated since this thread was started for it, in
+            // which case this thread now truncates the new one.
+            _uri = rs->getURI();
 
             if (!rs->yieldAndAwaitOplogDeletionRequest(&txn)) {
                 return false;  // Oplog went away.
             }
             rs->reclaimOplog(&txn);
+        } catch (const DBException& e) {
+            // Such as a failure to remove the index entries of a record of a capped collection
+            // other than the oplog. Truncation resumes from the same point after backing off.
+            error() << "error in WiredTigerRecordStoreThread for " << _ns << causedBy(e.toStatus());
+            return false;
         } catch (const std::exception& e) {
             severe() << "error in WiredTigerRecordStoreThread: " << e.what();
             fassertFailedNoTrace(!"error in WiredTigerRecordStoreThread");
@@ -116,22 +133,71 @@ public:
     virtual void run() {
         Client::initThread(_name.c_str());
 
-        while (!inShutdown()) {
-            if (!_deleteExcessDocuments()) {
+        while (!inShutdown() && !_retired) {
+            if (!_deleteExcessDocuments() && !_retired) {
                 sleepmillis(1000);  // Back off in case there were problems deleting.
             }
         }
     }
 
 private:
+    /**
+     * Called when the collection cannot be found. That does not mean it was dropped, since its
+     * database may not have been opened yet during startup. So only retires once the table of the
+     * record store this thread last truncated is gone, and otherwise lets the thread retry.
+     */
+    void _retireIfDropped(OperationContext* txn) {
+        if (WiredTigerUtil::getMetadata(txn, _uri).getStatus() != ErrorCodes::NoSuchKey) {
+            return;
+        }
+
+        _retireIfNotOplog();
+    }
+
+    /**
+     * Unlike the oplog, a capped collection using background truncation may go away for good, in
+     * which case the thread exits. Must be called while holding a lock on the database so that a
+     * concurrent re-creation of the collection either finds this thread still running or starts
+     * a new one.
+     */
+    void _retireIfNotOplog() {
+        if (NamespaceString::oplog(_ns.ns())) {
+            return;
+        }
+
+        log() << "Stopping WiredTigerRecordStoreThread " << _ns;
+        stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
+        _backgroundThreadNamespaces.erase(_ns);
+        _retired = true;
+    }
+
     NamespaceString _ns;
+    std::string _uri;
     std::string _name;
+    bool _retired = false;
 };
 
+/**
+ * Starts a WiredTigerRecordStoreThread for 'ns', whose record store uses the table 'uri', unless
+ * one is already running.
+ */
+void startRecordStoreThread(StringData ns, StringData uri) {
+    stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
+    NamespaceString nss(ns);
+    if (_backgroundThreadNamespaces.count(nss)) {
+        log() << "WiredTigerRecordStoreThread " << ns << " already started";
+    } else {
+        log() << "Starting WiredTigerRecordStoreThread " << ns;
+        BackgroundJob* backgroundThread = new WiredTigerRecordStoreThread(nss, uri);
+        backgroundThread->go();
+        _backgroundThreadNamespaces.insert(nss);
+    }
+}
+
 }  // namespace
 
 // static
-bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
+bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns, StringData uri) {
     if (!NamespaceString::oplog(ns)) {
         return false;
     }
@@ -142,16 +208,19 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
         return false;
     }
 
-    stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
-    NamespaceString nss(ns);
-    if (_backgroundThreadNamespaces.count(nss)) {
-        log() << "WiredTigerRecordStoreThread " << ns << " already started";
-    } else {
-        log() << "Starting WiredTigerRecordStoreThread " << ns;
-        BackgroundJob* backgroundThread = new WiredTigerRecordStoreThread(nss);
-        backgroundThread->go();
-        _backgroundThreadNamespaces.insert(nss);
+    startRecordStoreThread(ns, uri);
+    return true;
+}
+
+// static
+bool WiredTigerKVEngine::initRsCappedBackgroundThread(StringData ns, StringData uri) {
+    if (storageGlobalParams.repair) {
+        LOG(1) << "not starting WiredTigerRecordStoreThread for " << ns
+               << " because we are in repair";
+        return false;
     }
+
+    startRecordStoreThread(ns, uri);
     return true;
 }
 
@@ -116,14 +116,15 @@ public:
         return newCappedRecordStore("a.b", cappedSizeBytes, cappedMaxDocs);
     }
 
-    std::unique_ptr<RecordStore> newCappedRecordStore(const std::string& ns,
-                                                      int64_t cappedMaxSize,
-                                                      int64_t cappedMaxDocs) {
+    std::unique_ptr<RecordStore> newCappedRecordStore(
+        const std::string& ns,
+        int64_t cappedMaxSize,
+        int64_t cappedMaxDocs,
+        CollectionOptions options = CollectionOptions()) {
         WiredTigerRecoveryUnit* ru = new WiredTigerRecoveryUnit(_sessionCache);
         OperationContextNoop txn(ru);
         string uri = "table:a.b";
 
-        CollectionOptions options;
         options.capped = true;
 
         StatusWith<std::string> result =
@@ -205,6 +206,30 @@ TEST(WiredTigerRecordStoreTest, GenerateCreateStringValidConfigStringOption) {
               std::string("prefix_compression=true,"));
 }
 
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringBackgroundCappedTruncation) {
+    BSONObj spec = fromjson("{backgroundCappedTruncation: true}");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(spec), std::string(""));
+
+    CollectionOptions options;
+    options.capped = true;
+    options.storageEngine = BSON(kWiredTigerEngineName << spec);
+    StatusWith<std::string> result =
+        WiredTigerRecordStore::generateCreateString(kWiredTigerEngineName, "a.b", options, "");
+    ASSERT_OK(result.getStatus());
+    ASSERT_NOT_EQUALS(std::string::npos, result.getValue().find("backgroundCappedTruncation=1"));
+
+    // Collections capped by number of documents keep deleting inline.
+    options.cappedMaxDocs = 10;
+    result = WiredTigerRecordStore::generateCreateString(kWiredTigerEngineName, "a.b", options, "");
+    ASSERT_OK(result.getStatus());
+    ASSERT_EQUALS(std::string::npos, result.getValue().find("backgroundCappedTruncation"));
+}
+
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringNonBoolBackgroundCappedTruncation) {
+    BSONObj spec = fromjson("{backgroundCappedTruncation: 'yes'}");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(spec), ErrorCodes::TypeMismatch);
+}
+
 TEST(WiredTigerRecordStoreTest, Isolation1) {
     unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -384,6 +409,57 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+// A record store reopened with a size storer finds the largest RecordId in use on its first
+// insert rather than when it is constructed.
+TEST(WiredTigerRecordStoreTest, SizeStorerDeferredNextId) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    string indexUri = "table:myindex";
+    WiredTigerSizeStorer ss(harnessHelper->conn(), indexUri);
+    checked_cast<WiredTigerRecordStore*>(rs.get())->setSizeStorer(&ss);
+
+    RecordId lastId;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 5; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, false);
+            ASSERT_OK(res.getStatus());
+            lastId = res.getValue();
+        }
+        uow.commit();
+    }
+
+    rs.reset(NULL);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs.reset(new WiredTigerRecordStore(
+            opCtx.get(), "a.b", uri, kWiredTigerEngineName, false, false, -1, -1, NULL, &ss));
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(5, rs->numRecords(opCtx.get()));
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "b", 2, false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_GT(res.getValue(), lastId);
+        uow.commit();
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(6, rs->numRecords(opCtx.get()));
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
 namespace {
 
 class GoodValidateAdaptor : public ValidateAdaptor {
@@ -1470,4 +1546,139 @@ TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
     }
 }
 
+// Verify that inserting into a capped collection using background truncation never deletes
+// documents inline, and that reclaiming its stones brings it back under 'cappedMaxSize'.
+TEST(WiredTigerRecordStoreTest, BackgroundCappedTruncation_ReclaimStones) {
+    WiredTigerHarnessHelper harnessHelper;
+
+    CollectionOptions options;
+    options.storageEngine =
+        BSON(kWiredTigerEngineName << BSON("backgroundCappedTruncation" << true));
+
+    const int64_t cappedMaxSize = 256;
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newCappedRecordStore("a.b", cappedMaxSize, -1, options));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    ASSERT(oplogStones);
+
+    oplogStones->setMinBytesPerStone(100);
+    oplogStones->setNumStonesToKeep(1U);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        for (int i = 0; i < 4; ++i) {
+            WriteUnitOfWork wuow(opCtx.get());
+            BSONObj obj = makeBSONObjWithSize(Timestamp(1, i + 1), 100);
+            ASSERT_OK(rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false));
+            wuow.commit();
+        }
+
+        ASSERT_EQ(4, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(400, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(4U, oplogStones->numStones());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(100, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+    }
+}
+
+class CountingCappedCallback final : public CappedCallback {
+public:
+    Status aboutToDeleteCapped(OperationContext* txn, const RecordId& loc, RecordData data) final {
+        ++numDeleted;
+        return Status::OK();
+    }
+
+    void notifyCappedWaitersIfNeeded() final {}
+
+    int numDeleted = 0;
+};
+
+// Verify that a stone holding more records than are deleted per write unit of work is reclaimed in
+// several of them, notifying the capped callback of each record and keeping the counts exact.
+TEST(WiredTigerRecordStoreTest, BackgroundCappedTruncation_ReclaimLargeStone) {
+    WiredTigerHarnessHelper harnessHelper;
+
+    CollectionOptions options;
+    options.storageEngine =
+        BSON(kWiredTigerEngineName << BSON("backgroundCappedTruncation" << true));
+
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("a.b", 256, -1, options));
+
+    CountingCappedCallback cappedCallback;
+    rs->setCappedCallback(&cappedCallback);
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    ASSERT(oplogStones);
+
+    const int numRecordsPerStone = 1500;
+    oplogStones->setMinBytesPerStone(100 * numRecordsPerStone);
+    oplogStones->setNumStonesToKeep(1U);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        for (int i = 0; i < 2 * numRecordsPerStone; ++i) {
+            WriteUnitOfWork wuow(opCtx.get());
+            BSONObj obj = makeBSONObjWithSize(Timestamp(1, i + 1), 100);
+            ASSERT_OK(rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false));
+            wuow.commit();
+        }
+
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(numRecordsPerStone, cappedCallback.numDeleted);
+        ASSERT_EQ(numRecordsPerStone, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(100 * numRecordsPerStone, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+    }
+}
+
+// Changing the size of a record in a capped collection that truncates in the background should
+// fail with the capped collection error, not the one reserved for the oplog.
+TEST(WiredTigerRecordStoreTest, BackgroundCappedTruncation_UpdateRecordSizeChange) {
+    WiredTigerHarnessHelper harnessHelper;
+
+    CollectionOptions options;
+    options.storageEngine =
+        BSON(kWiredTigerEngineName << BSON("backgroundCappedTruncation" << true));
+
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("a.b", 10 * 1024, -1, options));
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+    RecordId id;
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        BSONObj obj = makeBSONObjWithSize(Timestamp(1, 1), 100);
+        auto result = rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false);
+        ASSERT_OK(result.getStatus());
+        id = result.getValue();
+        wuow.commit();
+    }
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        BSONObj changed = makeBSONObjWithSize(Timestamp(1, 1), 101);
+        ASSERT_EQ(ErrorCodes::CannotGrowDocumentInCappedNamespace,
+                  rs->updateRecord(
+                      opCtx.get(), id, changed.objdata(), changed.objsize(), false, nullptr));
+    }
+}
+
 }  // namespace mongo
@@ -75,6 +75,7 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* txn,
     }
 
     WiredTigerKVEngine::appendGlobalStats(bob);
+    _engine->getSessionCache()->appendCursorCacheStats(&bob);
 
     return bob.obj();
 }
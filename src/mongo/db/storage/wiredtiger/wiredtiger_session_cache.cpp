@@ -35,7 +35,11 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <functional>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -46,8 +50,21 @@
 
 namespace mongo {
 
+namespace {
+
+// Maximum number of cursors each session keeps cached. Zero means that cursors are only closed
+// once they have aged out, see WiredTigerSession::releaseCursor.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCursorCacheSize, int, 0);
+
+}  // namespace
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, int epoch)
-    : _epoch(epoch), _session(NULL), _cursorGen(0), _cursorsCached(0), _cursorsOut(0) {
+    : _epoch(epoch),
+      _cache(NULL),
+      _session(NULL),
+      _cursorGen(0),
+      _cursorsCached(0),
+      _cursorsOut(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
 }
 
@@ -69,14 +86,19 @@ WiredTigerSession::~WiredTigerSession() {
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool forRecordStore) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            _cursorsCached--;
-            return c;
+    CursorIndex::iterator it = _cursorIndex.find(id);
+    if (it != _cursorIndex.end()) {
+        CursorCache::iterator i = it->second.back();
+        WT_CURSOR* c = i->_cursor;
+        it->second.pop_back();
+        if (it->second.empty()) {
+            _cursorIndex.erase(it);
         }
+        _cursors.erase(i);
+        _cursorsOut++;
+        _cursorsCached--;
+        _cursorCacheHits++;
+        return c;
     }
 
     WT_CURSOR* c = NULL;
@@ -84,8 +106,10 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
         _session, uri.c_str(), NULL, forRecordStore ? "" : "overwrite=false", &c);
     if (ret != ENOENT)
         invariantWTOK(ret);
-    if (c)
+    if (c) {
         _cursorsOut++;
+        _cursorsOpened++;
+    }
     return c;
 }
 
@@ -98,6 +122,7 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursorIndex[id].push_back(_cursors.begin());
     _cursorsCached++;
 
     // "Old" is defined as not used in the last N**2 operations, if we have N cursors cached.
@@ -106,13 +131,35 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
     // would like to cache N cursors in that case, so any given cursor could go N**2 operations
     // in between use.
     while (_cursorGen - _cursors.back()._gen > 10000) {
-        cursor = _cursors.back()._cursor;
-        _cursors.pop_back();
-        _cursorsCached--;
-        invariantWTOK(cursor->close(cursor));
+        _evictOldestCursor();
+    }
+
+    const int maxCursorsCached = wiredTigerCursorCacheSize.load();
+    while (maxCursorsCached > 0 && _cursorsCached > maxCursorsCached) {
+        _evictOldestCursor();
     }
 }
 
+void WiredTigerSession::_evictOldestCursor() {
+    invariant(!_cursors.empty());
+    const WiredTigerCachedCursor& oldest = _cursors.back();
+
+    // The oldest cursor in the whole cache is also the oldest one cached for its table.
+    CursorIndex::iterator it = _cursorIndex.find(oldest._id);
+    invariant(it != _cursorIndex.end());
+    invariant(&*it->second.front() == &oldest);
+    it->second.erase(it->second.begin());
+    if (it->second.empty()) {
+        _cursorIndex.erase(it);
+    }
+
+    WT_CURSOR* cursor = oldest._cursor;
+    _cursors.pop_back();
+    _cursorsCached--;
+    _cursorsEvicted++;
+    invariantWTOK(cursor->close(cursor));
+}
+
 void WiredTigerSession::closeAllCursors() {
     invariant(_session);
     for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
@@ -122,6 +169,8 @@ void WiredTigerSession::closeAllCursors() {
         }
     }
     _cursors.clear();
+    _cursorIndex.clear();
+    _cursorsCached = 0;
 }
 
 namespace {
@@ -220,17 +269,22 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions released
+    // after this point are freed rather than cached, and getSession() discards any session from
+    // an older epoch that it finds before we get to its partition below.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (size_t i = 0; i < kNumSessionPartitions; i++) {
+        SessionCache swap;
+
+        {
+            scoped_spinlock lock(_partitions[i].lock);
+            _partitions[i].sessions.swap(swap);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator it = swap.begin(); it != swap.end(); it++) {
+            delete (*it);
+        }
     }
 }
 
@@ -243,21 +297,45 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
-            return UniqueWiredTigerSession(cachedSession);
+    // Start with this thread's own partition and only then try to take a session from the others
+    // before resorting to opening a new one.
+    const size_t home = _homePartition();
+    for (size_t i = 0; i < kNumSessionPartitions; i++) {
+        SessionPartition& partition = _partitions[(home + i) % kNumSessionPartitions];
+        WiredTigerSession* cachedSession = nullptr;
+
+        {
+            scoped_spinlock lock(partition.lock);
+            if (!partition.sessions.empty()) {
+                // Get the most recently used session so that if we discard sessions, we're
+                // discarding older ones
+                cachedSession = partition.sessions.back();
+                partition.sessions.pop_back();
+            }
+        }
+
+        if (!cachedSession) {
+            continue;
+        }
+
+        if (cachedSession->_getEpoch() != _epoch.load()) {
+            // closeAll() is running and has not reached this partition yet.
+            delete cachedSession;
+            continue;
         }
+
+        return UniqueWiredTigerSession(cachedSession);
     }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
     return UniqueWiredTigerSession(new WiredTigerSession(_conn, this, _epoch.load()));
 }
 
+// static
+size_t WiredTigerSessionCache::_homePartition() {
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % kNumSessionPartitions;
+}
+
 void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     invariant(session);
     invariant(session->cursorsOut() == 0);
@@ -282,14 +360,23 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         invariant(range == 0);
     }
 
+    // Report the cursor cache statistics gathered while the session was in use.
+    _cursorCacheHits.fetchAndAdd(session->_cursorCacheHits);
+    _cursorsOpened.fetchAndAdd(session->_cursorsOpened);
+    _cursorsEvicted.fetchAndAdd(session->_cursorsEvicted);
+    session->_cursorCacheHits = 0;
+    session->_cursorsOpened = 0;
+    session->_cursorsEvicted = 0;
+
     bool returnedToCache = false;
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        SessionPartition& partition = _partitions[_homePartition()];
+        scoped_spinlock lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -307,6 +394,14 @@ void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     _journalListener = jl;
 }
 
+void WiredTigerSessionCache::appendCursorCacheStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder bob(builder->subobjStart("cursorCache"));
+    bob.append("hits", static_cast<long long>(_cursorCacheHits.load()));
+    bob.append("opened", static_cast<long long>(_cursorsOpened.load()));
+    bob.append("evicted", static_cast<long long>(_cursorsEvicted.load()));
+    bob.done();
+}
+
 void WiredTigerSessionCache::WiredTigerSessionDeleter::operator()(
     WiredTigerSession* session) const {
     session->_cache->releaseSession(session);
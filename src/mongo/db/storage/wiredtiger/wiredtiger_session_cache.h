@@ -33,6 +33,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
 #include <wiredtiger.h>
@@ -40,11 +41,13 @@
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/unordered_map.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -59,7 +62,7 @@ public:
 };
 
 /**
- * This is a structure that caches 1 cursor for each uri.
+ * This is a structure that caches cursors for each uri, evicting the least recently used ones.
  * The idea is that there is a pool of these somewhere.
  * NOT THREADSAFE
  */
@@ -92,6 +95,10 @@ public:
         return _session;
     }
 
+    /**
+     * Returns a cursor on 'uri' taken from this session's cursor cache, only opening a new one
+     * if no cursor for the table 'id' is cached.
+     */
     WT_CURSOR* getCursor(const std::string& uri, uint64_t id, bool forRecordStore);
 
     void releaseCursor(uint64_t id, WT_CURSOR* cursor);
@@ -102,6 +109,10 @@ public:
         return _cursorsOut;
     }
 
+    int cursorsCached() const {
+        return _cursorsCached;
+    }
+
     static uint64_t genTableId();
 
     /**
@@ -112,20 +123,32 @@ public:
 private:
     friend class WiredTigerSessionCache;
 
-    // The cursor cache is a list of pairs that contain an ID and cursor
+    // The cursor cache is a list of cursors ordered from most to least recently released, indexed
+    // by table ID so that finding a cursor doesn't have to walk the list. Each table ID maps to
+    // its cached cursors from least to most recently released.
     typedef std::list<WiredTigerCachedCursor> CursorCache;
+    typedef unordered_map<uint64_t, std::vector<CursorCache::iterator>> CursorIndex;
 
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
     }
 
+    // Closes the least recently released cursor.
+    void _evictOldestCursor();
+
     const uint64_t _epoch;
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    CursorIndex _cursorIndex;
     uint64_t _cursorGen;
     int _cursorsCached, _cursorsOut;
+
+    // Cursor cache statistics not yet reported to '_cache'.
+    uint64_t _cursorCacheHits = 0;
+    uint64_t _cursorsOpened = 0;
+    uint64_t _cursorsEvicted = 0;
 };
 
 /**
@@ -187,7 +210,35 @@ public:
 
     void setJournalListener(JournalListener* jl);
 
+    /**
+     * Appends the cursor cache statistics of the sessions released to this cache so far.
+     */
+    void appendCursorCacheStats(BSONObjBuilder* builder) const;
+
 private:
+    typedef std::vector<WiredTigerSession*> SessionCache;
+
+    // Released sessions are kept in several independently locked partitions, so that threads
+    // acquiring and releasing sessions concurrently rarely contend on the same lock. A thread
+    // prefers the partition picked by its thread id and only looks at the others if it is empty.
+    static const size_t kNumSessionPartitions = 16;
+    struct SessionPartitionData {
+        SpinLock lock;
+        SessionCache sessions;
+    };
+
+    // Each partition fills whole cache lines, so no two partition locks share one. The partitions
+    // are padded rather than aligned because this cache is allocated with plain new, which does
+    // not honor over-aligned types before C++17.
+    static const size_t kCacheLineSize = 64;
+    struct SessionPartition : SessionPartitionData {
+        char padding[kCacheLineSize - sizeof(SessionPartitionData) % kCacheLineSize];
+    };
+    static_assert(sizeof(SessionPartition) % kCacheLineSize == 0,
+                  "session partitions must fill whole cache lines");
+
+    static size_t _homePartition();
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
     WiredTigerSnapshotManager _snapshotManager;
@@ -198,12 +249,15 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-    typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    SessionPartition _partitions[kNumSessionPartitions];
 
     // Bumped when all open sessions need to be closed
-    AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
+    AtomicUInt64 _epoch;  // atomic so we can check it outside of the partition locks
+
+    // Cursor cache statistics, accumulated when sessions are released.
+    AtomicUInt64 _cursorCacheHits;
+    AtomicUInt64 _cursorsOpened;
+    AtomicUInt64 _cursorsEvicted;
 
     // Counter and critical section mutex for waitUntilDurable
     AtomicUInt32 _lastSyncTime;
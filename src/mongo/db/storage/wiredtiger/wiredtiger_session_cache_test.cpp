@@ -0,0 +1,189 @@
+// wiredtiger_session_cache_test.cpp
+
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerSessionCacheTest : public unittest::Test {
+public:
+    WiredTigerSessionCacheTest() : _dbpath("wt_test"), _conn(NULL) {
+        invariantWTOK(wiredtiger_open(_dbpath.path().c_str(), NULL, "create", &_conn));
+        _sessionCache = stdx::make_unique<WiredTigerSessionCache>(_conn);
+    }
+
+    ~WiredTigerSessionCacheTest() {
+        _sessionCache.reset();
+        _conn->close(_conn, NULL);
+    }
+
+    WiredTigerSessionCache* sessionCache() {
+        return _sessionCache.get();
+    }
+
+    /**
+     * Creates a table named 'name' and returns its URI.
+     */
+    std::string createTable(WiredTigerSession* session, const std::string& name) {
+        std::string uri = "table:" + name;
+        WT_SESSION* s = session->getSession();
+        invariantWTOK(s->create(s, uri.c_str(), "key_format=q,value_format=u"));
+        return uri;
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+};
+
+/**
+ * Sets the wiredTigerCursorCacheSize server parameter for the lifetime of this object.
+ */
+class CursorCacheSizeSetting {
+public:
+    explicit CursorCacheSizeSetting(const std::string& value) {
+        const auto& parameters = ServerParameterSet::getGlobal()->getMap();
+        auto it = parameters.find("wiredTigerCursorCacheSize");
+        invariant(it != parameters.end());
+        _parameter = it->second;
+        ASSERT_OK(_parameter->setFromString(value));
+    }
+
+    ~CursorCacheSizeSetting() {
+        ASSERT_OK(_parameter->setFromString("0"));
+    }
+
+private:
+    ServerParameter* _parameter;
+};
+
+TEST_F(WiredTigerSessionCacheTest, ReleasedCursorIsReusedForItsUri) {
+    auto session = sessionCache()->getSession();
+    const std::string uriA = createTable(session.get(), "a");
+    const std::string uriB = createTable(session.get(), "b");
+    const uint64_t idA = WiredTigerSession::genTableId();
+    const uint64_t idB = WiredTigerSession::genTableId();
+
+    WT_CURSOR* cursorA = session->getCursor(uriA, idA, true);
+    WT_CURSOR* cursorB = session->getCursor(uriB, idB, true);
+    ASSERT(cursorA);
+    ASSERT(cursorB);
+    ASSERT_EQ(2, session->cursorsOut());
+
+    session->releaseCursor(idA, cursorA);
+    session->releaseCursor(idB, cursorB);
+    ASSERT_EQ(0, session->cursorsOut());
+    ASSERT_EQ(2, session->cursorsCached());
+
+    // Each table gets back the cursor that was released for it, regardless of release order.
+    ASSERT_EQ(cursorA, session->getCursor(uriA, idA, true));
+    ASSERT_EQ(1, session->cursorsCached());
+    ASSERT_EQ(cursorB, session->getCursor(uriB, idB, true));
+    ASSERT_EQ(0, session->cursorsCached());
+
+    session->releaseCursor(idA, cursorA);
+    session->releaseCursor(idB, cursorB);
+}
+
+TEST_F(WiredTigerSessionCacheTest, CacheSizeEvictsLeastRecentlyReleasedCursor) {
+    CursorCacheSizeSetting cacheSize("2");
+
+    auto session = sessionCache()->getSession();
+    std::vector<std::string> uris;
+    std::vector<uint64_t> ids;
+    std::vector<WT_CURSOR*> cursors;
+    for (auto&& name : {"a", "b", "c"}) {
+        uris.push_back(createTable(session.get(), name));
+        ids.push_back(WiredTigerSession::genTableId());
+        cursors.push_back(session->getCursor(uris.back(), ids.back(), true));
+    }
+
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        session->releaseCursor(ids[i], cursors[i]);
+    }
+    ASSERT_EQ(2, session->cursorsCached());
+
+    // The cursors on "b" and "c" are still cached, while the one on "a", released first, was
+    // closed to stay within the cache size.
+    ASSERT_EQ(cursors[2], session->getCursor(uris[2], ids[2], true));
+    ASSERT_EQ(cursors[1], session->getCursor(uris[1], ids[1], true));
+    ASSERT_EQ(0, session->cursorsCached());
+    WT_CURSOR* reopened = session->getCursor(uris[0], ids[0], true);
+    ASSERT(reopened);
+    ASSERT_EQ(0, session->cursorsCached());
+    ASSERT_EQ(3, session->cursorsOut());
+
+    session->releaseCursor(ids[0], reopened);
+    session->releaseCursor(ids[1], cursors[1]);
+    session->releaseCursor(ids[2], cursors[2]);
+    ASSERT_EQ(2, session->cursorsCached());
+}
+
+TEST_F(WiredTigerSessionCacheTest, SessionsReleasedByOtherThreadsAreReused) {
+    const size_t kNumSessions = 8;
+
+    // Take all the sessions first, so that they are distinct, since getSession() would otherwise
+    // return the session released just before.
+    std::set<WiredTigerSession*> released;
+    for (size_t i = 0; i < kNumSessions; ++i) {
+        released.insert(sessionCache()->getSession().release());
+    }
+    ASSERT_EQ(kNumSessions, released.size());
+
+    // Release each session from its own thread, which spreads them over several partitions.
+    for (WiredTigerSession* session : released) {
+        stdx::thread releaser([session] { UniqueWiredTigerSession toRelease(session); });
+        releaser.join();
+    }
+
+    // This thread finds every one of them, whichever partition it was released to.
+    std::vector<UniqueWiredTigerSession> reused;
+    for (size_t i = 0; i < kNumSessions; ++i) {
+        reused.push_back(sessionCache()->getSession());
+        ASSERT_EQ(1U, released.count(reused.back().get()));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -54,8 +54,7 @@ public:
             const string shardId = str::stream() << (i - 1);
             _shardIds.insert(shardId);
 
-            std::shared_ptr<Chunk> chunk(new Chunk(this,
-                                                   mySplitPoints[i - 1],
+            std::shared_ptr<Chunk> chunk(new Chunk(mySplitPoints[i - 1],
                                                    mySplitPoints[i],
                                                    shardId,
                                                    ChunkVersion(0, 0, OID()),
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Fixture for testing IndexAccessMethod::insertBatch, which inserts the index keys of several
+ * documents in key order.
+ */
+class IndexInsertBatchTest : public unittest::Test {
+public:
+    IndexInsertBatchTest() : _nss("unittests.index_insert_batch") {}
+
+    void setUp() final {
+        AutoGetOrCreateDb autoDb(_opCtx.get(), _nss.db(), MODE_X);
+        Database* database = autoDb.getDb();
+        {
+            WriteUnitOfWork wuow(_opCtx.get());
+            ASSERT(database->createCollection(_opCtx.get(), _nss.ns()));
+            wuow.commit();
+        }
+    }
+
+    void tearDown() final {
+        AutoGetDb autoDb(_opCtx.get(), _nss.db(), MODE_X);
+        Database* database = autoDb.getDb();
+        if (database) {
+            WriteUnitOfWork wuow(_opCtx.get());
+            ASSERT_OK(database->dropCollection(_opCtx.get(), _nss.ns()));
+            wuow.commit();
+        }
+    }
+
+    /**
+     * Creates an index on {a: 1}, unique if 'unique' is true, and returns its descriptor.
+     */
+    IndexDescriptor* createIndexOnA(Collection* collection, bool unique) {
+        BSONObj keyPattern = BSON("a" << 1);
+        ASSERT_OK(dbtests::createIndexFromSpec(_opCtx.get(),
+                                               _nss.ns(),
+                                               BSON("name"
+                                                    << "a_1"
+                                                    << "ns"
+                                                    << _nss.ns()
+                                                    << "key"
+                                                    << keyPattern
+                                                    << "unique"
+                                                    << unique)));
+        return collection->getIndexCatalog()->findIndexByKeyPattern(_opCtx.get(), keyPattern);
+    }
+
+    /**
+     * Inserts the keys of 'docs' into the index 'desc' as one batch, giving the documents
+     * consecutive record ids starting at 1.
+     */
+    Status insertBatch(Collection* collection,
+                       IndexDescriptor* desc,
+                       const std::vector<BSONObj>& docs,
+                       int64_t* numInserted) {
+        std::vector<BsonRecord> bsonRecords;
+        for (size_t i = 0; i < docs.size(); ++i) {
+            bsonRecords.push_back({RecordId(i + 1), &docs[i]});
+        }
+
+        InsertDeleteOptions options;
+        options.logIfError = false;
+        options.dupsAllowed = !desc->unique();
+        return collection->getIndexCatalog()->getIndex(desc)->insertBatch(
+            _opCtx.get(), bsonRecords, options, numInserted);
+    }
+
+    bool isMultikey(Collection* collection, IndexDescriptor* desc) {
+        return collection->getIndexCatalog()->getEntry(desc)->isMultikey();
+    }
+
+    bool isIndexEmpty(Collection* collection, IndexDescriptor* desc) {
+        auto cursor = collection->getIndexCatalog()->getIndex(desc)->newCursor(_opCtx.get());
+        return !cursor->seek(BSON("" << MINKEY), true);
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _opCtx = cc().makeOperationContext();
+    const NamespaceString _nss;
+};
+
+TEST_F(IndexInsertBatchTest, CountsKeysOfAllDocuments) {
+    AutoGetCollection autoColl(_opCtx.get(), _nss, MODE_X);
+    Collection* collection = autoColl.getCollection();
+    IndexDescriptor* desc = createIndexOnA(collection, false);
+
+    WriteUnitOfWork wuow(_opCtx.get());
+    int64_t numInserted = -1;
+    ASSERT_OK(insertBatch(collection,
+                          desc,
+                          {BSON("a" << 3), BSON("a" << BSON_ARRAY(2 << 5)), BSON("a" << 1)},
+                          &numInserted));
+    ASSERT_EQ(4, numInserted);
+}
+
+TEST_F(IndexInsertBatchTest, SetsMultikeyOnlyForArrayDocuments) {
+    AutoGetCollection autoColl(_opCtx.get(), _nss, MODE_X);
+    Collection* collection = autoColl.getCollection();
+    IndexDescriptor* desc = createIndexOnA(collection, false);
+
+    WriteUnitOfWork wuow(_opCtx.get());
+    int64_t numInserted;
+    ASSERT_OK(insertBatch(collection, desc, {BSON("a" << 1), BSON("a" << 2)}, &numInserted));
+    ASSERT_EQ(2, numInserted);
+    ASSERT_FALSE(isMultikey(collection, desc));
+
+    ASSERT_OK(insertBatch(
+        collection, desc, {BSON("a" << 3), BSON("a" << BSON_ARRAY(4 << 5))}, &numInserted));
+    ASSERT_EQ(3, numInserted);
+    ASSERT_TRUE(isMultikey(collection, desc));
+}
+
+TEST_F(IndexInsertBatchTest, DuplicateKeyMidBatchRemovesInsertedKeys) {
+    AutoGetCollection autoColl(_opCtx.get(), _nss, MODE_X);
+    Collection* collection = autoColl.getCollection();
+    IndexDescriptor* desc = createIndexOnA(collection, true);
+
+    WriteUnitOfWork wuow(_opCtx.get());
+    int64_t numInserted = -1;
+    Status status = insertBatch(collection,
+                                desc,
+                                {BSON("a" << BSON_ARRAY(1 << 2)), BSON("a" << 3), BSON("a" << 2)},
+                                &numInserted);
+    ASSERT_EQ(ErrorCodes::DuplicateKey, status);
+
+    // The keys inserted before the duplicate are removed again, and the index is not marked
+    // multikey by the document whose keys did make it in.
+    ASSERT_EQ(0, numInserted);
+    ASSERT_TRUE(isIndexEmpty(collection, desc));
+    ASSERT_FALSE(isMultikey(collection, desc));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -2607,6 +2607,31 @@ public:
     }
 };
 
+class NumericTypesByDigitCount {
+public:
+    void run() {
+        BSONObj o = fromjson(
+            "{ a: 2147483647, b: 2147483648, c: 123456789012345678, d: 1234567890123456789,"
+            " e: -2147483649, f: 1e3, g: 12.0, h: -0 }");
+
+        ASSERT_EQUALS(NumberInt, o["a"].type());
+        ASSERT_EQUALS(2147483647, o["a"].numberInt());
+        ASSERT_EQUALS(NumberLong, o["b"].type());
+        ASSERT_EQUALS(2147483648LL, o["b"].numberLong());
+        ASSERT_EQUALS(NumberLong, o["c"].type());
+        ASSERT_EQUALS(123456789012345678LL, o["c"].numberLong());
+        ASSERT_EQUALS(NumberLong, o["d"].type());
+        ASSERT_EQUALS(1234567890123456789LL, o["d"].numberLong());
+        ASSERT_EQUALS(NumberLong, o["e"].type());
+        ASSERT_EQUALS(-2147483649LL, o["e"].numberLong());
+        ASSERT_EQUALS(NumberDouble, o["f"].type());
+        ASSERT_EQUALS(1000.0, o["f"].numberDouble());
+        ASSERT_EQUALS(NumberDouble, o["g"].type());
+        ASSERT_EQUALS(NumberInt, o["h"].type());
+        ASSERT_EQUALS(0, o["h"].numberInt());
+    }
+};
+
 class EmbeddedDatesBase : public Base {
 public:
     virtual void run() {
@@ -2956,6 +2981,7 @@ public:
         add<FromJsonTests::NumericLimitsBad>();
         add<FromJsonTests::NumericLimitsBad1>();
         add<FromJsonTests::NegativeNumericTypes>();
+        add<FromJsonTests::NumericTypesByDigitCount>();
         add<FromJsonTests::EmbeddedDatesFormat1>();
         add<FromJsonTests::EmbeddedDatesFormat2>();
         add<FromJsonTests::EmbeddedDatesFormat3>();
@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/s/migration_destination_manager.h"
+#include "mongo/db/service_context.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Fixture for testing MigrationDestinationManager::insertClonedDocuments, which inserts a group of
+ * documents of the initial clone of the chunk [{x: 0}, {x: 10}).
+ */
+class MigrationCloneInsertTest : public unittest::Test {
+public:
+    MigrationCloneInsertTest() : _nss("unittests.migration_clone_insert"), _client(_opCtx.get()) {}
+
+    void setUp() final {
+        AutoGetOrCreateDb autoDb(_opCtx.get(), _nss.db(), MODE_X);
+        Database* database = autoDb.getDb();
+        {
+            WriteUnitOfWork wuow(_opCtx.get());
+            ASSERT(database->createCollection(_opCtx.get(), _nss.ns()));
+            wuow.commit();
+        }
+    }
+
+    void tearDown() final {
+        AutoGetDb autoDb(_opCtx.get(), _nss.db(), MODE_X);
+        Database* database = autoDb.getDb();
+        if (database) {
+            WriteUnitOfWork wuow(_opCtx.get());
+            ASSERT_OK(database->dropCollection(_opCtx.get(), _nss.ns()));
+            wuow.commit();
+        }
+    }
+
+    long long insertClonedDocuments(const std::vector<BSONObj>& docs) {
+        return MigrationDestinationManager::insertClonedDocuments(_opCtx.get(),
+                                                                  _nss.ns(),
+                                                                  BSON("x" << 0),
+                                                                  BSON("x" << 10),
+                                                                  BSON("x" << 1),
+                                                                  docs.cbegin(),
+                                                                  docs.cend());
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _opCtx = cc().makeOperationContext();
+    const NamespaceString _nss;
+    DBDirectClient _client;
+};
+
+TEST_F(MigrationCloneInsertTest, InsertsAllDocuments) {
+    std::vector<BSONObj> docs;
+    long long totalBytes = 0;
+    for (int i = 0; i < 10; i++) {
+        docs.push_back(BSON("_id" << i << "x" << i));
+        totalBytes += docs.back().objsize();
+    }
+
+    ASSERT_EQ(totalBytes, insertClonedDocuments(docs));
+
+    ASSERT_EQ(10U, _client.count(_nss.ns()));
+    for (const auto& doc : docs) {
+        ASSERT_EQUALS(doc, _client.findOne(_nss.ns(), BSON("_id" << doc["_id"])));
+    }
+}
+
+TEST_F(MigrationCloneInsertTest, UpsertsIfSomeDocumentsAlreadyExist) {
+    _client.insert(_nss.ns(), BSON("_id" << 1 << "x" << 1 << "v" << 0));
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 3; i++) {
+        docs.push_back(BSON("_id" << i << "x" << i << "v" << 1));
+    }
+
+    insertClonedDocuments(docs);
+
+    ASSERT_EQ(3U, _client.count(_nss.ns()));
+    for (const auto& doc : docs) {
+        ASSERT_EQUALS(doc, _client.findOne(_nss.ns(), BSON("_id" << doc["_id"])));
+    }
+}
+
+TEST_F(MigrationCloneInsertTest, FailsIfLocalDocumentOutsideChunkHasSameId) {
+    const BSONObj localDoc = BSON("_id" << 5 << "x" << 20);
+    _client.insert(_nss.ns(), localDoc);
+
+    ASSERT_THROWS_CODE(insertClonedDocuments({BSON("_id" << 4 << "x" << 4),
+                                              BSON("_id" << 5 << "x" << 5)}),
+                       UserException,
+                       16976);
+
+    // Nothing of the group is inserted
+    ASSERT_EQ(1U, _client.count(_nss.ns()));
+    ASSERT_EQUALS(localDoc, _client.findOne(_nss.ns(), BSON("_id" << 5)));
+}
+
+}  // namespace
+}  // namespace mongo
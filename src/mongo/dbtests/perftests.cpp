@@ -44,19 +44,28 @@
 #include <boost/thread/thread.hpp>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <mutex>
 
+#include "mongo/bson/bson_validate.h"
 #include "mongo/config.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/json.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework_options.h"
+#include "mongo/platform/random.h"
+#include "mongo/s/chunk_routing_index.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
@@ -449,6 +458,401 @@ public:
     }
 };
 
+/**
+ * Compares routing a shard key through a std::map of chunk bounds, the way ChunkManager used to,
+ * against the flat ChunkRoutingIndex, over a routing table of 1M chunks.
+ */
+class ChunkRoutingBase : public B {
+public:
+    static const int kNumChunks = 1000 * 1000;
+
+    virtual int howLongMillis() {
+        return 2000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+
+protected:
+    typedef std::map<BSONObj, size_t, BSONObjCmp> KeyMap;
+
+    static const KeyMap& keyMap() {
+        static const KeyMap* map = [] {
+            KeyMap* map = new KeyMap();
+            for (int i = 0; i < kNumChunks; i++) {
+                map->emplace(BSON("_id" << 2 * i), i);
+            }
+            return map;
+        }();
+        return *map;
+    }
+
+    static const ChunkRoutingIndex& routingIndex() {
+        static const ChunkRoutingIndex* index = [] {
+            ChunkRoutingIndex* index = new ChunkRoutingIndex();
+            for (const auto& entry : keyMap()) {
+                invariant(index->add(entry.first));
+            }
+            return index;
+        }();
+        return *index;
+    }
+
+    BSONObj randomKey() {
+        return BSON("_id" << _random.nextInt32(2 * kNumChunks));
+    }
+
+    PseudoRandom _random{42};
+    size_t _sum = 0;
+};
+
+class ChunkMapUpperBound : public ChunkRoutingBase {
+public:
+    string name() {
+        return "chunkmap-upper-bound-1M";
+    }
+    void prep() {
+        keyMap();
+    }
+    void timed() {
+        auto it = keyMap().upper_bound(randomKey());
+        _sum += it == keyMap().end() ? 0 : it->second;
+    }
+};
+
+class ChunkRoutingIndexUpperBound : public ChunkRoutingBase {
+public:
+    string name() {
+        return "chunk-routing-index-upper-bound-1M";
+    }
+    void prep() {
+        routingIndex();
+    }
+    void timed() {
+        _sum += routingIndex().upperBound(randomKey());
+    }
+};
+
+// Each timed() call targets a batch of 100 keys, the way an insert batch is targeted.
+class ChunkRoutingIndexUpperBounds : public ChunkRoutingBase {
+public:
+    string name() {
+        return "chunk-routing-index-upper-bounds-1M-x100";
+    }
+    void prep() {
+        routingIndex();
+    }
+    void timed() {
+        vector<BSONObj> keys;
+        for (int i = 0; i < 100; i++) {
+            keys.push_back(randomKey());
+        }
+        for (size_t pos : routingIndex().upperBounds(keys)) {
+            _sum += pos;
+        }
+    }
+};
+
+/**
+ * Times validateBSON, which runs on every inbound message when objcheck is on, over documents
+ * shaped like typical inserts.
+ */
+class BSONValidateBase : public B {
+public:
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        _doc = makeDoc();
+    }
+    void timed() {
+        invariant(validateBSON(_doc.objdata(), _doc.objsize()).isOK());
+    }
+
+protected:
+    virtual BSONObj makeDoc() = 0;
+
+private:
+    BSONObj _doc;
+};
+
+class BSONValidateSmall : public BSONValidateBase {
+public:
+    string name() {
+        return "bson-validate-small";
+    }
+    BSONObj makeDoc() {
+        return BSON("_id" << OID::gen() << "user" << 12345 << "name"
+                          << "alice"
+                          << "active"
+                          << true
+                          << "score"
+                          << 3.5
+                          << "created"
+                          << Date_t::now());
+    }
+};
+
+class BSONValidateWide : public BSONValidateBase {
+public:
+    string name() {
+        return "bson-validate-wide-200-fields";
+    }
+    BSONObj makeDoc() {
+        BSONObjBuilder b;
+        b.append("_id", OID::gen());
+        for (int i = 0; i < 200; i++) {
+            b.append(string(str::stream() << "field" << i), i);
+        }
+        return b.obj();
+    }
+};
+
+class BSONValidateNested : public BSONValidateBase {
+public:
+    string name() {
+        return "bson-validate-nested-arrays";
+    }
+    BSONObj makeDoc() {
+        BSONArrayBuilder items;
+        for (int i = 0; i < 50; i++) {
+            items.append(BSON("sku" << i << "qty" << 2 << "tags" << BSON_ARRAY(1 << 2)));
+        }
+        return BSON("_id" << 1 << "order" << BSON("items" << items.arr() << "total" << 99.5));
+    }
+};
+
+class BSONValidateLongStrings : public BSONValidateBase {
+public:
+    string name() {
+        return "bson-validate-long-strings";
+    }
+    BSONObj makeDoc() {
+        const string text(1024, 'x');
+        BSONObjBuilder b;
+        b.append("_id", 1);
+        for (int i = 0; i < 16; i++) {
+            b.append(string(str::stream() << "description_of_item_" << i), text);
+        }
+        return b.obj();
+    }
+};
+
+/**
+ * Times fromjson and jsonString over a document shaped like a structured log entry, as seen by
+ * log ingestion and by the shell.
+ */
+class JsonBase : public B {
+public:
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+
+protected:
+    static BSONObj logEntry() {
+        BSONArrayBuilder tags;
+        for (int i = 0; i < 8; i++) {
+            tags.append(string(str::stream() << "tag" << i));
+        }
+        return BSON("ts" << 1476803287123LL << "host"
+                         << "app-server-17.example.net"
+                         << "level"
+                         << "INFO"
+                         << "pid"
+                         << 31337
+                         << "msg"
+                         << "request completed in 12ms with status \"ok\""
+                         << "latency"
+                         << 12.25
+                         << "tags"
+                         << tags.arr()
+                         << "req"
+                         << BSON("method"
+                                 << "GET"
+                                 << "path"
+                                 << "/api/v1/items"
+                                 << "bytes"
+                                 << 5123));
+    }
+};
+
+class JsonParse : public JsonBase {
+public:
+    string name() {
+        return "fromjson-log-entry";
+    }
+    void prep() {
+        _json = logEntry().jsonString();
+    }
+    void timed() {
+        invariant(!fromjson(_json).isEmpty());
+    }
+
+private:
+    string _json;
+};
+
+class JsonSerialize : public JsonBase {
+public:
+    string name() {
+        return "jsonString-log-entry";
+    }
+    void prep() {
+        _doc = logEntry();
+    }
+    void timed() {
+        invariant(!_doc.jsonString().empty());
+    }
+
+private:
+    BSONObj _doc;
+};
+
+/**
+ * Times matching a single value against a $in with 10,000 integers, as generated by applications
+ * which look up a batch of ids.
+ */
+class InMatchLargeList : public B {
+public:
+    string name() {
+        return "in-match-10k-ints";
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        BSONArrayBuilder bab;
+        for (int i = 0; i < 10000; i++) {
+            bab.append(i * 2);
+        }
+        _operand = bab.arr();
+        invariantOK(_in.init("a"));
+        for (auto&& elt : _operand) {
+            invariantOK(_in.addEquality(elt));
+        }
+        _hit = BSON("a" << 9998);
+        _miss = BSON("a" << 9999);
+    }
+    void timed() {
+        invariant(_in.matchesSingleElement(_hit.firstElement()));
+        invariant(!_in.matchesSingleElement(_miss.firstElement()));
+    }
+
+private:
+    BSONArray _operand;
+    InMatchExpression _in;
+    BSONObj _hit;
+    BSONObj _miss;
+};
+
+/**
+ * Times matching a document against a filter of 30 predicates over a few nested subdocuments,
+ * as issued by dashboards, through the MatchExpression tree and through its compiled form.
+ */
+class MatchManyPredicatesBase : public B {
+public:
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        BSONObjBuilder filter;
+        BSONObjBuilder doc;
+        for (int group = 0; group < 3; group++) {
+            BSONObjBuilder sub(doc.subobjStart(string(str::stream() << "g" << group)));
+            for (int i = 0; i < 10; i++) {
+                const string field = str::stream() << "f" << i;
+                sub.append(field, i);
+                filter.append(string(str::stream() << "g" << group << "." << field),
+                              BSON("$gte" << i));
+            }
+            sub.done();
+        }
+        _filter = filter.obj();
+        _doc = doc.obj();
+        auto statusWithMatcher = MatchExpressionParser::parse(
+            _filter, ExtensionsCallbackDisallowExtensions(), nullptr);
+        invariantOK(statusWithMatcher.getStatus());
+        _expr = std::move(statusWithMatcher.getValue());
+        _compiled = CompiledMatchExpression::compile(_expr.get());
+        invariant(_compiled);
+    }
+
+protected:
+    BSONObj _filter;
+    BSONObj _doc;
+    std::unique_ptr<MatchExpression> _expr;
+    std::unique_ptr<CompiledMatchExpression> _compiled;
+};
+
+class MatchManyPredicatesTree : public MatchManyPredicatesBase {
+public:
+    string name() {
+        return "match-30-predicates-tree";
+    }
+    void timed() {
+        invariant(_expr->matchesBSON(_doc));
+    }
+};
+
+class MatchManyPredicatesCompiled : public MatchManyPredicatesBase {
+public:
+    string name() {
+        return "match-30-predicates-compiled";
+    }
+    void timed() {
+        invariant(_compiled->matchesBSON(_doc));
+    }
+};
+
+/**
+ * Times a $regex with a required literal against strings which mostly lack it, as in searches
+ * over log messages.
+ */
+class RegexMatchLogMessages : public B {
+public:
+    string name() {
+        return "regex-match-log-messages";
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        invariantOK(_regex.init("msg", "to shard.* timed out", ""));
+        for (int i = 0; i < 100; i++) {
+            const string msg = str::stream() << "request " << i << " completed in " << i % 17
+                                             << "ms on connection " << i % 5;
+            _docs.push_back(BSON("msg" << msg));
+        }
+        _docs.push_back(BSON("msg"
+                             << "connection 3 to shard0001 timed out"));
+    }
+    void timed() {
+        int matched = 0;
+        for (auto&& doc : _docs) {
+            matched += _regex.matchesSingleElement(doc.firstElement());
+        }
+        invariant(matched == 1);
+    }
+
+private:
+    RegexMatchExpression _regex;
+    std::vector<BSONObj> _docs;
+};
 
 class All : public Suite {
 public:
@@ -462,6 +866,19 @@ public:
         add<boosttimed_mutexspeed>();
         add<stdmutexspeed>();
         add<stdtimed_mutexspeed>();
+        add<ChunkMapUpperBound>();
+        add<ChunkRoutingIndexUpperBound>();
+        add<ChunkRoutingIndexUpperBounds>();
+        add<BSONValidateSmall>();
+        add<BSONValidateWide>();
+        add<BSONValidateNested>();
+        add<BSONValidateLongStrings>();
+        add<JsonParse>();
+        add<JsonSerialize>();
+        add<InMatchLargeList>();
+        add<MatchManyPredicatesTree>();
+        add<MatchManyPredicatesCompiled>();
+        add<RegexMatchLogMessages>();
     }
 } myall;
 }
@@ -43,9 +43,11 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageDelete {
 
@@ -146,10 +148,15 @@ public:
         collScanParams.direction = CollectionScanParams::FORWARD;
         collScanParams.tailable = false;
 
-        // Configure the delete stage.
+        // Configure the delete stage. Delete one document per call to work() so that we can stop
+        // just before the target document.
         DeleteStageParams deleteStageParams;
         deleteStageParams.isMulti = true;
 
+        const int oldBatchSize = internalQueryExecWriteBatchSize;
+        internalQueryExecWriteBatchSize = 1;
+        ON_BLOCK_EXIT([oldBatchSize] { internalQueryExecWriteBatchSize = oldBatchSize; });
+
         WorkingSet ws;
         DeleteStage deleteStage(&_txn,
                                 deleteStageParams,
@@ -190,6 +197,71 @@ public:
     }
 };
 
+/**
+ * Test that a multi-delete deletes a batch of documents per call to work(), and still skips a
+ * document which is invalidated between batches.
+ */
+class QueryStageDeleteBatchesMultiDelete : public QueryStageDeleteBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+
+        const int oldBatchSize = internalQueryExecWriteBatchSize;
+        internalQueryExecWriteBatchSize = 16;
+        ON_BLOCK_EXIT([oldBatchSize] { internalQueryExecWriteBatchSize = oldBatchSize; });
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_txn,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_txn, collScanParams, &ws, NULL));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        ASSERT_EQUALS(16U, stats->docsDeleted);
+
+        // Remove a document from the next batch.
+        const size_t targetDocIndex = 20;
+        deleteStage.saveState();
+        {
+            WriteUnitOfWork wunit(&_txn);
+            deleteStage.invalidate(&_txn, recordIds[targetDocIndex], INVALIDATION_DELETION);
+            wunit.commit();
+        }
+        BSONObj targetDoc = coll->docFor(&_txn, recordIds[targetDocIndex]).value();
+        ASSERT(!targetDoc.isEmpty());
+        remove(targetDoc);
+        deleteStage.restoreState();
+
+        size_t works = 1;
+        while (!deleteStage.isEOF()) {
+            id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+            ++works;
+        }
+
+        ASSERT_EQUALS(numObj() - 1, stats->docsDeleted);
+        ASSERT_LESS_THAN(works, numObj() / 2);
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -314,6 +386,7 @@ public:
     void setupTests() {
         // Stage-specific tests below.
         add<QueryStageDeleteInvalidateUpcomingObject>();
+        add<QueryStageDeleteBatchesMultiDelete>();
         add<QueryStageDeleteReturnOldDoc>();
         add<QueryStageDeleteSkipOwnedObjects>();
     }
@@ -50,9 +50,11 @@
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageUpdate {
 
@@ -287,11 +289,16 @@ public:
             collScanParams.direction = CollectionScanParams::FORWARD;
             collScanParams.tailable = false;
 
-            // Configure the update.
+            // Configure the update. Update one document per call to work() so that we can stop
+            // just before the target document.
             UpdateStageParams updateParams(&request, &driver, opDebug);
             unique_ptr<CanonicalQuery> cq(canonicalize(query));
             updateParams.canonicalQuery = cq.get();
 
+            const int oldBatchSize = internalQueryExecWriteBatchSize;
+            internalQueryExecWriteBatchSize = 1;
+            ON_BLOCK_EXIT([oldBatchSize] { internalQueryExecWriteBatchSize = oldBatchSize; });
+
             auto ws = make_unique<WorkingSet>();
             auto cs = make_unique<CollectionScan>(&_txn, collScanParams, ws.get(), cq->root());
 
@@ -355,6 +362,75 @@ public:
     }
 };
 
+/**
+ * Test that a multi-update updates a batch of documents per call to work().
+ */
+class QueryStageUpdateBatchesMultiUpdate : public QueryStageUpdateBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, nss.ns());
+
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("_id" << i << "foo" << i));
+        }
+
+        CurOp& curOp = *CurOp::get(_txn);
+        OpDebug* opDebug = &curOp.debug();
+        UpdateDriver driver((UpdateDriver::Options()));
+        Collection* coll = ctx.getCollection();
+
+        UpdateRequest request(nss);
+        UpdateLifecycleImpl updateLifecycle(nss);
+        request.setLifecycle(&updateLifecycle);
+
+        BSONObj query = fromjson("{foo: {$lt: 6}}");
+        BSONObj updates = fromjson("{$inc: {foo: 100}}");
+
+        request.setMulti();
+        request.setQuery(query);
+        request.setUpdates(updates);
+
+        ASSERT_OK(driver.parse(request.getUpdates(), request.isMulti()));
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        UpdateStageParams updateParams(&request, &driver, opDebug);
+        unique_ptr<CanonicalQuery> cq(canonicalize(query));
+        updateParams.canonicalQuery = cq.get();
+
+        const int oldBatchSize = internalQueryExecWriteBatchSize;
+        internalQueryExecWriteBatchSize = 4;
+        ON_BLOCK_EXIT([oldBatchSize] { internalQueryExecWriteBatchSize = oldBatchSize; });
+
+        auto ws = make_unique<WorkingSet>();
+        auto cs = make_unique<CollectionScan>(&_txn, collScanParams, ws.get(), cq->root());
+        auto updateStage =
+            make_unique<UpdateStage>(&_txn, updateParams, ws.get(), coll, cs.release());
+
+        const UpdateStats* stats =
+            static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        ASSERT_EQUALS(PlanStage::NEED_TIME, updateStage->work(&id));
+        ASSERT_EQUALS(4U, stats->nMatched);
+        ASSERT_EQUALS(4U, stats->nModified);
+
+        runUpdate(updateStage.get());
+        ASSERT_EQUALS(6U, stats->nMatched);
+        ASSERT_EQUALS(6U, stats->nModified);
+
+        vector<BSONObj> objs;
+        getCollContents(coll, &objs);
+        ASSERT_EQUALS(10U, objs.size());
+        assertHasDoc(objs, fromjson("{_id: 0, foo: 100}"));
+        assertHasDoc(objs, fromjson("{_id: 5, foo: 105}"));
+        assertHasDoc(objs, fromjson("{_id: 6, foo: 6}"));
+    }
+};
+
 /**
  * Test that the update stage returns an owned copy of the original document if
  * ReturnDocOption::RETURN_OLD is specified.
@@ -600,6 +676,7 @@ public:
         // Stage-specific tests below.
         add<QueryStageUpdateUpsertEmptyColl>();
         add<QueryStageUpdateSkipInvalidatedDoc>();
+        add<QueryStageUpdateBatchesMultiUpdate>();
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
         add<QueryStageUpdateSkipOwnedObjects>();
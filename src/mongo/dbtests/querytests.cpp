@@ -1726,6 +1726,50 @@ public:
     }
 };
 
+/**
+ * Check that many cursors on one collection, which are spread over the cursor manager's partitions,
+ * can each be found and killed.
+ */
+class ManyCursorsOnOneCollection : public CollectionBase {
+public:
+    ManyCursorsOnOneCollection() : CollectionBase("manycursorsononecollection") {}
+    void run() {
+        _client.insert(ns(), vector<BSONObj>(3, BSONObj()));
+
+        const size_t numCursors = 40;
+        std::set<long long> cursorIds;
+        vector<unique_ptr<DBClientCursor>> cursors;
+        for (size_t i = 0; i < numCursors; ++i) {
+            cursors.push_back(_client.query(ns(), BSONObj(), 0, 0, 0, 0, 2));
+            ASSERT_NOT_EQUALS(0, cursors.back()->getCursorId());
+            cursorIds.insert(cursors.back()->getCursorId());
+        }
+        ASSERT_EQUALS(numCursors, cursorIds.size());
+        ASSERT_EQUALS(numCursors, numCursorsOpen());
+
+        {
+            AutoGetCollectionForRead ctx(&_txn, ns());
+            CursorManager* cursorManager = ctx.getCollection()->getCursorManager();
+            std::set<CursorId> openCursors;
+            cursorManager->getCursorIds(&openCursors);
+            ASSERT_EQUALS(numCursors, openCursors.size());
+            for (auto cursorId : cursorIds) {
+                ASSERT(cursorManager->ownsCursorId(cursorId));
+                ASSERT(cursorManager->find(cursorId, false));
+            }
+        }
+
+        for (auto cursorId : cursorIds) {
+            ASSERT(CursorManager::eraseCursorGlobal(&_txn, cursorId));
+        }
+        ASSERT_EQUALS(0U, numCursorsOpen());
+
+        for (auto&& cursor : cursors) {
+            cursor->decouple();
+        }
+    }
+};
+
 namespace queryobjecttests {
 class names1 {
 public:
@@ -1821,6 +1865,7 @@ public:
         add<QueryCursorTimeout>();
         add<QueryReadsAll>();
         add<KillPinnedCursor>();
+        add<ManyCursorsOnOneCollection>();
 
         add<queryobjecttests::names1>();
 
@@ -40,8 +40,13 @@
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
+// Every SpecificPool has its own mutex, so that requests for different hosts
+// don't contend with each other. The parent's mutex only protects the map of
+// pools, and may be held while acquiring a SpecificPool's mutex, but never the
+// other way around.
+//
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -50,6 +55,26 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+
+/**
+ * Acquires 'mutex', counting the acquisitions which had to wait for another thread in
+ * 'contentions'. The counters are protected by 'mutex' itself.
+ */
+stdx::unique_lock<stdx::mutex> lockAndCount(stdx::mutex& mutex,
+                                            size_t* acquisitions,
+                                            size_t* contentions) {
+    stdx::unique_lock<stdx::mutex> lk(mutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        lk.lock();
+        ++*contentions;
+    }
+    ++*acquisitions;
+    return lk;
+}
+
+}  // namespace
+
 /**
  * A pool for a specific HostAndPort
  *
@@ -63,8 +88,21 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Acquires this pool's mutex, which protects all of its state.
+     */
+    stdx::unique_lock<stdx::mutex> lock();
+
+    /**
+     * Returns true once the pool has been removed from its parent. Such a pool
+     * must not be used for new requests.
+     */
+    bool isShutDown(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _shutDown;
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on this
+     * pool's _mutex to preserve it
      */
     void getConnection(const HostAndPort& hostAndPort,
                        Milliseconds timeout,
@@ -79,8 +117,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on this
+     * pool's _mutex to preserve it
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -99,6 +137,13 @@ public:
      */
     size_t createdConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the number of times this pool's mutex was acquired, and how many of those had to
+     * wait for another thread.
+     */
+    size_t lockAcquisitions(const stdx::unique_lock<stdx::mutex>& lk);
+    size_t lockContentions(const stdx::unique_lock<stdx::mutex>& lk);
+
 private:
     using OwnedConnection = std::unique_ptr<ConnectionInterface>;
     using OwnershipPool = std::unordered_map<ConnectionInterface*, OwnedConnection>;
@@ -127,6 +172,10 @@ private:
 
     const HostAndPort _hostAndPort;
 
+    stdx::mutex _mutex;
+    size_t _lockAcquisitions;
+    size_t _lockContentions;
+
     OwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -141,6 +190,9 @@ private:
 
     size_t _created;
 
+    // Set when the pool is removed from the parent's map in shutdown()
+    bool _shutDown;
+
     /**
      * The current state of the pool
      *
@@ -180,76 +232,108 @@ ConnectionPool::ConnectionPool(std::unique_ptr<DependentTypeFactoryInterface> im
 ConnectionPool::~ConnectionPool() = default;
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    std::shared_ptr<SpecificPool> pool;
+    {
+        auto mapLk = _lockPools();
 
-    auto iter = _pools.find(hostAndPort);
+        auto iter = _pools.find(hostAndPort);
 
-    if (iter == _pools.end())
+        if (iter == _pools.end())
+            return;
+
+        pool = iter->second;
+    }
+
+    auto lk = pool->lock();
+
+    // The pool went away while we weren't holding any lock, so there is nothing to drop
+    if (pool->isShutDown(lk))
         return;
 
-    iter->second.get()->processFailure(
-        Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"), std::move(lk));
+    pool->processFailure(Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
+                         std::move(lk));
 }
 
 void ConnectionPool::get(const HostAndPort& hostAndPort,
                          Milliseconds timeout,
                          GetConnectionCallback cb) {
-    SpecificPool* pool;
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        std::shared_ptr<SpecificPool> pool;
+        {
+            auto mapLk = _lockPools();
+
+            auto& slot = _pools[hostAndPort];
+            if (!slot) {
+                slot = std::make_shared<SpecificPool>(this, hostAndPort);
+            }
+            pool = slot;
+        }
 
-    auto iter = _pools.find(hostAndPort);
+        invariant(pool);
 
-    if (iter == _pools.end()) {
-        auto handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
-        pool = handle.get();
-        _pools[hostAndPort] = std::move(handle);
-    } else {
-        pool = iter->second.get();
-    }
+        auto lk = pool->lock();
 
-    invariant(pool);
+        // If the pool shut down between our lookup and taking its lock, look it up again, which
+        // creates a new one
+        if (pool->isShutDown(lk))
+            continue;
 
-    pool->getConnection(hostAndPort, timeout, std::move(lk), std::move(cb));
+        pool->getConnection(hostAndPort, timeout, std::move(lk), std::move(cb));
+        return;
+    }
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto mapLk = _lockPools();
 
     for (const auto& kv : _pools) {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
+        auto lk = pool->lock();
         ConnectionStatsPerHost hostStats{pool->inUseConnections(lk),
                                          pool->availableConnections(lk),
                                          pool->createdConnections(lk)};
+        hostStats.lockAcquisitions = pool->lockAcquisitions(lk);
+        hostStats.lockContentions = pool->lockContentions(lk);
         stats->updateStatsForHost(host, hostStats);
     }
-}
-
-void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
-    auto iter = _pools.find(conn->getHostAndPort());
+    stats->poolMapLockAcquisitions += _poolsLockAcquisitions;
+    stats->poolMapLockContentions += _poolsLockContentions;
+}
 
-    invariant(iter != _pools.end());
+stdx::unique_lock<stdx::mutex> ConnectionPool::_lockPools() const {
+    return lockAndCount(_mutex, &_poolsLockAcquisitions, &_poolsLockContentions);
+}
 
-    iter->second.get()->returnConnection(conn, std::move(lk));
+void ConnectionPool::ConnectionHandleDeleter::operator()(ConnectionInterface* connection) {
+    // Pools are only shut down once all their connections have been returned, so the pool
+    // outlives the handles of its connections
+    if (_pool && connection)
+        _pool->returnConnection(connection, _pool->lock());
 }
 
 ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort)
     : _parent(parent),
       _hostAndPort(hostAndPort),
+      _lockAcquisitions(0),
+      _lockContentions(0),
       _requestTimer(parent->_factory->makeTimer()),
       _generation(0),
       _inFulfillRequests(false),
       _created(0),
+      _shutDown(false),
       _state(State::kRunning) {}
 
 ConnectionPool::SpecificPool::~SpecificPool() {
     DESTRUCTOR_GUARD(_requestTimer->cancelTimeout();)
 }
 
+stdx::unique_lock<stdx::mutex> ConnectionPool::SpecificPool::lock() {
+    return lockAndCount(_mutex, &_lockAcquisitions, &_lockContentions);
+}
+
 size_t ConnectionPool::SpecificPool::inUseConnections(const stdx::unique_lock<stdx::mutex>& lk) {
     return _checkedOutPool.size();
 }
@@ -263,6 +347,14 @@ size_t ConnectionPool::SpecificPool::createdConnections(const stdx::unique_lock<
     return _created;
 }
 
+size_t ConnectionPool::SpecificPool::lockAcquisitions(const stdx::unique_lock<stdx::mutex>& lk) {
+    return _lockAcquisitions;
+}
+
+size_t ConnectionPool::SpecificPool::lockContentions(const stdx::unique_lock<stdx::mutex>& lk) {
+    return _lockContentions;
+}
+
 void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
                                                  Milliseconds timeout,
                                                  stdx::unique_lock<stdx::mutex> lk,
@@ -322,7 +414,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
                          [this](ConnectionInterface* connPtr, Status status) {
                              connPtr->indicateUsed();
 
-                             stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+                             auto lk = lock();
 
                              auto conn = takeFromProcessingPool(connPtr);
 
@@ -366,7 +458,7 @@ void ConnectionPool::SpecificPool::addToReady(stdx::unique_lock<stdx::mutex>& lk
     connPtr->setTimeout(_parent->_options.refreshRequirement, [this, connPtr]() {
         OwnedConnection conn;
 
-        stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+        auto lk = lock();
 
         if (!_readyPool.count(connPtr)) {
             // We've already been checked out. We don't need to refresh
@@ -477,7 +569,7 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         // pass it to the user
         connPtr->resetToUnknown();
         lk.unlock();
-        cb(ConnectionHandle(connPtr, ConnectionHandleDeleter(_parent)));
+        cb(ConnectionHandle(connPtr, ConnectionHandleDeleter(this)));
         lk.lock();
     }
 }
@@ -508,7 +600,7 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
                        [this](ConnectionInterface* connPtr, Status status) {
                            connPtr->indicateUsed();
 
-                           stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+                           auto lk = lock();
 
                            auto conn = takeFromProcessingPool(connPtr);
 
@@ -531,7 +623,9 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    // Removing the pool from the parent's map needs the map's lock, which must be taken first
+    auto mapLk = _parent->_lockPools();
+    auto lk = lock();
 
     // We're racing:
     //
@@ -565,7 +659,17 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
-    _parent->_pools.erase(_hostAndPort);
+    // Threads which looked the pool up before it was removed notice this once they get its lock
+    _shutDown = true;
+
+    auto iter = _parent->_pools.find(_hostAndPort);
+    invariant(iter != _parent->_pools.end() && iter->second.get() == this);
+    auto self = std::move(iter->second);
+    _parent->_pools.erase(iter);
+
+    // The pool may be destroyed as soon as 'self' goes away, so its mutex must not be held then
+    lk.unlock();
+    mapLk.unlock();
 }
 
 ConnectionPool::SpecificPool::OwnedConnection ConnectionPool::SpecificPool::takeFromPool(
@@ -608,7 +712,7 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
         _requestTimer->setTimeout(timeout, [this]() {
-            stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+            auto lk = lock();
 
             auto now = _parent->_factory->now();
 
@@ -121,7 +121,10 @@ public:
     void appendConnectionStats(ConnectionPoolStats* stats) const;
 
 private:
-    void returnConnection(ConnectionInterface* connection);
+    /**
+     * Acquires _mutex, which only protects the map of pools.
+     */
+    stdx::unique_lock<stdx::mutex> _lockPools() const;
 
     // Options are set at startup and never changed at run time, so these are
     // accessed outside the lock
@@ -129,23 +132,26 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Protects the map of specific pools. Each SpecificPool has its own mutex for its
+    // connections and requests, so the map is only locked to find, add or remove a pool.
     mutable stdx::mutex _mutex;
-    std::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
+    std::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
+
+    // Number of times _mutex was acquired, and how many of those had to wait for another thread
+    mutable size_t _poolsLockAcquisitions = 0;
+    mutable size_t _poolsLockContentions = 0;
 };
 
 class ConnectionPool::ConnectionHandleDeleter {
 public:
     ConnectionHandleDeleter() = default;
-    ConnectionHandleDeleter(ConnectionPool* pool) : _pool(pool) {}
+    ConnectionHandleDeleter(SpecificPool* pool) : _pool(pool) {}
 
-    void operator()(ConnectionInterface* connection) {
-        if (_pool && connection)
-            _pool->returnConnection(connection);
-    }
+    void operator()(ConnectionInterface* connection);
 
 private:
-    ConnectionPool* _pool = nullptr;
+    // Connections go straight back to the pool for their host, without a lookup in the parent
+    SpecificPool* _pool = nullptr;
 };
 
 /**
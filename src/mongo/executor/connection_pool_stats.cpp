@@ -45,6 +45,8 @@ ConnectionStatsPerHost& ConnectionStatsPerHost::operator+=(const ConnectionStats
     inUse += other.inUse;
     available += other.available;
     created += other.created;
+    lockAcquisitions += other.lockAcquisitions;
+    lockContentions += other.lockContentions;
 
     return *this;
 }
@@ -53,18 +55,22 @@ void ConnectionPoolStats::updateStatsForHost(HostAndPort host, ConnectionStatsPe
     // Update stats for this host.
     auto hostStats = mapFindWithDefault(statsByHost, host);
     hostStats += newStats;
-    statsByHost.insert(std::make_pair(host, hostStats));
+    statsByHost[host] = hostStats;
 
     // Update total connection stats.
     totalInUse += newStats.inUse;
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
+    totalLockContentions += newStats.lockContentions;
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalInUse", totalInUse);
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
+    result.appendNumber("totalLockContentions", totalLockContentions);
+    result.appendNumber("poolMapLockAcquisitions", poolMapLockAcquisitions);
+    result.appendNumber("poolMapLockContentions", poolMapLockContentions);
 
     BSONObjBuilder hostBuilder(result.subobjStart("hosts"));
     for (auto&& host : statsByHost) {
@@ -74,6 +80,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
         hostInfo.appendNumber("inUse", hostStats.inUse);
         hostInfo.appendNumber("available", hostStats.available);
         hostInfo.appendNumber("created", hostStats.created);
+        hostInfo.appendNumber("lockAcquisitions", hostStats.lockAcquisitions);
+        hostInfo.appendNumber("lockContentions", hostStats.lockContentions);
     }
 }
 
@@ -49,6 +49,10 @@ struct ConnectionStatsPerHost {
     size_t inUse = 0u;
     size_t available = 0u;
     size_t created = 0u;
+
+    // Number of times the pool's lock for this host was taken, and how many of those had to wait
+    size_t lockAcquisitions = 0u;
+    size_t lockContentions = 0u;
 };
 
 /**
@@ -64,6 +68,11 @@ struct ConnectionPoolStats {
     size_t totalInUse = 0u;
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
+    size_t totalLockContentions = 0u;
+
+    // Acquisitions and contentions of the locks which protect the pools' maps of hosts
+    size_t poolMapLockAcquisitions = 0u;
+    size_t poolMapLockContentions = 0u;
 
     std::unordered_map<HostAndPort, ConnectionStatsPerHost> statsByHost;
 };
@@ -30,6 +30,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -735,6 +736,41 @@ TEST_F(ConnectionPoolTest, hostTimeoutHappensCheckoutDelays) {
     ASSERT(reachedB);
 }
 
+/**
+ * Verify that returning a connection only locks the pool for its host, and
+ * that the lock acquisitions are reported in the stats
+ */
+TEST_F(ConnectionPoolTest, returnConnectionDoesNotLockPoolMap) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>());
+
+    ConnectionPool::ConnectionHandle handle;
+    ConnectionImpl::pushSetup(Status::OK());
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 handle = std::move(swConn.getValue());
+             });
+    ASSERT(handle);
+
+    ConnectionPoolStats before;
+    pool.appendConnectionStats(&before);
+    ASSERT_EQ(1u, before.statsByHost[HostAndPort()].inUse);
+
+    doneWith(handle);
+    handle.reset();
+
+    ConnectionPoolStats after;
+    pool.appendConnectionStats(&after);
+    ASSERT_EQ(0u, after.statsByHost[HostAndPort()].inUse);
+    ASSERT_EQ(1u, after.statsByHost[HostAndPort()].available);
+
+    // Only the second appendConnectionStats() call locked the map of pools
+    ASSERT_EQ(before.poolMapLockAcquisitions + 1, after.poolMapLockAcquisitions);
+    ASSERT_GT(after.statsByHost[HostAndPort()].lockAcquisitions,
+              before.statsByHost[HostAndPort()].lockAcquisitions + 1);
+}
+
 /**
  * Verify that drop connections works
  */
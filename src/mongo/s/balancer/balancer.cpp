@@ -32,16 +32,20 @@
 
 #include "mongo/s/balancer/balancer.h"
 
+#include <algorithm>
 #include <string>
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/client.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/executor/task_executor_pool.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/balancer/balancer_chunk_selection_policy_impl.h"
 #include "mongo/s/balancer/balancer_configuration.h"
 #include "mongo/s/balancer/cluster_statistics_impl.h"
@@ -61,10 +65,14 @@
 
 namespace mongo {
 
+using executor::RemoteCommandRequest;
+using executor::RemoteCommandResponse;
 using std::map;
 using std::string;
 using std::vector;
 
+using RemoteCommandCallbackArgs = executor::TaskExecutor::RemoteCommandCallbackArgs;
+
 namespace {
 
 const Seconds kBalanceRoundDefaultInterval(10);
@@ -165,28 +173,21 @@ void appendOperationDeadlineIfSet(OperationContext* txn, BSONObjBuilder* cmdBuil
 }
 
 /**
- * Blocking method, which requests a single chunk migration to run.
+ * Builds the moveChunk command, which asks the donor shard of the specified migration to move the
+ * chunk.
  */
-Status executeSingleMigration(OperationContext* txn,
+BSONObj buildMoveChunkCommand(OperationContext* txn,
+                              ChunkManager* cm,
                               const MigrateInfo& migrateInfo,
                               uint64_t maxChunkSizeBytes,
                               const MigrationSecondaryThrottleOptions& secondaryThrottle,
                               bool waitForDelete) {
-    const NamespaceString nss(migrateInfo.ns);
-
-    auto scopedCMStatus = ScopedChunkManager::getExisting(txn, nss);
-    if (!scopedCMStatus.isOK()) {
-        return scopedCMStatus.getStatus();
-    }
-
-    ChunkManager* const cm = scopedCMStatus.getValue().cm();
-
     auto c = cm->findIntersectingChunk(txn, migrateInfo.minKey);
 
     BSONObjBuilder builder;
     MoveChunkRequest::appendAsCommand(
         &builder,
-        nss,
+        NamespaceString(migrateInfo.ns),
         cm->getVersion(),
         Grid::get(txn)->shardRegistry()->getConfigServerConnectionString(),
         migrateInfo.from,
@@ -199,7 +200,46 @@ Status executeSingleMigration(OperationContext* txn,
 
     appendOperationDeadlineIfSet(txn, &builder);
 
-    BSONObj cmdObj = builder.obj();
+    return builder.obj();
+}
+
+/**
+ * Returns the status of a migration, given the donor shard's response to the moveChunk command.
+ */
+Status getMoveChunkStatus(const BSONObj& cmdResponse) {
+    Status status = getStatusFromCommandResult(cmdResponse);
+
+    // For backwards compatibility with 3.2 and earlier, where the move chunk command instead of
+    // returning a ChunkTooBig status includes an extra field in the response
+    bool chunkTooBig = false;
+    bsonExtractBooleanFieldWithDefault(cmdResponse, kChunkTooBig, false, &chunkTooBig);
+    if (chunkTooBig) {
+        invariant(!status.isOK());
+        status = {ErrorCodes::ChunkTooBig, status.reason()};
+    }
+
+    return status;
+}
+
+/**
+ * Blocking method, which requests a single chunk migration to run.
+ */
+Status executeSingleMigration(OperationContext* txn,
+                              const MigrateInfo& migrateInfo,
+                              uint64_t maxChunkSizeBytes,
+                              const MigrationSecondaryThrottleOptions& secondaryThrottle,
+                              bool waitForDelete) {
+    const NamespaceString nss(migrateInfo.ns);
+
+    auto scopedCMStatus = ScopedChunkManager::getExisting(txn, nss);
+    if (!scopedCMStatus.isOK()) {
+        return scopedCMStatus.getStatus();
+    }
+
+    ChunkManager* const cm = scopedCMStatus.getValue().cm();
+
+    const BSONObj cmdObj = buildMoveChunkCommand(
+        txn, cm, migrateInfo, maxChunkSizeBytes, secondaryThrottle, waitForDelete);
 
     Status status{ErrorCodes::NotYetInitialized, "Uninitialized"};
 
@@ -218,17 +258,7 @@ Status executeSingleMigration(OperationContext* txn,
         if (!cmdStatus.isOK()) {
             status = std::move(cmdStatus.getStatus());
         } else {
-            status = std::move(cmdStatus.getValue().commandStatus);
-            BSONObj cmdResponse = std::move(cmdStatus.getValue().response);
-
-            // For backwards compatibility with 3.2 and earlier, where the move chunk command
-            // instead of returning a ChunkTooBig status includes an extra field in the response
-            bool chunkTooBig = false;
-            bsonExtractBooleanFieldWithDefault(cmdResponse, kChunkTooBig, false, &chunkTooBig);
-            if (chunkTooBig) {
-                invariant(!status.isOK());
-                status = {ErrorCodes::ChunkTooBig, status.reason()};
-            }
+            status = getMoveChunkStatus(cmdStatus.getValue().response);
         }
     }
 
@@ -292,6 +322,11 @@ void Balancer::stopThread() {
     if (_state == kRunning) {
         _state = kStopping;
         _condVar.notify_all();
+
+        // Do not wait for the migrations in flight to complete
+        for (const auto& cbHandle : _migrationCallbacks) {
+            grid.getExecutorPool()->getFixedExecutor()->cancel(cbHandle);
+        }
     }
 }
 
@@ -632,64 +667,189 @@ int Balancer::_moveChunks(OperationContext* txn,
                           const BalancerChunkSelectionPolicy::MigrateInfoVector& candidateChunks,
                           const MigrationSecondaryThrottleOptions& secondaryThrottle,
                           bool waitForDelete) {
-    int movedCount = 0;
+    auto shardingContext = Grid::get(txn);
+    auto balancerConfig = shardingContext->getBalancerConfiguration();
+    auto executor = shardingContext->getExecutorPool()->getFixedExecutor();
+
+    // The shard statistics are only used for throttling, so proceed without them if they cannot
+    // be retrieved
+    ShardStatisticsVector shardStats;
+    if (balancerConfig->getMaxQueuedOperationsPerShard()) {
+        auto shardStatsStatus = _clusterStats->getStats(txn);
+        if (shardStatsStatus.isOK()) {
+            shardStats = std::move(shardStatsStatus.getValue());
+        } else {
+            warning() << "Unable to obtain shard statistics for throttling migrations"
+                      << causedBy(shardStatsStatus.getStatus());
+        }
+    }
 
-    for (const auto& migrateInfo : candidateChunks) {
-        auto balancerConfig = Grid::get(txn)->getBalancerConfiguration();
+    BalancerChunkSelectionPolicy::MigrateInfoVector pendingChunks(candidateChunks);
+
+    int movedCount = 0;
 
+    while (!pendingChunks.empty()) {
         // If the balancer was disabled since we started this round, don't start new chunk moves
         if (_stopRequested() || !balancerConfig->shouldBalance()) {
             LOG(1) << "Stopping balancing round early as balancing was disabled";
             return movedCount;
         }
 
-        // Changes to metadata, borked metadata, and connectivity problems between shards
-        // should cause us to abort this chunk move, but shouldn't cause us to abort the entire
-        // round of chunks.
-        //
-        // TODO(spencer): We probably *should* abort the whole round on issues communicating
-        // with the config servers, but its impossible to distinguish those types of failures
-        // at the moment.
-        //
-        // TODO: Handle all these things more cleanly, since they're expected problems
+        const auto migrations = BalancerPolicy::selectConcurrentMigrations(
+            &pendingChunks,
+            shardStats,
+            balancerConfig->getMaxConcurrentMigrations(),
+            balancerConfig->getMaxQueuedOperationsPerShard());
+        if (migrations.empty()) {
+            break;
+        }
 
-        const NamespaceString nss(migrateInfo.ns);
+        LOG(1) << "Starting " << migrations.size() << " migrations";
+
+        // The moveChunk commands of all the selected migrations are sent before waiting for any of
+        // them, since each blocks until its migration completes. They are registered under the
+        // balancer mutex, so that stopThread either cancels them or they are never sent.
+        std::vector<Status> migrationStatuses(migrations.size(), Status::OK());
+        std::vector<StatusWith<RemoteCommandResponse>> responses(
+            migrations.size(), Status(ErrorCodes::InternalError, "Internal error running command"));
+        std::vector<std::shared_ptr<Shard>> donorShards(migrations.size());
+        std::vector<HostAndPort> donorHosts(migrations.size());
+        std::vector<BSONObj> cmdObjs(migrations.size());
+
+        for (size_t i = 0; i < migrations.size(); i++) {
+            const MigrateInfo& migrateInfo = migrations[i];
+
+            auto scopedCMStatus =
+                ScopedChunkManager::getExisting(txn, NamespaceString(migrateInfo.ns));
+            if (!scopedCMStatus.isOK()) {
+                migrationStatuses[i] = scopedCMStatus.getStatus();
+                continue;
+            }
 
-        try {
-            Status status = executeSingleMigration(txn,
-                                                   migrateInfo,
-                                                   balancerConfig->getMaxChunkSizeBytes(),
-                                                   balancerConfig->getSecondaryThrottle(),
-                                                   balancerConfig->waitForDelete());
-            if (status.isOK()) {
-                movedCount++;
-            } else if (status == ErrorCodes::ChunkTooBig) {
-                log() << "Performing a split because migrate failed for size reasons"
-                      << causedBy(status);
+            cmdObjs[i] = buildMoveChunkCommand(txn,
+                                               scopedCMStatus.getValue().cm(),
+                                               migrateInfo,
+                                               balancerConfig->getMaxChunkSizeBytes(),
+                                               secondaryThrottle,
+                                               waitForDelete);
+
+            donorShards[i] = shardingContext->shardRegistry()->getShard(txn, migrateInfo.from);
+            if (!donorShards[i]) {
+                migrationStatuses[i] = {ErrorCodes::ShardNotFound,
+                                        str::stream() << "shard " << migrateInfo.from
+                                                      << " not found"};
+                continue;
+            }
+
+            auto hostStatus = donorShards[i]->getTargeter()->findHost(
+                ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                RemoteCommandTargeter::selectFindHostMaxWaitTime(txn));
+            if (!hostStatus.isOK()) {
+                migrationStatuses[i] = hostStatus.getStatus();
+                continue;
+            }
 
-                auto scopedCM = uassertStatusOK(ScopedChunkManager::getExisting(txn, nss));
-                ChunkManager* const cm = scopedCM.cm();
+            donorHosts[i] = std::move(hostStatus.getValue());
 
-                auto c = cm->findIntersectingChunk(txn, migrateInfo.minKey);
+            auto& response = responses[i];
 
-                auto splitStatus = c->split(txn, Chunk::normal, nullptr);
-                if (!splitStatus.isOK()) {
-                    log() << "Marking chunk " << c->toString() << " as jumbo.";
+            stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
+            if (_state != kRunning) {
+                migrationStatuses[i] = {ErrorCodes::Interrupted, "balancer is being stopped"};
+                continue;
+            }
+
+            auto callStatus = executor->scheduleRemoteCommand(
+                RemoteCommandRequest(donorHosts[i], "admin", cmdObjs[i]),
+                [&response](const RemoteCommandCallbackArgs& args) { response = args.response; });
+            if (!callStatus.isOK()) {
+                migrationStatuses[i] = callStatus.getStatus();
+                continue;
+            }
+
+            _migrationCallbacks.push_back(std::move(callStatus.getValue()));
+        }
+
+        for (const auto& cbHandle : _migrationCallbacks) {
+            executor->wait(cbHandle);
+        }
 
-                    c->markAsJumbo(txn);
+        {
+            stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
+            _migrationCallbacks.clear();
+        }
 
-                    // We increment moveCount so we do another round right away
-                    movedCount++;
+        for (size_t i = 0; i < migrations.size(); i++) {
+            Status& status = migrationStatuses[i];
+            if (status.isOK()) {
+                const auto& response = responses[i];
+                if (!response.isOK()) {
+                    status = response.getStatus();
+                } else {
+                    status = getMoveChunkStatus(response.getValue().data);
                 }
-            } else {
-                log() << "Balancer move failed" << causedBy(status);
+
+                donorShards[i]->updateReplSetMonitor(donorHosts[i], status);
+            }
+
+            if (!status.isOK()) {
+                log() << "Move chunk " << cmdObjs[i] << " failed" << causedBy(status);
+            }
+
+            if (_processMigrationResult(txn, migrations[i], status)) {
+                movedCount++;
             }
-        } catch (const DBException& ex) {
-            log() << "balancer move " << migrateInfo << " failed" << causedBy(ex);
         }
     }
 
     return movedCount;
 }
 
+bool Balancer::_processMigrationResult(OperationContext* txn,
+                                       const MigrateInfo& migrateInfo,
+                                       const Status& migrationStatus) {
+    // Changes to metadata, borked metadata, and connectivity problems between shards should cause
+    // us to abort this chunk move, but shouldn't cause us to abort the entire round of chunks.
+    //
+    // TODO(spencer): We probably *should* abort the whole round on issues communicating with the
+    // config servers, but its impossible to distinguish those types of failures at the moment.
+    //
+    // TODO: Handle all these things more cleanly, since they're expected problems
+
+    const NamespaceString nss(migrateInfo.ns);
+
+    try {
+        if (migrationStatus.isOK()) {
+            auto scopedCM = uassertStatusOK(ScopedChunkManager::getExisting(txn, nss));
+            scopedCM.cm()->reload(txn);
+
+            return true;
+        } else if (migrationStatus == ErrorCodes::ChunkTooBig) {
+            log() << "Performing a split because migrate failed for size reasons"
+                  << causedBy(migrationStatus);
+
+            auto scopedCM = uassertStatusOK(ScopedChunkManager::getExisting(txn, nss));
+            ChunkManager* const cm = scopedCM.cm();
+
+            auto c = cm->findIntersectingChunk(txn, migrateInfo.minKey);
+
+            auto splitStatus = c->split(txn, cm, Chunk::normal, nullptr);
+            if (!splitStatus.isOK()) {
+                log() << "Marking chunk " << c->toString() << " as jumbo.";
+
+                c->markAsJumbo(txn, migrateInfo.ns);
+
+                // We increment moveCount so we do another round right away
+                return true;
+            }
+        } else {
+            log() << "Balancer move failed" << causedBy(migrationStatus);
+        }
+    } catch (const DBException& ex) {
+        log() << "balancer move " << migrateInfo << " failed" << causedBy(ex);
+    }
+
+    return false;
+}
+
 }  // namespace mongo
@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/executor/task_executor.h"
 #include "mongo/s/balancer/balancer_chunk_selection_policy.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -51,7 +54,8 @@ class Status;
  *
  * The balancer does act continuously but in "rounds". At a given round, it would decide if
  * there is an imbalance by checking the difference in chunks between the most and least
- * loaded shards. It would issue a request for a chunk migration per round, if it found so.
+ * loaded shards. It would issue requests for chunk migrations, if it found so, running those which
+ * do not involve the same shards or collections concurrently.
  */
 class Balancer {
     MONGO_DISALLOW_COPYING(Balancer);
@@ -85,7 +89,8 @@ public:
     /**
      * If the main balancer thread is running, requests it to stop and returns immediately without
      * waiting for it to terminate. The join method must be called afterwards in order to wait for
-     * the thread to complete.
+     * the thread to complete. The moveChunk commands of the current balancer round are cancelled,
+     * so the thread does not wait for their migrations to finish.
      */
     void stopThread();
 
@@ -174,7 +179,10 @@ private:
     Status _enforceTagRanges(OperationContext* txn);
 
     /**
-     * Issues chunk migration request, one at a time.
+     * Issues chunk migration requests. Migrations which do not share a shard run concurrently,
+     * bounded by the balancer's maxConcurrentMigrations setting, and those with higher priority are
+     * started first. The moveChunk commands are sent on behalf of the balancer's operation context
+     * and the balancer thread waits for them, so they can be cancelled by stopThread.
      *
      * @param candidateChunks possible chunks to move
      * @param writeConcern detailed write concern. NULL means the default write concern.
@@ -186,6 +194,15 @@ private:
                     const MigrationSecondaryThrottleOptions& secondaryThrottle,
                     bool waitForDelete);
 
+    /**
+     * Handles the outcome of a single chunk migration and, if the chunk is too big to be moved,
+     * tries to split it or marks it as jumbo. Returns whether another balancer round should follow
+     * right away.
+     */
+    bool _processMigrationResult(OperationContext* txn,
+                                 const MigrateInfo& migrateInfo,
+                                 const Status& migrationStatus);
+
     // The main balancer thread
     stdx::thread _thread;
 
@@ -201,6 +218,9 @@ private:
     // Counts the number of balancing rounds performed since the balancer thread was first activated
     int64_t _numBalancerRounds{0};
 
+    // The moveChunk commands of the current balancer round, which are in flight
+    std::vector<executor::TaskExecutor::CallbackHandle> _migrationCallbacks;
+
     // Condition variable, which is signalled every time the above runtime state of the balancer
     // changes (in particular, state/balancer round and number of balancer rounds).
     stdx::condition_variable _condVar;
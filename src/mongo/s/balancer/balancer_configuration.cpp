@@ -51,6 +51,8 @@ const char kStopped[] = "stopped";
 const char kMode[] = "mode";
 const char kActiveWindow[] = "activeWindow";
 const char kWaitForDelete[] = "_waitForDelete";
+const char kMaxConcurrentMigrations[] = "maxConcurrentMigrations";
+const char kMaxQueuedOperationsPerShard[] = "maxQueuedOperationsPerShard";
 
 const NamespaceString kSettingsNamespace("config", "settings");
 
@@ -58,6 +60,7 @@ const NamespaceString kSettingsNamespace("config", "settings");
 
 const char BalancerSettingsType::kKey[] = "balancer";
 const char* BalancerSettingsType::kBalancerModes[] = {"full", "autoSplitOnly", "off"};
+const int BalancerSettingsType::kDefaultMaxConcurrentMigrations{8};
 
 const char ChunkSizeSettingsType::kKey[] = "chunksize";
 const uint64_t ChunkSizeSettingsType::kDefaultMaxChunkSizeBytes{64 * 1024 * 1024};
@@ -127,6 +130,16 @@ bool BalancerConfiguration::waitForDelete() const {
     return _balancerSettings.waitForDelete();
 }
 
+int BalancerConfiguration::getMaxConcurrentMigrations() const {
+    stdx::lock_guard<stdx::mutex> lk(_balancerSettingsMutex);
+    return _balancerSettings.getMaxConcurrentMigrations();
+}
+
+long long BalancerConfiguration::getMaxQueuedOperationsPerShard() const {
+    stdx::lock_guard<stdx::mutex> lk(_balancerSettingsMutex);
+    return _balancerSettings.getMaxQueuedOperationsPerShard();
+}
+
 Status BalancerConfiguration::refreshAndCheck(OperationContext* txn) {
     // Balancer configuration
     Status balancerSettingsStatus = _refreshBalancerSettings(txn);
@@ -289,6 +302,39 @@ StatusWith<BalancerSettingsType> BalancerSettingsType::fromBSON(const BSONObj& o
         settings._waitForDelete = waitForDelete;
     }
 
+    {
+        long long maxConcurrentMigrations;
+        Status status = bsonExtractIntegerFieldWithDefault(obj,
+                                                           kMaxConcurrentMigrations,
+                                                           kDefaultMaxConcurrentMigrations,
+                                                           &maxConcurrentMigrations);
+        if (!status.isOK())
+            return status;
+
+        if (maxConcurrentMigrations < 1 ||
+            maxConcurrentMigrations > std::numeric_limits<int>::max()) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << kMaxConcurrentMigrations << " must be at least 1");
+        }
+
+        settings._maxConcurrentMigrations = static_cast<int>(maxConcurrentMigrations);
+    }
+
+    {
+        long long maxQueuedOperationsPerShard;
+        Status status = bsonExtractIntegerFieldWithDefault(
+            obj, kMaxQueuedOperationsPerShard, 0, &maxQueuedOperationsPerShard);
+        if (!status.isOK())
+            return status;
+
+        if (maxQueuedOperationsPerShard < 0) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << kMaxQueuedOperationsPerShard << " cannot be negative");
+        }
+
+        settings._maxQueuedOperationsPerShard = maxQueuedOperationsPerShard;
+    }
+
     return settings;
 }
 
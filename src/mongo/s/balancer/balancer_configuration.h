@@ -52,7 +52,10 @@ class StatusWith;
  * balancer: {
  *  stopped: <true|false>,
  *  mode: <full|autoSplitOnly|off>,         // Only consulted if "stopped" is missing or false
- *  activeWindow: { start: "<HH:MM>", stop: "<HH:MM>" }
+ *  activeWindow: { start: "<HH:MM>", stop: "<HH:MM>" },
+ *  maxConcurrentMigrations: <number of migrations to run at the same time, at least 1>,
+ *  maxQueuedOperationsPerShard: <shards with more queued operations are not migrated to or from,
+ *                                0 means no limit>
  * }
  */
 class BalancerSettingsType {
@@ -70,6 +73,9 @@ public:
     // String representation of the balancer modes
     static const char* kBalancerModes[];
 
+    // Default limit on the number of migrations the balancer runs concurrently
+    static const int kDefaultMaxConcurrentMigrations;
+
     /**
      * Constructs a settings object with the default values. To be used when no balancer settings
      * have been specified.
@@ -107,6 +113,21 @@ public:
         return _waitForDelete;
     }
 
+    /**
+     * Returns the maximum number of migrations the balancer may run concurrently.
+     */
+    int getMaxConcurrentMigrations() const {
+        return _maxConcurrentMigrations;
+    }
+
+    /**
+     * Returns the number of queued operations above which a shard is considered too loaded to
+     * take part in migrations, or zero if migrations should not be throttled.
+     */
+    long long getMaxQueuedOperationsPerShard() const {
+        return _maxQueuedOperationsPerShard;
+    }
+
 private:
     BalancerSettingsType();
 
@@ -118,6 +139,10 @@ private:
     MigrationSecondaryThrottleOptions _secondaryThrottle;
 
     bool _waitForDelete{false};
+
+    int _maxConcurrentMigrations{kDefaultMaxConcurrentMigrations};
+
+    long long _maxQueuedOperationsPerShard{0};
 };
 
 /**
@@ -203,6 +228,12 @@ public:
      */
     bool waitForDelete() const;
 
+    /**
+     * Returns the limits used by the balancer when scheduling concurrent migrations.
+     */
+    int getMaxConcurrentMigrations() const;
+    long long getMaxQueuedOperationsPerShard() const;
+
     /**
      * Returns the max chunk size after which a chunk would be considered jumbo.
      */
@@ -288,6 +288,22 @@ TEST(BalancerSettingsType, InvalidBalancingWindowFormat) {
                       .getStatus());
 }
 
+TEST(BalancerSettingsType, ConcurrentMigrationLimits) {
+    BalancerSettingsType defaults = assertGet(BalancerSettingsType::fromBSON(BSONObj()));
+    ASSERT_EQ(BalancerSettingsType::kDefaultMaxConcurrentMigrations,
+              defaults.getMaxConcurrentMigrations());
+    ASSERT_EQ(0, defaults.getMaxQueuedOperationsPerShard());
+
+    BalancerSettingsType settings = assertGet(BalancerSettingsType::fromBSON(
+        BSON("maxConcurrentMigrations" << 3 << "maxQueuedOperationsPerShard" << 50)));
+    ASSERT_EQ(3, settings.getMaxConcurrentMigrations());
+    ASSERT_EQ(50, settings.getMaxQueuedOperationsPerShard());
+
+    ASSERT_NOT_OK(BalancerSettingsType::fromBSON(BSON("maxConcurrentMigrations" << 0)).getStatus());
+    ASSERT_NOT_OK(
+        BalancerSettingsType::fromBSON(BSON("maxQueuedOperationsPerShard" << -1)).getStatus());
+}
+
 TEST(ChunkSizeSettingsType, NormalValues) {
     ASSERT_EQ(
         1024 * 1024ULL,
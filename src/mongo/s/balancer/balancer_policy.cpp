@@ -55,6 +55,8 @@ using std::set;
 using std::string;
 using std::vector;
 
+const int MigrateInfo::kMandatoryPriority = std::numeric_limits<int>::max();
+
 DistributionStatus::DistributionStatus(ShardStatisticsVector shardInfo,
                                        const ShardToChunksMap& shardToChunksMap)
     : _shardInfo(std::move(shardInfo)), _shardChunks(shardToChunksMap) {}
@@ -258,7 +260,9 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
                 log() << "going to move " << chunkToMove << " from " << stat.shardId << " (" << tag
                       << ") to " << to;
 
-                return {MigrateInfo(ns, to, chunkToMove)};
+                MigrateInfo migrateInfo(ns, to, chunkToMove);
+                migrateInfo.priority = MigrateInfo::kMandatoryPriority;
+                return {migrateInfo};
             }
 
             warning() << "can't find any chunk to move from: " << stat.shardId
@@ -294,7 +298,10 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
 
                 invariant(to != stat.shardId);
                 log() << " going to move to: " << to;
-                return {MigrateInfo(ns, to, chunk)};
+
+                MigrateInfo migrateInfo(ns, to, chunk);
+                migrateInfo.priority = MigrateInfo::kMandatoryPriority;
+                return {migrateInfo};
             }
         }
     }
@@ -363,7 +370,9 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
             log() << " ns: " << ns << " going to move " << chunk << " from: " << from
                   << " to: " << to << " tag [" << tag << "]";
 
-            return {MigrateInfo(ns, to, chunk)};
+            MigrateInfo migrateInfo(ns, to, chunk);
+            migrateInfo.priority = imbalance;
+            return {migrateInfo};
         }
 
         if (numJumboChunks) {
@@ -380,6 +389,55 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
     return vector<MigrateInfo>();
 }
 
+vector<MigrateInfo> BalancerPolicy::selectConcurrentMigrations(
+    vector<MigrateInfo>* candidates,
+    const ShardStatisticsVector& shardStats,
+    size_t maxConcurrentMigrations,
+    uint64_t maxQueuedOperations) {
+    std::stable_sort(candidates->begin(),
+                     candidates->end(),
+                     [](const MigrateInfo& lhs, const MigrateInfo& rhs) {
+                         return lhs.priority > rhs.priority;
+                     });
+
+    set<ShardId> overloadedShards;
+    if (maxQueuedOperations) {
+        for (const auto& stat : shardStats) {
+            if (stat.queuedOperations > maxQueuedOperations) {
+                overloadedShards.insert(stat.shardId);
+            }
+        }
+    }
+
+    set<ShardId> usedShards;
+
+    vector<MigrateInfo> selected;
+    vector<MigrateInfo> conflicting;
+
+    for (auto& migrateInfo : *candidates) {
+        if (overloadedShards.count(migrateInfo.from) || overloadedShards.count(migrateInfo.to)) {
+            log() << "throttling migration " << migrateInfo
+                  << " because one of its shards has more than " << maxQueuedOperations
+                  << " queued operations";
+            continue;
+        }
+
+        if (selected.size() >= maxConcurrentMigrations || usedShards.count(migrateInfo.from) ||
+            usedShards.count(migrateInfo.to)) {
+            conflicting.push_back(std::move(migrateInfo));
+            continue;
+        }
+
+        usedShards.insert(migrateInfo.from);
+        usedShards.insert(migrateInfo.to);
+
+        selected.push_back(std::move(migrateInfo));
+    }
+
+    *candidates = std::move(conflicting);
+    return selected;
+}
+
 string TagRange::toString() const {
     return str::stream() << min << " -->> " << max << "  on  " << tag;
 }
@@ -53,6 +53,10 @@ struct TagRange {
 };
 
 struct MigrateInfo {
+    // Priority of migrations which must happen regardless of the chunk distribution, such as
+    // moves off draining shards or off shards which do not have the chunk's tag
+    static const int kMandatoryPriority;
+
     MigrateInfo(const std::string& a_ns, const ShardId& a_to, const ChunkType& a_chunk)
         : ns(a_ns),
           to(a_to),
@@ -67,6 +71,10 @@ struct MigrateInfo {
     ShardId from;
     BSONObj minKey;
     BSONObj maxKey;
+
+    // Migrations with higher priority are scheduled first. Mandatory migrations have the highest
+    // priority, the others are prioritized by the chunk count imbalance between their shards.
+    int priority{0};
 };
 
 typedef std::vector<ClusterStatistics::ShardStatistics> ShardStatisticsVector;
@@ -153,6 +161,25 @@ public:
     static std::vector<MigrateInfo> balance(const std::string& ns,
                                             const DistributionStatus& distribution,
                                             bool shouldAggressivelyBalance);
+
+    /**
+     * Selects from the candidate migrations the ones which can run concurrently, in decreasing
+     * order of priority. Each shard takes part in at most one of the selected migrations, since a
+     * shard can only donate or receive one chunk at a time. The candidates are expected to come
+     * from balance(), which proposes at most one migration per collection, since the migrations of
+     * a collection are serialized by its distributed lock.
+     *
+     * At most maxConcurrentMigrations are selected. If maxQueuedOperations is not zero, migrations
+     * from or to a shard with more queued operations than that are throttled.
+     *
+     * Both the selected and the throttled migrations are removed from candidates. The remaining
+     * ones conflict with a selected migration and can be scheduled once it completes.
+     */
+    static std::vector<MigrateInfo> selectConcurrentMigrations(
+        std::vector<MigrateInfo>* candidates,
+        const ShardStatisticsVector& shardStats,
+        size_t maxConcurrentMigrations,
+        uint64_t maxQueuedOperations);
 };
 
 }  // namespace mongo
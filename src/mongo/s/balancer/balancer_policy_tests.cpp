@@ -612,5 +612,78 @@ TEST(BalancerPolicyTests, Simulation) {
     }
 }
 
+MigrateInfo makeMigrateInfo(const std::string& ns,
+                            const ShardId& from,
+                            const ShardId& to,
+                            int minKey,
+                            int priority) {
+    ChunkType chunk;
+    chunk.setMin(BSON("x" << minKey));
+    chunk.setMax(BSON("x" << minKey + 1));
+    chunk.setShard(from);
+
+    MigrateInfo migrateInfo(ns, to, chunk);
+    migrateInfo.priority = priority;
+    return migrateInfo;
+}
+
+TEST(BalancerPolicyTests, ConcurrentMigrationsDoNotShareShards) {
+    const auto kShardId3 = ShardId("shard3");
+
+    vector<MigrateInfo> candidates{makeMigrateInfo("TestDB.Coll1", kShardId0, kShardId1, 0, 5),
+                                   makeMigrateInfo("TestDB.Coll2", kShardId2, kShardId3, 0, 10),
+                                   makeMigrateInfo("TestDB.Coll3", kShardId0, kShardId3, 0, 20),
+                                   makeMigrateInfo("TestDB.Coll4", kShardId1, kShardId2, 0, 1)};
+
+    // The highest priority migration takes shard0 and shard3, which leaves only the migration
+    // between shard1 and shard2
+    auto migrations =
+        BalancerPolicy::selectConcurrentMigrations(&candidates, ShardStatisticsVector(), 10, 0);
+    ASSERT_EQ(2U, migrations.size());
+    ASSERT_EQ("TestDB.Coll3", migrations[0].ns);
+    ASSERT_EQ("TestDB.Coll4", migrations[1].ns);
+    ASSERT_EQ(2U, candidates.size());
+
+    migrations =
+        BalancerPolicy::selectConcurrentMigrations(&candidates, ShardStatisticsVector(), 10, 0);
+    ASSERT_EQ(2U, migrations.size());
+    ASSERT_EQ("TestDB.Coll2", migrations[0].ns);
+    ASSERT_EQ("TestDB.Coll1", migrations[1].ns);
+    ASSERT(candidates.empty());
+}
+
+TEST(BalancerPolicyTests, ConcurrentMigrationsLimit) {
+    const auto kShardId3 = ShardId("shard3");
+
+    vector<MigrateInfo> candidates{makeMigrateInfo("TestDB.Coll1", kShardId0, kShardId1, 0, 1),
+                                   makeMigrateInfo("TestDB.Coll2", kShardId2, kShardId3, 0, 1)};
+
+    auto migrations =
+        BalancerPolicy::selectConcurrentMigrations(&candidates, ShardStatisticsVector(), 1, 0);
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ("TestDB.Coll1", migrations[0].ns);
+    ASSERT_EQ(1U, candidates.size());
+    ASSERT_EQ("TestDB.Coll2", candidates[0].ns);
+}
+
+TEST(BalancerPolicyTests, ConcurrentMigrationsThrottledByShardLoad) {
+    const auto kShardId3 = ShardId("shard3");
+
+    ShardStatisticsVector shardStats{
+        ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+        ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+        ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+        ShardStatistics(kShardId3, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion)};
+    findStat(shardStats, kShardId1).queuedOperations = 100;
+
+    vector<MigrateInfo> candidates{makeMigrateInfo("TestDB.Coll1", kShardId0, kShardId1, 0, 1),
+                                   makeMigrateInfo("TestDB.Coll2", kShardId2, kShardId3, 0, 1)};
+
+    auto migrations = BalancerPolicy::selectConcurrentMigrations(&candidates, shardStats, 10, 50);
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ("TestDB.Coll2", migrations[0].ns);
+    ASSERT(candidates.empty());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -74,6 +74,7 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("queuedOperations", static_cast<long long>(queuedOperations));
     return builder.obj();
 }
 
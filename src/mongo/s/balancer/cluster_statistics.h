@@ -93,6 +93,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Number of operations waiting for locks on this shard's primary. Used as a measure of the
+        // shard's load.
+        uint64_t queuedOperations{0};
     };
 
     virtual ~ClusterStatistics();
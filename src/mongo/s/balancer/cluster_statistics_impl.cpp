@@ -32,6 +32,8 @@
 
 #include "mongo/s/balancer/cluster_statistics_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
@@ -54,13 +56,16 @@ const char kVersionField[] = "version";
 
 /**
  * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * running MongoD service and the number of operations queued on it.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns an error if the version could not be retrieved. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
  *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<string> retrieveShardMongoDVersion(OperationContext* txn, ShardId shardId) {
+Status retrieveShardServerStatus(OperationContext* txn,
+                                 ShardId shardId,
+                                 string* mongoVersion,
+                                 uint64_t* queuedOperations) {
     auto shardRegistry = Grid::get(txn)->shardRegistry();
     auto shard = shardRegistry->getShard(txn, shardId);
     if (!shard) {
@@ -81,13 +86,27 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* txn, ShardId sha
 
     BSONObj serverStatus = std::move(commandResponse.getValue().response);
 
-    string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
+    Status status = bsonExtractStringField(serverStatus, kVersionField, mongoVersion);
     if (!status.isOK()) {
         return status;
     }
 
-    return version;
+    // The lock queue statistics are optional, since they are only used for throttling
+    *queuedOperations = 0;
+
+    BSONElement globalLockElem = serverStatus["globalLock"];
+    if (globalLockElem.isABSONObj()) {
+        BSONElement currentQueueElem = globalLockElem.Obj()["currentQueue"];
+        if (currentQueueElem.isABSONObj()) {
+            BSONElement totalElem = currentQueueElem.Obj()["total"];
+            if (totalElem.isNumber()) {
+                *queuedOperations =
+                    static_cast<uint64_t>(std::max(totalElem.safeNumberLong(), 0LL));
+            }
+        }
+    }
+
+    return Status::OK();
 }
 
 }  // namespace
@@ -132,11 +151,13 @@ void ClusterStatisticsImpl::_refreshShardStats(OperationContext* txn) {
             continue;
         }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(txn, shard.getName());
-        if (!mongoDVersionStatus.isOK()) {
+        string mongoDVersion;
+        uint64_t queuedOperations;
+        Status serverStatus =
+            retrieveShardServerStatus(txn, shard.getName(), &mongoDVersion, &queuedOperations);
+        if (!serverStatus.isOK()) {
             continue;
         }
-        const string mongoDVersion(std::move(mongoDVersionStatus.getValue()));
 
         std::set<string> shardTags;
         for (const auto& shardTag : shard.getTags()) {
@@ -149,6 +170,7 @@ void ClusterStatisticsImpl::_refreshShardStats(OperationContext* txn) {
                                      shard.getDraining(),
                                      shardTags,
                                      mongoDVersion);
+        newShardStat.queuedOperations = queuedOperations;
 
         stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
         _shardStatsMap[shard.getName()] = std::move(newShardStat);
@@ -93,7 +93,7 @@ public:
 
     pair<BSONObj, shared_ptr<Chunk>> rangeFor(OperationContext* txn,
                                               const ChunkType& chunk) const final {
-        shared_ptr<Chunk> c(new Chunk(txn, _manager, chunk));
+        shared_ptr<Chunk> c(new Chunk(txn, _manager->getns(), chunk));
         return make_pair(chunk.getMax(), c);
     }
 
@@ -197,6 +197,7 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
                 _shardIds.swap(shardIds);
                 _shardVersions.swap(shardVersions);
                 _chunkRangeMap = _constructRanges(_chunkMap);
+                _buildRoutingIndex();
                 return;
             }
         }
@@ -229,23 +230,11 @@ bool ChunkManager::_load(OperationContext* txn,
         // Load a copy of the old versions
         *shardVersions = oldManager->_shardVersions;
 
-        // Load a copy of the chunk map, replacing the chunk manager with our own
+        // Chunks do not reference their chunk manager, so the new map shares all of the old
+        // manager's Chunk objects. The diff below only replaces the chunks which changed, so a
+        // refresh allocates new Chunks only for those.
         const ChunkMap& oldChunkMap = oldManager->getChunkMap();
-
-        // Could be v.expensive
-        // TODO: If chunks were immutable and didn't reference the manager, we could do more
-        // interesting things here
-        for (const auto& oldChunkMapEntry : oldChunkMap) {
-            shared_ptr<Chunk> oldC = oldChunkMapEntry.second;
-            shared_ptr<Chunk> newC(new Chunk(this,
-                                             oldC->getMin(),
-                                             oldC->getMax(),
-                                             oldC->getShardId(),
-                                             oldC->getLastmod(),
-                                             oldC->getBytesWritten()));
-
-            chunkMap.insert(make_pair(oldC->getMax(), newC));
-        }
+        chunkMap = oldChunkMap;
 
         LOG(2) << "loading chunk manager for collection " << _ns
                << " using old chunk manager w/ version " << _version.toString() << " and "
@@ -446,29 +435,55 @@ Status ChunkManager::createFirstChunks(OperationContext* txn,
 
 shared_ptr<Chunk> ChunkManager::findIntersectingChunk(OperationContext* txn,
                                                       const BSONObj& shardKey) const {
-    {
-        BSONObj chunkMin;
-        shared_ptr<Chunk> chunk;
-        {
-            ChunkMap::const_iterator it = _chunkMap.upper_bound(shardKey);
-            if (it != _chunkMap.end()) {
-                chunkMin = it->first;
-                chunk = it->second;
-            }
+    return _checkIntersectingChunk(txn, shardKey, _upperBound(shardKey));
+}
+
+vector<shared_ptr<Chunk>> ChunkManager::findIntersectingChunks(
+    OperationContext* txn, const vector<BSONObj>& shardKeys) const {
+    vector<shared_ptr<Chunk>> chunks;
+    chunks.reserve(shardKeys.size());
+
+    if (_routingEntries.size() != _chunkMap.size()) {
+        for (const auto& shardKey : shardKeys) {
+            chunks.push_back(findIntersectingChunk(txn, shardKey));
         }
+        return chunks;
+    }
 
-        if (chunk) {
-            if (chunk->containsKey(shardKey)) {
-                return chunk;
-            }
+    const vector<size_t> positions = _routingIndex.upperBounds(shardKeys);
+    for (size_t i = 0; i < shardKeys.size(); i++) {
+        ChunkMap::const_iterator it =
+            positions[i] < _routingEntries.size() ? _routingEntries[positions[i]] : _chunkMap.end();
+        chunks.push_back(_checkIntersectingChunk(txn, shardKeys[i], it));
+    }
+
+    return chunks;
+}
 
-            log() << chunkMin;
-            log() << *chunk;
-            log() << shardKey;
+ChunkMap::const_iterator ChunkManager::_upperBound(const BSONObj& shardKey) const {
+    if (_routingEntries.size() != _chunkMap.size()) {
+        return _chunkMap.upper_bound(shardKey);
+    }
 
-            reload(txn);
-            msgasserted(13141, "Chunk map pointed to incorrect chunk");
+    const size_t pos = _routingIndex.upperBound(shardKey);
+    return pos < _routingEntries.size() ? _routingEntries[pos] : _chunkMap.end();
+}
+
+shared_ptr<Chunk> ChunkManager::_checkIntersectingChunk(OperationContext* txn,
+                                                        const BSONObj& shardKey,
+                                                        ChunkMap::const_iterator it) const {
+    if (it != _chunkMap.end()) {
+        const shared_ptr<Chunk>& chunk = it->second;
+        if (chunk->containsKey(shardKey)) {
+            return chunk;
         }
+
+        log() << it->first;
+        log() << *chunk;
+        log() << shardKey;
+
+        reload(txn);
+        msgasserted(13141, "Chunk map pointed to incorrect chunk");
     }
 
     msgasserted(8070,
@@ -480,6 +495,25 @@ shared_ptr<Chunk> ChunkManager::findIntersectingChunk(OperationContext* txn,
                               << _chunkMap.size());
 }
 
+void ChunkManager::_buildRoutingIndex() {
+    _routingIndex = ChunkRoutingIndex();
+    _routingEntries.clear();
+    _routingEntries.reserve(_chunkMap.size());
+
+    for (ChunkMap::const_iterator it = _chunkMap.begin(); it != _chunkMap.end(); ++it) {
+        if (!_routingIndex.add(it->first)) {
+            // The keys do not order the same way as encoded KeyStrings, so leave targeting to the
+            // chunk map.
+            warning() << "Not using the routing index for " << _ns << " because of chunk "
+                      << *it->second;
+            _routingIndex = ChunkRoutingIndex();
+            _routingEntries.clear();
+            return;
+        }
+        _routingEntries.push_back(it);
+    }
+}
+
 void ChunkManager::getShardIdsForQuery(OperationContext* txn,
                                        const BSONObj& query,
                                        set<ShardId>* shardIds) const {
@@ -36,6 +36,7 @@
 #include "mongo/db/repl/optime.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/chunk_routing_index.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -125,6 +126,13 @@ public:
     std::shared_ptr<Chunk> findIntersectingChunk(OperationContext* txn,
                                                  const BSONObj& shardKey) const;
 
+    /**
+     * Same as findIntersectingChunk for a batch of shard keys, such as those of the documents of
+     * an insert batch. The chunks are returned in the same order as 'shardKeys'.
+     */
+    std::vector<std::shared_ptr<Chunk>> findIntersectingChunks(
+        OperationContext* txn, const std::vector<BSONObj>& shardKeys) const;
+
     void getShardIdsForQuery(OperationContext* txn,
                              const BSONObj& query,
                              std::set<ShardId>* shardIds) const;
@@ -231,6 +239,25 @@ private:
      */
     static ChunkRangeMap _constructRanges(const ChunkMap& chunkMap);
 
+    /**
+     * Rebuilds _routingIndex and _routingEntries from _chunkMap.
+     */
+    void _buildRoutingIndex();
+
+    /**
+     * Returns the entry of _chunkMap whose chunk should contain 'shardKey', i.e. the first one
+     * whose max is greater than the key, or _chunkMap.end(). Uses the routing index when it has
+     * been built for the current _chunkMap.
+     */
+    ChunkMap::const_iterator _upperBound(const BSONObj& shardKey) const;
+
+    /**
+     * Returns the chunk of the 'it' entry if it contains 'shardKey' and asserts otherwise.
+     */
+    std::shared_ptr<Chunk> _checkIntersectingChunk(OperationContext* txn,
+                                                   const BSONObj& shardKey,
+                                                   ChunkMap::const_iterator it) const;
+
     // All members should be const for thread-safety
     const std::string _ns;
     const ShardKeyPattern _keyPattern;
@@ -244,6 +271,11 @@ private:
     ChunkMap _chunkMap;
     ChunkRangeMap _chunkRangeMap;
 
+    // Flat index over the keys of _chunkMap used for targeting, and the _chunkMap entry for each
+    // position of the index.
+    ChunkRoutingIndex _routingIndex;
+    std::vector<ChunkMap::const_iterator> _routingEntries;
+
     std::set<ShardId> _shardIds;
 
     // Max known version per shard
@@ -292,26 +292,11 @@ Status ChunkManagerTargeter::targetInsert(OperationContext* txn,
     BSONObj shardKey;
 
     if (_manager) {
-        //
-        // Sharded collections have the following requirements for targeting:
-        //
-        // Inserts must contain the exact shard key.
-        //
+        auto shardKeyStatus = extractInsertShardKey(doc);
+        if (!shardKeyStatus.isOK())
+            return shardKeyStatus.getStatus();
 
-        shardKey = _manager->getShardKeyPattern().extractShardKeyFromDoc(doc);
-
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return Status(ErrorCodes::ShardKeyNotFound,
-                          stream() << "document " << doc
-                                   << " does not contain shard key for pattern "
-                                   << _manager->getShardKeyPattern().toString());
-        }
-
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+        shardKey = shardKeyStatus.getValue();
     }
 
     // Target the shard key or database primary
@@ -329,6 +314,64 @@ Status ChunkManagerTargeter::targetInsert(OperationContext* txn,
     }
 }
 
+Status ChunkManagerTargeter::targetInserts(OperationContext* txn,
+                                           const vector<BSONObj>& docs,
+                                           vector<ShardEndpoint*>* endpoints) const {
+    if (!_manager) {
+        return NSTargeter::targetInserts(txn, docs, endpoints);
+    }
+
+    vector<BSONObj> shardKeys;
+    shardKeys.reserve(docs.size());
+    for (const auto& doc : docs) {
+        auto shardKeyStatus = extractInsertShardKey(doc);
+        if (!shardKeyStatus.isOK())
+            return shardKeyStatus.getStatus();
+
+        shardKeys.push_back(shardKeyStatus.getValue());
+    }
+
+    vector<shared_ptr<Chunk>> chunks = _manager->findIntersectingChunks(txn, shardKeys);
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const shared_ptr<Chunk>& chunk = chunks[i];
+
+        // Track autosplit stats for sharded collections, same as targetShardKey
+        _stats->chunkSizeDelta[chunk->getMin()] += docs[i].objsize();
+
+        endpoints->push_back(
+            new ShardEndpoint(chunk->getShardId(), _manager->getVersion(chunk->getShardId())));
+    }
+
+    return Status::OK();
+}
+
+StatusWith<BSONObj> ChunkManagerTargeter::extractInsertShardKey(const BSONObj& doc) const {
+    invariant(_manager);
+
+    //
+    // Sharded collections have the following requirements for targeting:
+    //
+    // Inserts must contain the exact shard key.
+    //
+
+    BSONObj shardKey = _manager->getShardKeyPattern().extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return Status(ErrorCodes::ShardKeyNotFound,
+                      stream() << "document " << doc << " does not contain shard key for pattern "
+                               << _manager->getShardKeyPattern().toString());
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
+}
+
 Status ChunkManagerTargeter::targetUpdate(OperationContext* txn,
                                           const BatchedUpdateDocument& updateDoc,
                                           vector<ShardEndpoint*>* endpoints) const {
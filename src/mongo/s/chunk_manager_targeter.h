@@ -70,6 +70,11 @@ public:
     // Returns ShardKeyNotFound if document does not have a full shard key.
     Status targetInsert(OperationContext* txn, const BSONObj& doc, ShardEndpoint** endpoint) const;
 
+    // Targets all of the documents with a single lookup of their shard keys in the chunk manager.
+    Status targetInserts(OperationContext* txn,
+                         const std::vector<BSONObj>& docs,
+                         std::vector<ShardEndpoint*>* endpoints) const;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     Status targetUpdate(OperationContext* txn,
                         const BatchedUpdateDocument& updateDoc,
@@ -118,6 +123,14 @@ private:
      */
     Status refreshNow(OperationContext* txn, RefreshType refreshType);
 
+    /**
+     * Extracts the shard key from a document being inserted into a sharded collection.
+     *
+     * Returns ShardKeyNotFound if the document does not contain the full shard key, or the error
+     * from ShardKeyPattern::checkShardKeySize if the shard key is too large.
+     */
+    StatusWith<BSONObj> extractInsertShardKey(const BSONObj& doc) const;
+
     /**
      * Returns a vector of ShardEndpoints where a document might need to be placed.
      *
@@ -236,6 +236,72 @@ TEST_F(ChunkManagerTests, Basic) {
     std::cout << "completely done";
 }
 
+/**
+ * Tests that a ChunkManager loaded from an old ChunkManager shares the chunks which did not change.
+ */
+TEST_F(ChunkManagerTests, ReloadSharesUnchangedChunks) {
+    string keyName = "_id";
+    vector<BSONObj> splitKeys;
+    genUniqueRandomSplitKeys(keyName, &splitKeys);
+    ShardKeyPattern shardKeyPattern(BSON(keyName << 1));
+
+    std::vector<BSONObj> shards{
+        BSON(ShardType::name() << _shardId << ShardType::host()
+                               << ConnectionString(HostAndPort("hostFooBar:27017")).toString())};
+
+    std::vector<BSONObj> chunks;
+    auto future = launchAsync([&] {
+        ChunkManager manager(_collName, shardKeyPattern, false);
+        auto status = manager.createFirstChunks(operationContext(), _shardId, &splitKeys, NULL);
+        ASSERT_OK(status);
+    });
+
+    for (int i = 0; i < static_cast<int>(splitKeys.size()) + 1; i++) {
+        expectInsertOnConfigSaveChunkAndReturnOk(chunks);
+    }
+
+    future.timed_get(kFutureTimeout);
+
+    int numChunks = static_cast<int>(chunks.size());
+    ChunkVersion version = ChunkVersion::fromBSON(chunks.back(), ChunkType::DEPRECATED_lastmod());
+
+    CollectionType collType;
+    collType.setNs(NamespaceString{_collName});
+    collType.setEpoch(version.epoch());
+    collType.setUpdatedAt(jsTime());
+    collType.setKeyPattern(BSON(keyName << 1));
+    collType.setUnique(false);
+    collType.setDropped(false);
+
+    ChunkManager manager(collType);
+    future = launchAsync([&] { manager.loadExistingRanges(operationContext(), nullptr); });
+    expectFindOnConfigSendBSONObjVector(chunks);
+    expectFindOnConfigSendBSONObjVector(shards);
+    future.timed_get(kFutureTimeout);
+
+    // The diff query only returns the chunk with the highest version, so that is the only chunk
+    // which the new manager has to instantiate.
+    future = launchAsync([&] {
+        ChunkManager newManager(manager.getns(), manager.getShardKeyPattern(), manager.isUnique());
+        newManager.loadExistingRanges(operationContext(), &manager);
+
+        ASSERT_EQ(numChunks, newManager.numChunks());
+        ASSERT_EQ(manager.getVersion().toString(), newManager.getVersion().toString());
+
+        int numShared = 0;
+        for (const auto& entry : newManager.getChunkMap()) {
+            auto it = manager.getChunkMap().find(entry.first);
+            ASSERT(it != manager.getChunkMap().end());
+            if (it->second == entry.second) {
+                numShared++;
+            }
+        }
+        ASSERT_EQ(numChunks - 1, numShared);
+    });
+    expectFindOnConfigSendBSONObjVector(std::vector<BSONObj>{chunks.back()});
+    future.timed_get(kFutureTimeout);
+}
+
 /**
  * Tests that chunk metadata is created correctly when using ChunkManager to create chunks for the
  * first time. Creating chunks on multiple shards is not tested here since there are unresolved
@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_routing_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "mongo/bson/ordering.h"
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo {
+namespace {
+
+// Shard keys are compared with BSONObjCmp, which treats every field as ascending.
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+// Appends the KeyString encoding of 'key' to 'out'.
+void appendEncoded(const BSONObj& key, std::string* out) {
+    const KeyString encoded(KeyString::Version::V1, key, kAllAscending);
+    out->append(encoded.getBuffer(), encoded.getSize());
+}
+
+}  // namespace
+
+bool ChunkRoutingIndex::add(const BSONObj& key) {
+    std::string encoded;
+    appendEncoded(key, &encoded);
+
+    if (!_offsets.empty() && _compareAt(_offsets.size() - 1, encoded.data(), encoded.size()) >= 0) {
+        return false;
+    }
+
+    if (_keys.size() + encoded.size() > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+
+    _offsets.push_back(static_cast<uint32_t>(_keys.size()));
+    _keys.append(encoded);
+    return true;
+}
+
+size_t ChunkRoutingIndex::upperBound(const BSONObj& key) const {
+    std::string encoded;
+    appendEncoded(key, &encoded);
+    return _upperBound(encoded.data(), encoded.size(), 0);
+}
+
+std::vector<size_t> ChunkRoutingIndex::upperBounds(const std::vector<BSONObj>& keys) const {
+    std::vector<std::string> encoded(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        appendEncoded(keys[i], &encoded[i]);
+    }
+
+    // std::string compares like memcmp followed by length, which is how KeyStrings order.
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&encoded](size_t lhs, size_t rhs) {
+        return encoded[lhs] < encoded[rhs];
+    });
+
+    // Every key is at least as large as the previous one in sorted order, so its upper bound can
+    // only be at or after the previous key's.
+    std::vector<size_t> positions(keys.size());
+    size_t from = 0;
+    for (size_t i : order) {
+        from = _upperBound(encoded[i].data(), encoded[i].size(), from);
+        positions[i] = from;
+    }
+
+    return positions;
+}
+
+size_t ChunkRoutingIndex::_upperBound(const char* buf, size_t len, size_t from) const {
+    size_t low = from;
+    size_t high = _offsets.size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (_compareAt(mid, buf, len) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+int ChunkRoutingIndex::_compareAt(size_t pos, const char* buf, size_t len) const {
+    const size_t start = _offsets[pos];
+    const size_t end = pos + 1 < _offsets.size() ? _offsets[pos + 1] : _keys.size();
+    const size_t keyLen = end - start;
+
+    const int cmp = memcmp(_keys.data() + start, buf, std::min(keyLen, len));
+    if (cmp != 0) {
+        return cmp;
+    }
+    if (keyLen == len) {
+        return 0;
+    }
+    return keyLen < len ? -1 : 1;
+}
+
+}  // namespace mongo
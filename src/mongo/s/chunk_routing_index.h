@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * Immutable, flat index over the sorted keys of a routing table (for example the max keys of a
+ * ChunkMap). The keys are encoded as KeyStrings and packed into one contiguous buffer, so finding
+ * the entry for a shard key is a binary search with memcmp instead of a walk down a std::map which
+ * does a full BSONObj::woCompare at every level.
+ *
+ * Positions returned by the index refer to the order in which the keys were added.
+ */
+class ChunkRoutingIndex {
+public:
+    ChunkRoutingIndex() = default;
+
+    /**
+     * Appends a key to the index. Keys must be added in ascending order. Returns false and leaves
+     * the index unchanged if the encoded key does not sort after the last one, in which case the
+     * index cannot be used for these keys.
+     */
+    bool add(const BSONObj& key);
+
+    bool empty() const {
+        return _offsets.empty();
+    }
+
+    size_t size() const {
+        return _offsets.size();
+    }
+
+    /**
+     * Returns the position of the first key which is greater than 'key', or size() if there is no
+     * such key. Equivalent to std::map::upper_bound over the same keys.
+     */
+    size_t upperBound(const BSONObj& key) const;
+
+    /**
+     * Same as upperBound() for each of 'keys', returned in the same order as 'keys'. The keys are
+     * encoded and sorted first, so the whole batch is resolved in a single forward pass over the
+     * index.
+     */
+    std::vector<size_t> upperBounds(const std::vector<BSONObj>& keys) const;
+
+private:
+    /**
+     * Returns the position of the first key in [from, size()) which is greater than the encoded
+     * key in 'buf'.
+     */
+    size_t _upperBound(const char* buf, size_t len, size_t from) const;
+
+    // Compares the key at position 'pos' with the encoded key in 'buf'.
+    int _compareAt(size_t pos, const char* buf, size_t len) const;
+
+    // All of the encoded keys, back to back.
+    std::string _keys;
+
+    // The start of each key in _keys. A key ends where the next one starts.
+    std::vector<uint32_t> _offsets;
+};
+
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/s/chunk_routing_index.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeKeys() {
+    return {BSON("a" << 10),
+            BSON("a" << 20.5),
+            BSON("a"
+                 << "abc"),
+            BSON("a"
+                 << "abd"),
+            BSON("a" << BSON("b" << 1)),
+            BSON("a" << MAXKEY)};
+}
+
+ChunkRoutingIndex makeIndex(const std::vector<BSONObj>& keys) {
+    ChunkRoutingIndex index;
+    for (const auto& key : keys) {
+        ASSERT(index.add(key));
+    }
+    return index;
+}
+
+TEST(ChunkRoutingIndex, Empty) {
+    ChunkRoutingIndex index;
+    ASSERT(index.empty());
+    ASSERT_EQ(0U, index.upperBound(BSON("a" << 1)));
+}
+
+TEST(ChunkRoutingIndex, UpperBoundMatchesMap) {
+    const std::vector<BSONObj> keys = makeKeys();
+    const ChunkRoutingIndex index = makeIndex(keys);
+    ASSERT_EQ(keys.size(), index.size());
+
+    std::map<BSONObj, size_t, BSONObjCmp> map;
+    for (size_t i = 0; i < keys.size(); i++) {
+        map[keys[i]] = i;
+    }
+
+    const std::vector<BSONObj> lookups{BSON("a" << MINKEY),
+                                       BSON("a" << 5),
+                                       BSON("a" << 10),
+                                       BSON("a" << 10.0),
+                                       BSON("a" << 15LL),
+                                       BSON("a" << 20.5),
+                                       BSON("a" << 1000000),
+                                       BSON("a"
+                                            << ""),
+                                       BSON("a"
+                                            << "abc"),
+                                       BSON("a"
+                                            << "abcd"),
+                                       BSON("a" << BSON("b" << 0)),
+                                       BSON("a" << BSON("b" << 2)),
+                                       BSON("a" << true),
+                                       BSON("a" << MAXKEY)};
+
+    for (const auto& lookup : lookups) {
+        auto it = map.upper_bound(lookup);
+        const size_t expected = it == map.end() ? keys.size() : it->second;
+        ASSERT_EQ(expected, index.upperBound(lookup)) << lookup;
+    }
+}
+
+TEST(ChunkRoutingIndex, UpperBoundsMatchesUpperBound) {
+    const ChunkRoutingIndex index = makeIndex(makeKeys());
+
+    const std::vector<BSONObj> lookups{BSON("a"
+                                            << "abd"),
+                                       BSON("a" << 5),
+                                       BSON("a" << 25),
+                                       BSON("a" << 5),
+                                       BSON("a" << MINKEY),
+                                       BSON("a" << BSON("b" << 1)),
+                                       BSON("a"
+                                            << "abc")};
+
+    const std::vector<size_t> positions = index.upperBounds(lookups);
+    ASSERT_EQ(lookups.size(), positions.size());
+    for (size_t i = 0; i < lookups.size(); i++) {
+        ASSERT_EQ(index.upperBound(lookups[i]), positions[i]) << lookups[i];
+    }
+}
+
+TEST(ChunkRoutingIndex, KeysMustBeAscending) {
+    ChunkRoutingIndex index;
+    ASSERT(index.add(BSON("a" << 2)));
+    ASSERT_FALSE(index.add(BSON("a" << 2.0)));
+    ASSERT_FALSE(index.add(BSON("a" << 1)));
+    ASSERT_EQ(1U, index.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -145,7 +145,11 @@ void DBClientMultiCommand::sendAll() {
          it != _pendingCommands.end();
          ++it) {
         PendingCommand* command = *it;
+        if (command->sent)
+            continue;
+
         dassert(!command->conn);
+        command->sent = true;
 
         try {
             dassert(command->endpoint.type() == ConnectionString::MASTER ||
@@ -212,7 +216,11 @@ Status DBClientMultiCommand::recvAny(ConnectionString* endpoint, BSONSerializabl
 DBClientMultiCommand::PendingCommand::PendingCommand(const ConnectionString& endpoint,
                                                      StringData dbName,
                                                      const BSONObj& cmdObj)
-    : endpoint(endpoint), dbName(dbName.toString()), cmdObj(cmdObj), status(Status::OK()) {}
+    : endpoint(endpoint),
+      dbName(dbName.toString()),
+      cmdObj(cmdObj),
+      sent(false),
+      status(Status::OK()) {}
 
 DBClientMultiCommand::PendingCommand::~PendingCommand() = default;
 
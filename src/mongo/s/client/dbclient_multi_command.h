@@ -77,6 +77,9 @@ private:
         // Where to send it
         std::unique_ptr<ShardConnection> conn;
 
+        // Whether sendAll has already sent it
+        bool sent;
+
         // If anything goes wrong
         Status status;
     };
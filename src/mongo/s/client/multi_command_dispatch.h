@@ -59,8 +59,9 @@ public:
                             const BSONObj& request) = 0;
 
     /**
-     * Sends all the commands in this dispatch to their endpoints, in undefined order and
-     * without waiting for responses.  May block on full send queue (though this should be
+     * Sends all the commands added since the last sendAll to their endpoints, in undefined order
+     * and without waiting for responses. Commands may be added and sent while responses to
+     * earlier ones are still pending.  May block on full send queue (though this should be
      * rare).
      *
      * Any error which occurs during sendAll will be reported on recvAny, *does not throw.*
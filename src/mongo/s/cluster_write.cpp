@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/s/balancer/balancer_configuration.h"
 #include "mongo/s/catalog/catalog_cache.h"
@@ -46,6 +47,7 @@
 #include "mongo/s/config.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/write_ops/batch_write_exec.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -143,7 +145,7 @@ void splitIfNeeded(OperationContext* txn, const NamespaceString& nss, const Targ
             return;
         }
 
-        chunk->splitIfShould(txn, it->second);
+        chunk->splitIfShould(txn, chunkManager.get(), it->second);
     }
 }
 
@@ -278,6 +280,9 @@ void ClusterWriter::write(OperationContext* txn,
             exec.executeBatch(txn, *request, response, &_stats);
         }
 
+        // Cached reads of the collection may no longer reflect its contents
+        ClusterQueryResultCache::get(txn->getServiceContext())->noteWrite(request->getNS().ns());
+
         if (_autoSplit) {
             splitIfNeeded(txn, request->getNS(), targeterStats);
         }
@@ -35,6 +35,7 @@
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/find_and_modify.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/s/balancer/balancer_configuration.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/chunk_manager.h"
@@ -46,6 +47,7 @@
 #include "mongo/s/config.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/sharding_raii.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/util/timer.h"
@@ -173,10 +175,12 @@ public:
         shared_ptr<Chunk> chunk = chunkMgr->findIntersectingChunk(txn, shardKey);
 
         bool ok = _runCommand(txn, conf, chunkMgr, chunk->getShardId(), nss, cmdObj, result);
+        ClusterQueryResultCache::get(txn->getServiceContext())->noteWrite(nss.ns());
         if (ok) {
             // check whether split is necessary (using update object for size heuristic)
             if (mongosGlobalParams.shouldAutoSplit) {
-                chunk->splitIfShould(txn, cmdObj.getObjectField("update").objsize());
+                chunk->splitIfShould(
+                    txn, chunkMgr.get(), cmdObj.getObjectField("update").objsize());
             }
         }
 
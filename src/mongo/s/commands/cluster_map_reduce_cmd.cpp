@@ -581,7 +581,7 @@ public:
                     warning() << "Mongod reported " << size << " bytes inserted for key " << key
                               << " but can't find chunk";
                 } else {
-                    c->splitIfShould(txn, size);
+                    c->splitIfShould(txn, cm.get(), size);
                 }
             }
         }
@@ -109,6 +109,57 @@ void runAgainstRegistered(OperationContext* txn,
     Command::execCommandClientBasic(txn, c, cc(), queryOptions, ns, jsobj, anObjBuilder);
 }
 
+/**
+ * Sends 'firstReply', the reply to the exhaust find or getMore 'cmdObj', and then keeps running
+ * getMores against the cluster and sending each reply in response to the previous one, until the
+ * cursor is exhausted or a getMore fails. Every reply which will be followed by another is flagged
+ * with ResultFlag_MoreToCome. The client applies backpressure by not reading.
+ */
+void sendExhaustReplies(OperationContext* txn,
+                        Request& request,
+                        const char* ns,
+                        BSONObj cmdObj,
+                        int queryOptions,
+                        OpQueryReplyBuilder* firstReply) {
+    Message response;
+    firstReply->putInMessage(&response, /*queryFlags*/ 0, /*nReturned*/ 1);
+    int32_t responseToMsgId = request.m().header().getId();
+
+    while (true) {
+        QueryResult::View qr = response.header().view2ptr();
+        auto getMore = GetMoreRequest::makeExhaustGetMore(cmdObj, BSONObj(qr.data()));
+        if (getMore) {
+            qr.setResultFlags(qr.getResultFlags() | ResultFlag_MoreToCome);
+        }
+        request.p()->reply(request.m(), response, responseToMsgId);
+        if (!getMore) {
+            return;
+        }
+
+        responseToMsgId = response.header().getId();
+        cmdObj = getMore->toBSON();
+
+        Message next;
+        try {
+            OpQueryReplyBuilder reply;
+            {
+                BSONObjBuilder builder(reply.bufBuilderForResults());
+                runAgainstRegistered(txn, ns, cmdObj, builder, queryOptions);
+            }
+            reply.putInMessage(&next, /*queryFlags*/ 0, /*nReturned*/ 1);
+        } catch (const DBException& e) {
+            OpQueryReplyBuilder reply;
+            {
+                BSONObjBuilder builder(reply.bufBuilderForResults());
+                Command::appendCommandStatus(builder, e.toStatus());
+            }
+            reply.putInMessage(&next, /*queryFlags*/ 0, /*nReturned*/ 1);
+        }
+
+        response = std::move(next);
+    }
+}
+
 }  // namespace
 
 void Strategy::queryOp(OperationContext* txn, Request& request) {
@@ -216,10 +267,11 @@ void Strategy::clientCommandOp(OperationContext* txn, Request& request) {
     LOG(3) << "command: " << q.ns << " " << q.query << " ntoreturn: " << q.ntoreturn
            << " options: " << q.queryOptions;
 
-    if (q.queryOptions & QueryOption_Exhaust) {
+    if ((q.queryOptions & QueryOption_Exhaust) && !GetMoreRequest::isExhaustCommand(q.query)) {
         uasserted(18527,
-                  string("the 'exhaust' query option is invalid for mongos commands: ") + q.ns +
-                      " " + q.query.toString());
+                  string("the 'exhaust' query option is only valid for the find and getMore "
+                         "mongos commands: ") +
+                      q.ns + " " + q.query.toString());
     }
 
     NamespaceString nss(request.getns());
@@ -265,6 +317,10 @@ void Strategy::clientCommandOp(OperationContext* txn, Request& request) {
                 BSONObjBuilder builder(reply.bufBuilderForResults());
                 runAgainstRegistered(txn, q.ns, cmdObj, builder, q.queryOptions);
             }
+            if (q.queryOptions & QueryOption_Exhaust) {
+                sendExhaustReplies(txn, request, q.ns, cmdObj, q.queryOptions, &reply);
+                return;
+            }
             reply.sendCommandReply(request.p(), request.m());
             return;
         } catch (const StaleConfigException& e) {
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
@@ -87,6 +88,18 @@ public:
                                 const BSONObj& doc,
                                 ShardEndpoint** endpoint) const = 0;
 
+    /**
+     * Returns a ShardEndpoint for each of 'docs', in the same order, as targetInsert() would.
+     * Implementations may target all of the documents in one pass. The default implementation
+     * calls targetInsert() for each document.
+     *
+     * Returns !OK if any of the documents could not be targeted, in which case no endpoints are
+     * returned and the documents need to be targeted one at a time to find out which failed.
+     */
+    virtual Status targetInserts(OperationContext* txn,
+                                 const std::vector<BSONObj>& docs,
+                                 std::vector<ShardEndpoint*>* endpoints) const;
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update.
      *
@@ -165,4 +178,23 @@ struct ShardEndpoint {
     const ChunkVersion shardVersion;
 };
 
+inline Status NSTargeter::targetInserts(OperationContext* txn,
+                                        const std::vector<BSONObj>& docs,
+                                        std::vector<ShardEndpoint*>* endpoints) const {
+    for (const auto& doc : docs) {
+        ShardEndpoint* endpoint = NULL;
+        Status status = targetInsert(txn, doc, &endpoint);
+        if (!status.isOK()) {
+            for (auto targeted : *endpoints) {
+                delete targeted;
+            }
+            endpoints->clear();
+            return status;
+        }
+        endpoints->push_back(endpoint);
+    }
+
+    return Status::OK();
+}
+
 }  // namespace mongo
@@ -32,10 +32,14 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
@@ -51,8 +55,76 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Hedge delay used for a shard until enough establishment latencies have been recorded for it.
+const Milliseconds kDefaultHedgeDelay(50);
+
+// Lower bound on the hedge delay derived from recent latencies, so that a shard which is fast
+// does not have every read sent twice.
+const Milliseconds kMinHedgeDelay(5);
+
+/**
+ * Keeps the most recent cursor establishment latencies for each shard, from which the hedge delay
+ * is derived when 'hedgedReadDelayMS' is not set.
+ */
+class EstablishmentLatencies {
+public:
+    void record(const ShardId& shardId, Milliseconds latency) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto& samples = _samplesByShard[shardId];
+        if (samples.latencies.size() < kMaxSamples) {
+            samples.latencies.push_back(latency);
+        } else {
+            samples.latencies[samples.next] = latency;
+            samples.next = (samples.next + 1) % kMaxSamples;
+        }
+    }
+
+    boost::optional<Milliseconds> percentile95(const ShardId& shardId) {
+        std::vector<Milliseconds> latencies;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            auto it = _samplesByShard.find(shardId);
+            if (it == _samplesByShard.end() || it->second.latencies.size() < kMinSamples) {
+                return boost::none;
+            }
+            latencies = it->second.latencies;
+        }
+
+        auto nth = latencies.begin() + (latencies.size() * 95) / 100;
+        std::nth_element(latencies.begin(), nth, latencies.end());
+        return *nth;
+    }
+
+private:
+    static const size_t kMaxSamples = 100;
+    static const size_t kMinSamples = 20;
+
+    struct Samples {
+        std::vector<Milliseconds> latencies;
+        size_t next = 0;
+    };
+
+    stdx::mutex _mutex;
+    std::map<ShardId, Samples> _samplesByShard;
+};
+
+EstablishmentLatencies establishmentLatencies;
+
+Milliseconds getHedgeDelay(const ShardId& shardId) {
+    const int delayMS = hedgedReadDelayMS.load();
+    if (delayMS > 0) {
+        return Milliseconds(delayMS);
+    }
+
+    auto p95 = establishmentLatencies.percentile95(shardId);
+    return p95 ? std::max(*p95, kMinHedgeDelay) : kDefaultHedgeDelay;
+}
+
 }  // namespace
 
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadsEnabled, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadDelayMS, int, 0);
+
 AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
                                        ClusterClientCursorParams&& params)
     : _executor(executor),
@@ -79,6 +151,11 @@ AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
             _params.readPreference->pref != ReadPreference::PrimaryOnly, boost::none);
         uassertStatusOK(metadata.writeToMetadata(&metadataBuilder));
         _metadataObj = metadataBuilder.obj();
+
+        // Hedging only makes sense if there is a choice of host to read from. Batches from
+        // tailable cursors must be passed through as they arrive, so those are never hedged.
+        _hedgeReads = hedgedReadsEnabled.load() &&
+            _params.readPreference->pref != ReadPreference::PrimaryOnly && !_params.isTailable;
     }
 }
 
@@ -287,7 +364,13 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
         }
 
         remote.fetchedCount = 0;
+        remote.initialRequestDate = _executor->now();
         cmdObj = *remote.initialCmdObj;
+
+        // A retry of the initial command joins the race of the request it replaces.
+        if (_hedgeReads && !remote.hedgeRace) {
+            remote.hedgeRace = std::make_shared<HedgeRace>(this);
+        }
     }
 
     executor::RemoteCommandRequest request(
@@ -295,16 +378,163 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
 
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request,
-        stdx::bind(
-            &AsyncResultsMerger::handleBatchResponse, this, stdx::placeholders::_1, remoteIndex));
+        remote.hedgeRace ? makeHedgeRaceCallback_inlock(remoteIndex)
+                         : stdx::bind(&AsyncResultsMerger::handleBatchResponse,
+                                      this,
+                                      stdx::placeholders::_1,
+                                      remoteIndex));
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
 
     remote.cbHandle = callbackStatus.getValue();
+
+    if (_hedgeReads && !remote.cursorId && !remote.hedgeTimerHandle.isValid() &&
+        !remote.hedgeCbHandle.isValid()) {
+        scheduleHedgeTimer_inlock(remoteIndex);
+    }
+
     return Status::OK();
 }
 
+void AsyncResultsMerger::scheduleHedgeTimer_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    invariant(remote.shardId);
+    invariant(remote.hedgeRace);
+
+    auto race = remote.hedgeRace;
+    auto callbackStatus = _executor->scheduleWorkAt(
+        _executor->now() + getHedgeDelay(*remote.shardId),
+        [race, remoteIndex](const executor::TaskExecutor::CallbackArgs& cbArgs) {
+            stdx::lock_guard<stdx::mutex> raceLk(race->mutex);
+            if (!race->decided) {
+                race->arm->handleHedgeTimer(cbArgs, remoteIndex);
+            }
+        });
+    if (!callbackStatus.isOK()) {
+        LOG(1) << "Failed to schedule hedged read for shard " << *remote.shardId
+               << causedBy(callbackStatus.getStatus());
+        return;
+    }
+
+    remote.hedgeTimerHandle = callbackStatus.getValue();
+}
+
+void AsyncResultsMerger::handleHedgeTimer(const executor::TaskExecutor::CallbackArgs& cbArgs,
+                                          size_t remoteIndex) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& remote = _remotes[remoteIndex];
+    remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+
+    if (_lifecycleState != kAlive) {
+        invariant(_lifecycleState == kKillStarted);
+        completeKillIfDone_inlock();
+        return;
+    }
+
+    // Nothing to do if the timer was canceled, or if the cursor has been established or the
+    // remote has failed in the meantime.
+    if (!cbArgs.status.isOK() || remote.cursorId || !remote.status.isOK() ||
+        !remote.cbHandle.isValid() || remote.hedgeCbHandle.isValid()) {
+        return;
+    }
+
+    auto shard = remote.getShard();
+    if (!shard) {
+        return;
+    }
+
+    auto hedgeHostStatus = shard->getTargeter()->findHostExcluding(*_params.readPreference,
+                                                                   {remote.getTargetHost()});
+    if (!hedgeHostStatus.isOK()) {
+        LOG(1) << "No other host to send hedged read for shard " << *remote.shardId << " to"
+               << causedBy(hedgeHostStatus.getStatus());
+        return;
+    }
+
+    executor::RemoteCommandRequest request(hedgeHostStatus.getValue(),
+                                           _params.nsString.db().toString(),
+                                           *remote.initialCmdObj,
+                                           _metadataObj);
+
+    auto callbackStatus =
+        _executor->scheduleRemoteCommand(request, makeHedgeRaceCallback_inlock(remoteIndex));
+    if (!callbackStatus.isOK()) {
+        LOG(1) << "Failed to send hedged read to " << hedgeHostStatus.getValue()
+               << causedBy(callbackStatus.getStatus());
+        return;
+    }
+
+    LOG(1) << "Sending hedged read for shard " << *remote.shardId << " to "
+           << hedgeHostStatus.getValue() << " since " << remote.getTargetHost()
+           << " has not responded";
+
+    remote.hedgeCbHandle = callbackStatus.getValue();
+    remote.hedgeHost = std::move(hedgeHostStatus.getValue());
+}
+
+executor::TaskExecutor::RemoteCommandCallbackFn AsyncResultsMerger::makeHedgeRaceCallback_inlock(
+    size_t remoteIndex) {
+    auto race = _remotes[remoteIndex].hedgeRace;
+    invariant(race);
+
+    // Captures nothing owned by the ARM, since the request may outlive it once detached.
+    auto executor = _executor;
+    auto nss = _params.nsString;
+    return [race, executor, nss, remoteIndex](
+        const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+        stdx::lock_guard<stdx::mutex> raceLk(race->mutex);
+        if (race->decided) {
+            handleDetachedResponse(executor, nss, cbData);
+            return;
+        }
+
+        race->arm->handleBatchResponse(cbData, remoteIndex);
+    };
+}
+
+void AsyncResultsMerger::decideHedgeRace_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    invariant(remote.hedgeRace);
+
+    remote.hedgeRace->decided = true;
+    remote.hedgeRace.reset();
+
+    if (remote.hedgeTimerHandle.isValid()) {
+        _executor->cancel(remote.hedgeTimerHandle);
+        remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    // The callback of the request which delivered the current response is running, so at most
+    // the other request is still outstanding. It is left to complete rather than canceled, so that
+    // it can kill any cursor it opens.
+    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+}
+
+void AsyncResultsMerger::handleDetachedResponse(
+    executor::TaskExecutor* executor,
+    const NamespaceString& nss,
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+    if (!cbData.response.isOK()) {
+        return;
+    }
+
+    auto cursorResponse = CursorResponse::parseFromBSON(cbData.response.getValue().data);
+    if (!cursorResponse.isOK() || cursorResponse.getValue().getCursorId() == 0) {
+        return;
+    }
+
+    BSONObj cmdObj = KillCursorsRequest(nss, {cursorResponse.getValue().getCursorId()}).toBSON();
+
+    executor::RemoteCommandRequest request(cbData.request.target, nss.db().toString(), cmdObj);
+
+    executor->scheduleRemoteCommand(
+        request,
+        stdx::bind(&AsyncResultsMerger::handleKillCursorsResponse, stdx::placeholders::_1));
+}
+
 StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -381,9 +611,17 @@ void AsyncResultsMerger::handleBatchResponse(
 
     auto& remote = _remotes[remoteIndex];
 
+    // A response to the second request of a hedged read.
+    const bool isHedgeResponse =
+        remote.hedgeCbHandle.isValid() && cbData.myHandle == remote.hedgeCbHandle;
+
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
     // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    if (isHedgeResponse) {
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+    } else {
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    }
 
     // If we're in the process of shutting down then there's no need to process the batch.
     if (_lifecycleState != kAlive) {
@@ -392,31 +630,22 @@ void AsyncResultsMerger::handleBatchResponse(
         // Make sure to wake up anyone waiting on '_currentEvent' if we're shutting down.
         signalCurrentEventIfReady_inlock();
 
-        // Make a best effort to parse the response and retrieve the cursor id. We need the cursor
-        // id in order to issue a killCursors command against it.
         if (cbData.response.isOK()) {
+            // Make a best effort to parse the response and retrieve the cursor id. We need the
+            // cursor id in order to issue a killCursors command against it.
             auto cursorResponse = parseCursorResponse(cbData.response.getValue().data, remote);
             if (cursorResponse.isOK()) {
                 remote.cursorId = cursorResponse.getValue().getCursorId();
+                remote.setTargetHost(cbData.request.target);
             }
         }
 
-        // If we're killed and we're not waiting on any more batches to come back, then we are ready
-        // to kill the cursors on the remote hosts and clean up this cursor. Schedule the
-        // killCursors command and signal that this cursor is safe now safe to destroy. We have to
-        // promise not to touch any members of this class because 'this' could become invalid as
-        // soon as we signal the event.
-        if (!haveOutstandingBatchRequests_inlock()) {
-            // If the event handle is invalid, then the executor is in the middle of shutting down,
-            // and we can't schedule any more work for it to complete.
-            if (_killCursorsScheduledEvent.isValid()) {
-                scheduleKillCursors_inlock();
-                _executor->signalEvent(_killCursorsScheduledEvent);
-            }
-
-            _lifecycleState = kKillComplete;
+        // Don't wait for the other request of a hedged read. It kills its own cursor.
+        if (remote.hedgeRace) {
+            decideHedgeRace_inlock(remoteIndex);
         }
 
+        completeKillIfDone_inlock();
         return;
     }
 
@@ -427,6 +656,48 @@ void AsyncResultsMerger::handleBatchResponse(
         cbData.response.isOK() ? parseCursorResponse(cbData.response.getValue().data, remote)
                                : cbData.response.getStatus());
 
+    if (isHedgeResponse) {
+        invariant(remote.cbHandle.isValid());
+
+        if (!cursorResponseStatus.isOK()) {
+            // The original request is still outstanding, so leave it to establish the cursor.
+            LOG(1) << "Hedged read to " << cbData.request.target << " failed"
+                   << causedBy(cursorResponseStatus.getStatus());
+            auto shard = remote.getShard();
+            if (shard) {
+                shard->updateReplSetMonitor(cbData.request.target,
+                                            cursorResponseStatus.getStatus());
+            }
+            return;
+        }
+
+        // The hedged request won. The original request is detached once the cursor is
+        // established below.
+        remote.setTargetHost(cbData.request.target);
+    } else if (!remote.cursorId) {
+        if (remote.hedgeCbHandle.isValid() && !cursorResponseStatus.isOK()) {
+            // Let the hedged request, which is still outstanding, establish the cursor instead of
+            // retrying.
+            LOG(1) << "Initial cursor establishment on " << remote.getTargetHost()
+                   << " failed, waiting for hedged read to " << remote.hedgeHost
+                   << causedBy(cursorResponseStatus.getStatus());
+            auto shard = remote.getShard();
+            if (shard) {
+                shard->updateReplSetMonitor(remote.getTargetHost(),
+                                            cursorResponseStatus.getStatus());
+            }
+
+            std::swap(remote.cbHandle, remote.hedgeCbHandle);
+            remote.setTargetHost(remote.hedgeHost);
+            return;
+        }
+    }
+
+    if (!remote.cursorId && cursorResponseStatus.isOK() && remote.shardId) {
+        establishmentLatencies.record(*remote.shardId,
+                                      _executor->now() - remote.initialRequestDate);
+    }
+
     if (!cursorResponseStatus.isOK()) {
         auto shard = remote.getShard();
         if (!shard) {
@@ -465,6 +736,11 @@ void AsyncResultsMerger::handleBatchResponse(
             }
         }
 
+        // The remote cursor will not be established, so stop waiting for the hedge delay.
+        if (remote.hedgeRace) {
+            decideHedgeRace_inlock(remoteIndex);
+        }
+
         // Unreachable host errors are swallowed if the 'allowPartialResults' option is set. We
         // remove the unreachable host entirely from consideration by marking it as exhausted.
         if (_params.isAllowPartialResults) {
@@ -484,6 +760,11 @@ void AsyncResultsMerger::handleBatchResponse(
     remote.cursorId = cursorResponse.getCursorId();
     remote.initialCmdObj = boost::none;
 
+    // Detach the request which lost the race to establish the cursor, if it is still outstanding.
+    if (remote.hedgeRace) {
+        decideHedgeRace_inlock(remoteIndex);
+    }
+
     for (const auto& obj : cursorResponse.getBatch()) {
         // If there's a sort, we're expecting the remote node to give us back a sort key.
         if (!_params.sort.isEmpty() &&
@@ -541,7 +822,8 @@ void AsyncResultsMerger::signalCurrentEventIfReady_inlock() {
 
 bool AsyncResultsMerger::haveOutstandingBatchRequests_inlock() {
     for (const auto& remote : _remotes) {
-        if (remote.cbHandle.isValid()) {
+        if (remote.cbHandle.isValid() || remote.hedgeCbHandle.isValid() ||
+            remote.hedgeTimerHandle.isValid()) {
             return true;
         }
     }
@@ -549,6 +831,26 @@ bool AsyncResultsMerger::haveOutstandingBatchRequests_inlock() {
     return false;
 }
 
+void AsyncResultsMerger::completeKillIfDone_inlock() {
+    invariant(_lifecycleState == kKillStarted);
+
+    // If we're killed and we're not waiting on any more batches to come back, then we are ready
+    // to kill the cursors on the remote hosts and clean up this cursor. Schedule the
+    // killCursors command and signal that this cursor is safe now safe to destroy. We have to
+    // promise not to touch any members of this class because 'this' could become invalid as
+    // soon as we signal the event.
+    if (!haveOutstandingBatchRequests_inlock()) {
+        // If the event handle is invalid, then the executor is in the middle of shutting down,
+        // and we can't schedule any more work for it to complete.
+        if (_killCursorsScheduledEvent.isValid()) {
+            scheduleKillCursors_inlock();
+            _executor->signalEvent(_killCursorsScheduledEvent);
+        }
+
+        _lifecycleState = kKillComplete;
+    }
+}
+
 void AsyncResultsMerger::scheduleKillCursors_inlock() {
     invariant(_lifecycleState == kKillStarted);
     invariant(_killCursorsScheduledEvent.isValid());
@@ -583,6 +885,14 @@ executor::TaskExecutor::EventHandle AsyncResultsMerger::kill() {
 
     _lifecycleState = kKillStarted;
 
+    // There is no point in waiting for hedge delays to elapse, so cancel the timers. Their
+    // callbacks still have to run before the ARM can be destroyed.
+    for (const auto& remote : _remotes) {
+        if (remote.hedgeTimerHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerHandle);
+        }
+    }
+
     // Make '_killCursorsScheduledEvent', which we will signal as soon as we have scheduled a
     // killCursors command to run on all the remote shards.
     auto statusWithEvent = _executor->makeEvent();
@@ -624,6 +934,10 @@ const HostAndPort& AsyncResultsMerger::RemoteCursorData::getTargetHost() const {
     return *_shardHostAndPort;
 }
 
+void AsyncResultsMerger::RemoteCursorData::setTargetHost(HostAndPort hostAndPort) {
+    _shardHostAndPort = std::move(hostAndPort);
+}
+
 bool AsyncResultsMerger::RemoteCursorData::hasNext() const {
     return !docBuffer.empty();
 }
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/optional.hpp>
 #include <queue>
 #include <vector>
@@ -46,6 +47,14 @@ namespace mongo {
 
 class CursorResponse;
 
+// Whether the initial command for a remote read with a non-primary read preference is sent to a
+// second host if the first one has not responded after the hedge delay.
+extern std::atomic<bool> hedgedReadsEnabled;  // NOLINT
+
+// The hedge delay. If not positive, the 95th percentile of recent cursor establishment latencies
+// for the shard is used instead.
+extern std::atomic<int> hedgedReadDelayMS;  // NOLINT
+
 /**
  * AsyncResultsMerger is used to generate results from cursor-generating commands on one or more
  * remote hosts. A cursor-generating command (e.g. the find command) is one that establishes a
@@ -64,6 +73,14 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * If hedged reads are enabled and the read preference allows reading from more than one host, the
+ * command which establishes each remote cursor is sent again to a second eligible host if the
+ * first has not responded within the hedge delay. The cursor is established by whichever request
+ * succeeds first. The other request is then detached from the ARM rather than canceled, since only
+ * its response identifies a cursor it may have opened: the ARM no longer waits for it, and its
+ * callback kills that cursor by itself. getMores are never hedged, since they must go to the host
+ * on which the cursor was established.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -169,6 +186,20 @@ private:
      * retrieved from the host but not yet returned, as well as the cursor id, and any error
      * reported from the remote.
      */
+    /**
+     * Shared by the callbacks of the requests for the initial command of a remote whose reads are
+     * hedged, and of its hedge delay timer. They are delivered to 'arm' only while the race to
+     * establish the remote cursor is undecided, and with 'mutex' held. Once 'decided' is set, the
+     * remaining callbacks never touch the ARM, which may already be destroyed.
+     */
+    struct HedgeRace {
+        explicit HedgeRace(AsyncResultsMerger* arm) : arm(arm) {}
+
+        stdx::mutex mutex;
+        AsyncResultsMerger* const arm;
+        bool decided = false;
+    };
+
     struct RemoteCursorData {
         /**
          * Creates a new uninitialized remote cursor state, which will have to send a command in
@@ -188,6 +219,12 @@ private:
          */
         const HostAndPort& getTargetHost() const;
 
+        /**
+         * Changes the host on which the remote cursor is expected to reside. Used when the hedged
+         * request for the initial command takes over from the original one.
+         */
+        void setTargetHost(HostAndPort hostAndPort);
+
         /**
          * Returns whether there is another buffered result available for this remote node.
          */
@@ -240,6 +277,19 @@ private:
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
 
+        // Hedged read state, only used while the remote cursor is being established.
+        // 'hedgeTimerHandle' is valid while waiting for the hedge delay to elapse, and
+        // 'hedgeCbHandle' while a second request for the initial command is outstanding against
+        // 'hedgeHost'. If the original request fails while the hedged one is outstanding, the two
+        // requests trade places. 'hedgeRace' is set until the race between them is decided.
+        executor::TaskExecutor::CallbackHandle hedgeTimerHandle;
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+        HostAndPort hedgeHost;
+        std::shared_ptr<HedgeRace> hedgeRace;
+
+        // When the most recent initial command was sent, for tracking establishment latency.
+        Date_t initialRequestDate;
+
     private:
         // For a cursor, which has shard id associated contains the exact host on which the remote
         // cursor resides.
@@ -285,6 +335,41 @@ private:
      */
     Status askForNextBatch_inlock(size_t remoteIndex);
 
+    /**
+     * Schedules sending the initial command for the remote at 'remoteIndex' to a second host once
+     * the hedge delay elapses. Hedging is best effort, so failures are only logged.
+     */
+    void scheduleHedgeTimer_inlock(size_t remoteIndex);
+
+    /**
+     * Callback run when the hedge delay for the remote at 'remoteIndex' has elapsed. If the remote
+     * cursor is still not established, sends the initial command to another eligible host.
+     */
+    void handleHedgeTimer(const executor::TaskExecutor::CallbackArgs& cbArgs, size_t remoteIndex);
+
+    /**
+     * Returns the callback for a request for the initial command of the remote at 'remoteIndex',
+     * which goes through the remote's hedge race.
+     */
+    executor::TaskExecutor::RemoteCommandCallbackFn makeHedgeRaceCallback_inlock(
+        size_t remoteIndex);
+
+    /**
+     * Decides the hedge race of the remote at 'remoteIndex'. Must be called from one of its
+     * callbacks, with the race's mutex held. Any other request for the initial command is detached
+     * and no longer tracked, and the hedge delay timer is canceled.
+     */
+    void decideHedgeRace_inlock(size_t remoteIndex);
+
+    /**
+     * Handles the response to a request for the initial command which was detached from its ARM.
+     * Kills the cursor on 'nss', if any, that the request opened.
+     */
+    static void handleDetachedResponse(
+        executor::TaskExecutor* executor,
+        const NamespaceString& nss,
+        const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -326,10 +411,19 @@ private:
     void signalCurrentEventIfReady_inlock();
 
     /**
-     * Returns true if this async cursor is waiting to receive another batch from a remote.
+     * Returns true if this async cursor is waiting to receive another batch from a remote, or for
+     * a hedge delay to elapse.
      */
     bool haveOutstandingBatchRequests_inlock();
 
+    /**
+     * Called while the ARM is being killed, whenever a callback completes. Once there are no
+     * outstanding callbacks, schedules the killCursors commands and signals that this cursor is
+     * safe to destroy. Callers must not touch any members afterwards, since 'this' may be
+     * destroyed as soon as that event is signaled.
+     */
+    void completeKillIfDone_inlock();
+
     /**
      * Schedules a killCursors command to be run on all remote hosts that have open cursors.
      */
@@ -340,6 +434,9 @@ private:
 
     ClusterClientCursorParams _params;
 
+    // Whether the initial commands to the remotes are hedged. Fixed at construction.
+    bool _hedgeReads = false;
+
     // The metadata obj to pass along with the command request. Used to indicate that the command is
     // ok to run on secondaries.
     BSONObj _metadataObj;
@@ -35,6 +35,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/query/killcursors_request.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/task_executor.h"
@@ -45,6 +46,7 @@
 #include "mongo/s/sharding_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -60,6 +62,9 @@ const std::vector<ShardId> kTestShardIds = {
 const std::vector<HostAndPort> kTestShardHosts = {HostAndPort("FakeShard1Host", 12345),
                                                   HostAndPort("FakeShard2Host", 12345),
                                                   HostAndPort("FakeShard3Host", 12345)};
+const std::vector<HostAndPort> kTestShardHedgeHosts = {HostAndPort("FakeShard1Host", 23456),
+                                                       HostAndPort("FakeShard2Host", 23456),
+                                                       HostAndPort("FakeShard3Host", 23456)};
 
 class AsyncResultsMergerTest : public ShardingTestFixture {
 public:
@@ -84,6 +89,7 @@ public:
                 stdx::make_unique<RemoteCommandTargeterMock>());
             targeter->setConnectionStringReturnValue(ConnectionString(kTestShardHosts[i]));
             targeter->setFindHostReturnValue(kTestShardHosts[i]);
+            targeter->setFindHostExcludingReturnValue(kTestShardHedgeHosts[i]);
 
             targeterFactory()->addTargeterToReturn(ConnectionString(kTestShardHosts[i]),
                                                    std::move(targeter));
@@ -1367,6 +1373,250 @@ TEST_F(AsyncResultsMergerTest, GetMoreRequestWithoutAwaitDataCantHaveMaxTime) {
     executor()->waitForEvent(killEvent);
 }
 
+TEST_F(AsyncResultsMergerTest, HedgedReadEstablishesCursorWhenOriginalIsSlow) {
+    hedgedReadsEnabled.store(true);
+    hedgedReadDelayMS.store(10);
+    ON_BLOCK_EXIT([] {
+        hedgedReadsEnabled.store(false);
+        hedgedReadDelayMS.store(0);
+    });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll'}");
+    makeCursorFromFindCmd(
+        findCmd, {kTestShardIds[0]}, boost::none, ReadPreferenceSetting(ReadPreference::Nearest));
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    executor::NetworkInterfaceMock* net = network();
+    net->enterNetwork();
+
+    // The original request gets no response before the hedge delay elapses.
+    auto original = net->getNextReadyRequest();
+    ASSERT_EQ(kTestShardHosts[0], original->getRequest().target);
+    net->runUntil(net->now() + Milliseconds(10));
+
+    // The hedged request goes to another host and establishes the cursor.
+    ASSERT_TRUE(net->hasReadyRequests());
+    auto hedge = net->getNextReadyRequest();
+    ASSERT_EQ(kTestShardHedgeHosts[0], hedge->getRequest().target);
+    ASSERT_EQ(findCmd, hedge->getRequest().cmdObj);
+
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 1}")};
+    RemoteCommandResponse hedgeResponse(
+        CursorResponse(_nss, CursorId(123), batch1)
+            .toBSON(CursorResponse::ResponseType::InitialResponse),
+        BSONObj(),
+        Milliseconds(0));
+    net->scheduleResponse(hedge, net->now(), hedgeResponse);
+    net->runReadyNetworkOperations();
+
+    // The original request opens a cursor anyway, which gets killed.
+    RemoteCommandResponse originalResponse(
+        CursorResponse(_nss, CursorId(456), batch1)
+            .toBSON(CursorResponse::ResponseType::InitialResponse),
+        BSONObj(),
+        Milliseconds(0));
+    net->scheduleResponse(original, net->now(), originalResponse);
+    net->runReadyNetworkOperations();
+
+    ASSERT_TRUE(net->hasReadyRequests());
+    auto killCursors = net->getNextReadyRequest();
+    ASSERT_EQ(kTestShardHosts[0], killCursors->getRequest().target);
+    ASSERT_EQ(KillCursorsRequest(_nss, {CursorId(456)}).toBSON(),
+              killCursors->getRequest().cmdObj);
+    net->blackHole(killCursors);
+    net->exitNetwork();
+
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_FALSE(arm->ready());
+
+    // The getMore goes to the host on which the hedged request established the cursor.
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_EQ(kTestShardHedgeHosts[0], getFirstPendingRequest().target);
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 2}")};
+    responses.emplace_back(_nss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+    executor()->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->remotesExhausted());
+}
+
+TEST_F(AsyncResultsMergerTest, HedgedReadCursorIsKilledWhenOriginalWins) {
+    hedgedReadsEnabled.store(true);
+    hedgedReadDelayMS.store(10);
+    ON_BLOCK_EXIT([] {
+        hedgedReadsEnabled.store(false);
+        hedgedReadDelayMS.store(0);
+    });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll'}");
+    makeCursorFromFindCmd(
+        findCmd, {kTestShardIds[0]}, boost::none, ReadPreferenceSetting(ReadPreference::Nearest));
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+
+    executor::NetworkInterfaceMock* net = network();
+    net->enterNetwork();
+
+    auto original = net->getNextReadyRequest();
+    net->runUntil(net->now() + Milliseconds(10));
+    auto hedge = net->getNextReadyRequest();
+    ASSERT_EQ(kTestShardHedgeHosts[0], hedge->getRequest().target);
+
+    // The original request establishes the cursor, which is exhausted by its first batch.
+    std::vector<BSONObj> batch = {fromjson("{_id: 1}")};
+    RemoteCommandResponse originalResponse(
+        CursorResponse(_nss, CursorId(0), batch)
+            .toBSON(CursorResponse::ResponseType::InitialResponse),
+        BSONObj(),
+        Milliseconds(0));
+    net->scheduleResponse(original, net->now(), originalResponse);
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    // The hedged request is detached, so the ARM does not wait for it.
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->remotesExhausted());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+    arm.reset();
+
+    // The cursor opened by the hedged request gets killed after the ARM is gone.
+    net->enterNetwork();
+    RemoteCommandResponse hedgeResponse(
+        CursorResponse(_nss, CursorId(789), batch)
+            .toBSON(CursorResponse::ResponseType::InitialResponse),
+        BSONObj(),
+        Milliseconds(0));
+    net->scheduleResponse(hedge, net->now(), hedgeResponse);
+    net->runReadyNetworkOperations();
+
+    ASSERT_TRUE(net->hasReadyRequests());
+    auto killCursors = net->getNextReadyRequest();
+    ASSERT_EQ(kTestShardHedgeHosts[0], killCursors->getRequest().target);
+    ASSERT_EQ(KillCursorsRequest(_nss, {CursorId(789)}).toBSON(),
+              killCursors->getRequest().cmdObj);
+    net->blackHole(killCursors);
+    net->exitNetwork();
+}
+
+TEST_F(AsyncResultsMergerTest, KillDoesNotWaitForLosingHedgedRead) {
+    hedgedReadsEnabled.store(true);
+    hedgedReadDelayMS.store(10);
+    ON_BLOCK_EXIT([] {
+        hedgedReadsEnabled.store(false);
+        hedgedReadDelayMS.store(0);
+    });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll'}");
+    makeCursorFromFindCmd(
+        findCmd, {kTestShardIds[0]}, boost::none, ReadPreferenceSetting(ReadPreference::Nearest));
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+
+    executor::NetworkInterfaceMock* net = network();
+    net->enterNetwork();
+
+    auto original = net->getNextReadyRequest();
+    net->runUntil(net->now() + Milliseconds(10));
+    auto hedge = net->getNextReadyRequest();
+
+    // The original request establishes a cursor which is not exhausted.
+    std::vector<BSONObj> batch = {fromjson("{_id: 1}")};
+    RemoteCommandResponse originalResponse(
+        CursorResponse(_nss, CursorId(123), batch)
+            .toBSON(CursorResponse::ResponseType::InitialResponse),
+        BSONObj(),
+        Milliseconds(0));
+    net->scheduleResponse(original, net->now(), originalResponse);
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    executor()->waitForEvent(readyEvent);
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_FALSE(arm->remotesExhausted());
+
+    // Killing the ARM completes while the hedged request is still outstanding.
+    auto killEvent = arm->kill();
+    executor()->waitForEvent(killEvent);
+
+    net->enterNetwork();
+    ASSERT_TRUE(net->hasReadyRequests());
+    auto killCursors = net->getNextReadyRequest();
+    ASSERT_EQ(kTestShardHosts[0], killCursors->getRequest().target);
+    ASSERT_EQ(KillCursorsRequest(_nss, {CursorId(123)}).toBSON(),
+              killCursors->getRequest().cmdObj);
+    net->blackHole(killCursors);
+
+    // The hedged request kills its own cursor once it responds.
+    RemoteCommandResponse hedgeResponse(
+        CursorResponse(_nss, CursorId(789), batch)
+            .toBSON(CursorResponse::ResponseType::InitialResponse),
+        BSONObj(),
+        Milliseconds(0));
+    net->scheduleResponse(hedge, net->now(), hedgeResponse);
+    net->runReadyNetworkOperations();
+
+    ASSERT_TRUE(net->hasReadyRequests());
+    killCursors = net->getNextReadyRequest();
+    ASSERT_EQ(kTestShardHedgeHosts[0], killCursors->getRequest().target);
+    ASSERT_EQ(KillCursorsRequest(_nss, {CursorId(789)}).toBSON(),
+              killCursors->getRequest().cmdObj);
+    net->blackHole(killCursors);
+    net->exitNetwork();
+}
+
+TEST_F(AsyncResultsMergerTest, NoHedgedReadIfOriginalRespondsInTime) {
+    hedgedReadsEnabled.store(true);
+    hedgedReadDelayMS.store(10);
+    ON_BLOCK_EXIT([] {
+        hedgedReadsEnabled.store(false);
+        hedgedReadDelayMS.store(0);
+    });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll'}");
+    makeCursorFromFindCmd(findCmd,
+                          {kTestShardIds[0]},
+                          boost::none,
+                          ReadPreferenceSetting(ReadPreference::SecondaryPreferred));
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{_id: 1}")};
+    responses.emplace_back(_nss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses), CursorResponse::ResponseType::InitialResponse);
+    executor()->waitForEvent(readyEvent);
+
+    // The hedge timer was canceled, so no second request is sent once the delay elapses.
+    executor::NetworkInterfaceMock* net = network();
+    net->enterNetwork();
+    net->runUntil(net->now() + Milliseconds(10));
+    ASSERT_FALSE(net->hasReadyRequests());
+    net->exitNetwork();
+
+    ASSERT_TRUE(arm->remotesExhausted());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
 }  // namespace
 
 }  // namespace mongo
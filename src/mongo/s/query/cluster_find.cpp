@@ -33,6 +33,7 @@
 #include "mongo/s/query/cluster_find.h"
 
 #include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/base/status_with.h"
@@ -40,9 +41,11 @@
 #include "mongo/client/connpool.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
@@ -54,16 +57,95 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/stringutils.h"
 
 namespace mongo {
 
+// Bounds on the results kept by the ClusterQueryResultCache. Entries older than the staleness
+// bound may miss writes which did not go through this mongos.
+MONGO_EXPORT_SERVER_PARAMETER(queryResultCacheMaxSizeBytes, long long, 64 * 1024 * 1024);
+MONGO_EXPORT_SERVER_PARAMETER(queryResultCacheMaxStalenessMS, int, 1000);
+
 namespace {
 
+/**
+ * Comma separated list of the collections whose exact shard key lookups are cached by mongos.
+ * Empty by default, which disables the cache.
+ */
+class QueryResultCacheNamespacesParameter : public ServerParameter {
+public:
+    QueryResultCacheNamespacesParameter()
+        : ServerParameter(ServerParameterSet::getGlobal(), "queryResultCacheNamespaces") {}
+
+    void append(OperationContext* txn, BSONObjBuilder& b, const std::string& name) override {
+        std::string namespaces;
+        for (const auto& ns : _getCache()->getEnabledNamespaces()) {
+            namespaces += (namespaces.empty() ? "" : ",") + ns;
+        }
+        b.append(name, namespaces);
+    }
+
+    Status set(const BSONElement& newValueElement) override {
+        if (newValueElement.type() != String) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "queryResultCacheNamespaces must be a string, not "
+                                  << typeName(newValueElement.type())};
+        }
+        return setFromString(newValueElement.String());
+    }
+
+    Status setFromString(const std::string& value) override {
+        std::vector<std::string> tokens;
+        splitStringDelim(value, &tokens, ',');
+
+        std::set<std::string> namespaces;
+        for (const auto& token : tokens) {
+            if (token.empty()) {
+                continue;
+            }
+
+            const NamespaceString nss(token);
+            if (!nss.isValid() || nss.coll().empty()) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "invalid namespace in queryResultCacheNamespaces: "
+                                      << token};
+            }
+            namespaces.insert(nss.ns());
+        }
+
+        _getCache()->setEnabledNamespaces(std::move(namespaces));
+        return Status::OK();
+    }
+
+private:
+    static ClusterQueryResultCache* _getCache() {
+        return ClusterQueryResultCache::get(getGlobalServiceContext());
+    }
+} queryResultCacheNamespacesParameter;
+
+class QueryResultCacheServerStatusSection : public ServerStatusSection {
+public:
+    QueryResultCacheServerStatusSection() : ServerStatusSection("queryResultCache") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* txn,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder result;
+        ClusterQueryResultCache::get(txn->getServiceContext())->appendStats(&result);
+        return result.obj();
+    }
+} queryResultCacheServerStatusSection;
+
 static const BSONObj kSortKeyMetaProjection = BSON("$meta"
                                                    << "sortKey");
 
@@ -279,6 +361,33 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
         ccc.releaseCursor(), query.nss(), cursorType, cursorLifetime);
 }
 
+/**
+ * Returns whether the results of 'query' may be served from and stored in the result cache, which
+ * is only the case for plain reads of complete result sets.
+ */
+bool isCacheableQuery(const CanonicalQuery& query, const ClusterQueryResultCache& resultCache) {
+    const auto& qr = query.getQueryRequest();
+    return resultCache.isEnabled(query.nss().ns()) && !qr.isTailable() && !qr.isExplain() &&
+        !qr.isAllowPartialResults() && !qr.isOplogReplay() && qr.getReadConcern().isEmpty();
+}
+
+/**
+ * Builds the result cache key of 'query', which covers the complete find command and the read
+ * preference, so that queries only share an entry if they would return the same results.
+ */
+std::string makeResultCacheKey(const CanonicalQuery& query, const ReadPreferenceSetting& readPref) {
+    BSONObjBuilder findBuilder;
+    query.getQueryRequest().asFindCommand(&findBuilder);
+    const BSONObj findCmd = findBuilder.obj();
+    const BSONObj readPrefObj = readPref.toBSON();
+
+    std::string key = query.nss().ns();
+    key.push_back('\0');
+    key.append(findCmd.objdata(), findCmd.objsize());
+    key.append(readPrefObj.objdata(), readPrefObj.objsize());
+    return key;
+}
+
 }  // namespace
 
 const size_t ClusterFind::kMaxStaleConfigRetries = 10;
@@ -311,12 +420,51 @@ StatusWith<CursorId> ClusterFind::runQuery(OperationContext* txn,
     std::shared_ptr<Shard> primary;
     dbConfig.getValue()->getChunkManagerOrPrimary(txn, query.nss().ns(), chunkManager, primary);
 
+    // Exact shard key lookups on collections which opted into the result cache can be answered
+    // without contacting the shard, as long as the shard which owns the key has not changed.
+    auto resultCache = ClusterQueryResultCache::get(txn->getServiceContext());
+    BSONObj cacheShardKey;
+    std::string cacheKey;
+    uint64_t cacheGeneration = 0;
+    if (chunkManager && isCacheableQuery(query, *resultCache)) {
+        auto shardKey = chunkManager->getShardKeyPattern().extractShardKeyFromQuery(query);
+        if (shardKey.isOK() && !shardKey.getValue().isEmpty()) {
+            cacheShardKey = shardKey.getValue();
+            cacheKey = makeResultCacheKey(query, readPref);
+            cacheGeneration = resultCache->getGeneration(query.nss().ns());
+
+            const ShardId shardId =
+                chunkManager->findIntersectingChunk(txn, cacheShardKey)->getShardId();
+            if (resultCache->lookup(cacheKey,
+                                    shardId,
+                                    chunkManager->getVersion(shardId),
+                                    Date_t::now(),
+                                    Milliseconds(queryResultCacheMaxStalenessMS.load()),
+                                    results)) {
+                return CursorId(0);
+            }
+        }
+    }
+
     // Re-target and re-send the initial find command to the shards until we have established the
     // shard version.
     for (size_t retries = 1; retries <= kMaxStaleConfigRetries; ++retries) {
         auto cursorId = runQueryWithoutRetrying(
             txn, query, readPref, chunkManager.get(), std::move(primary), results);
         if (cursorId.isOK()) {
+            // Only complete results can be cached, and only if the collection is still sharded
+            if (!cacheKey.empty() && cursorId.getValue() == 0 && chunkManager) {
+                const ShardId shardId =
+                    chunkManager->findIntersectingChunk(txn, cacheShardKey)->getShardId();
+                resultCache->insert(cacheKey,
+                                    query.nss().ns(),
+                                    cacheGeneration,
+                                    shardId,
+                                    chunkManager->getVersion(shardId),
+                                    Date_t::now(),
+                                    *results,
+                                    queryResultCacheMaxSizeBytes.load());
+            }
             return cursorId;
         }
         auto status = std::move(cursorId.getStatus());
@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getResultCache = ServiceContext::declareDecoration<ClusterQueryResultCache>();
+
+}  // namespace
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(ServiceContext* serviceContext) {
+    return &getResultCache(serviceContext);
+}
+
+void ClusterQueryResultCache::setEnabledNamespaces(std::set<std::string> namespaces) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _enabledNamespaces = std::move(namespaces);
+
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        auto next = std::next(it);
+        if (!_enabledNamespaces.count(it->ns)) {
+            _erase_inlock(it);
+        }
+        it = next;
+    }
+}
+
+std::set<std::string> ClusterQueryResultCache::getEnabledNamespaces() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _enabledNamespaces;
+}
+
+bool ClusterQueryResultCache::isEnabled(StringData ns) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return !_enabledNamespaces.empty() && _enabledNamespaces.count(ns.toString());
+}
+
+uint64_t ClusterQueryResultCache::getGeneration(StringData ns) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _generations.find(ns.toString());
+    return it == _generations.end() ? 0 : it->second;
+}
+
+void ClusterQueryResultCache::noteWrite(StringData ns) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_enabledNamespaces.count(ns.toString())) {
+        return;
+    }
+
+    // Entries of the collection are dropped lazily, when they are looked up or evicted
+    ++_generations[ns.toString()];
+}
+
+bool ClusterQueryResultCache::lookup(const std::string& key,
+                                     const ShardId& shardId,
+                                     const ChunkVersion& shardVersion,
+                                     Date_t now,
+                                     Milliseconds maxStaleness,
+                                     std::vector<BSONObj>* results) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _entriesByKey.find(key);
+    if (it == _entriesByKey.end()) {
+        ++_stats.misses;
+        return false;
+    }
+
+    auto entryIt = it->second;
+    const auto generationIt = _generations.find(entryIt->ns);
+    const uint64_t generation = generationIt == _generations.end() ? 0 : generationIt->second;
+
+    if (entryIt->generation != generation || entryIt->shardId != shardId ||
+        !entryIt->shardVersion.isStrictlyEqualTo(shardVersion) ||
+        entryIt->insertedAt + maxStaleness < now) {
+        _erase_inlock(entryIt);
+        ++_stats.invalidations;
+        ++_stats.misses;
+        return false;
+    }
+
+    _entries.splice(_entries.begin(), _entries, entryIt);
+    *results = entryIt->results;
+    ++_stats.hits;
+    return true;
+}
+
+void ClusterQueryResultCache::insert(const std::string& key,
+                                     StringData ns,
+                                     uint64_t generation,
+                                     const ShardId& shardId,
+                                     const ChunkVersion& shardVersion,
+                                     Date_t now,
+                                     const std::vector<BSONObj>& results,
+                                     long long maxSizeBytes) {
+    long long sizeBytes = static_cast<long long>(key.size());
+    for (const auto& result : results) {
+        sizeBytes += result.objsize();
+    }
+
+    if (sizeBytes > maxSizeBytes) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_enabledNamespaces.count(ns.toString())) {
+        return;
+    }
+
+    const auto generationIt = _generations.find(ns.toString());
+    if (generation != (generationIt == _generations.end() ? 0 : generationIt->second)) {
+        return;
+    }
+
+    auto existing = _entriesByKey.find(key);
+    if (existing != _entriesByKey.end()) {
+        _erase_inlock(existing->second);
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.ns = ns.toString();
+    entry.generation = generation;
+    entry.shardId = shardId;
+    entry.shardVersion = shardVersion;
+    entry.insertedAt = now;
+    entry.sizeBytes = sizeBytes;
+    entry.results.reserve(results.size());
+    for (const auto& result : results) {
+        entry.results.push_back(result.getOwned());
+    }
+
+    _entries.push_front(std::move(entry));
+    _entriesByKey[key] = _entries.begin();
+    ++_stats.insertions;
+    ++_stats.numEntries;
+    _stats.sizeBytes += sizeBytes;
+
+    _evictUntilFits_inlock(maxSizeBytes);
+}
+
+ClusterQueryResultCache::Stats ClusterQueryResultCache::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _stats;
+}
+
+void ClusterQueryResultCache::appendStats(BSONObjBuilder* builder) const {
+    const Stats stats = getStats();
+    builder->append("hits", stats.hits);
+    builder->append("misses", stats.misses);
+    builder->append("insertions", stats.insertions);
+    builder->append("invalidations", stats.invalidations);
+    builder->append("evictions", stats.evictions);
+    builder->append("numEntries", stats.numEntries);
+    builder->append("sizeBytes", stats.sizeBytes);
+}
+
+void ClusterQueryResultCache::_erase_inlock(EntryList::iterator it) {
+    --_stats.numEntries;
+    _stats.sizeBytes -= it->sizeBytes;
+    _entriesByKey.erase(it->key);
+    _entries.erase(it);
+}
+
+void ClusterQueryResultCache::_evictUntilFits_inlock(long long maxSizeBytes) {
+    while (_stats.sizeBytes > maxSizeBytes && !_entries.empty()) {
+        _erase_inlock(std::prev(_entries.end()));
+        ++_stats.evictions;
+    }
+}
+
+}  // namespace mongo
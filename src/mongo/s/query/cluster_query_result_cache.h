@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/s/shard_id.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * ClusterQueryResultCache keeps the results of exact shard key lookups on mongos, so that repeated
+ * point reads of the same documents do not need a round trip to the shard.
+ *
+ * Caching is opt-in per collection. Each entry remembers the shard which owns the key and that
+ * shard's version at the time the results were read, and is only returned while the routing table
+ * still targets the same shard at the same version. Writes routed through this mongos invalidate
+ * all the entries of their collection. Writes which bypass this mongos are only bounded by the
+ * maximum staleness passed to lookup(), so the cache must only be enabled for collections which
+ * can tolerate reads that old.
+ *
+ * The cache is bounded by the total size of the cached documents and evicts the least recently
+ * used entries first.
+ *
+ * All methods are thread-safe.
+ */
+class ClusterQueryResultCache {
+    MONGO_DISALLOW_COPYING(ClusterQueryResultCache);
+
+public:
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long insertions = 0;
+        long long invalidations = 0;
+        long long evictions = 0;
+        long long numEntries = 0;
+        long long sizeBytes = 0;
+    };
+
+    ClusterQueryResultCache() = default;
+
+    static ClusterQueryResultCache* get(ServiceContext* serviceContext);
+
+    /**
+     * Replaces the set of collections whose results may be cached. Entries of collections which
+     * are no longer enabled are dropped.
+     */
+    void setEnabledNamespaces(std::set<std::string> namespaces);
+    std::set<std::string> getEnabledNamespaces() const;
+    bool isEnabled(StringData ns) const;
+
+    /**
+     * Returns the write generation of 'ns', which must be captured before the query whose results
+     * are passed to insert() is sent, so that writes that complete in the meantime are detected.
+     */
+    uint64_t getGeneration(StringData ns) const;
+
+    /**
+     * Invalidates all the entries of 'ns'. Must be called after a write to 'ns' completes.
+     */
+    void noteWrite(StringData ns);
+
+    /**
+     * Fills 'results' and returns true if there is an entry for 'key' which was read from
+     * 'shardId' at 'shardVersion' no longer than 'maxStaleness' before 'now'.
+     */
+    bool lookup(const std::string& key,
+                const ShardId& shardId,
+                const ChunkVersion& shardVersion,
+                Date_t now,
+                Milliseconds maxStaleness,
+                std::vector<BSONObj>* results);
+
+    /**
+     * Caches 'results' for 'key', unless 'ns' was written since 'generation' was obtained or the
+     * results alone exceed 'maxSizeBytes'. Evicts other entries until the cache fits in
+     * 'maxSizeBytes'.
+     */
+    void insert(const std::string& key,
+                StringData ns,
+                uint64_t generation,
+                const ShardId& shardId,
+                const ChunkVersion& shardVersion,
+                Date_t now,
+                const std::vector<BSONObj>& results,
+                long long maxSizeBytes);
+
+    Stats getStats() const;
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string ns;
+        uint64_t generation;
+        ShardId shardId;
+        ChunkVersion shardVersion;
+        Date_t insertedAt;
+        std::vector<BSONObj> results;
+        long long sizeBytes;
+    };
+
+    // Most recently used entries first
+    using EntryList = std::list<Entry>;
+
+    void _erase_inlock(EntryList::iterator it);
+
+    void _evictUntilFits_inlock(long long maxSizeBytes);
+
+    mutable stdx::mutex _mutex;
+
+    std::set<std::string> _enabledNamespaces;
+
+    // Bumped by every write to a collection. Entries read at an older generation are stale.
+    std::unordered_map<std::string, uint64_t> _generations;
+
+    EntryList _entries;
+    std::unordered_map<std::string, EntryList::iterator> _entriesByKey;
+
+    Stats _stats;
+};
+
+}  // namespace mongo
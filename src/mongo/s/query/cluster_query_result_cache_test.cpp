@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+namespace {
+
+const std::string kNs("test.collection");
+const ShardId kShard("shard0000");
+const Milliseconds kMaxStaleness(1000);
+const long long kMaxSizeBytes(1024 * 1024);
+
+class ClusterQueryResultCacheTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _cache.setEnabledNamespaces({kNs});
+    }
+
+    void insert(const std::string& key,
+                uint64_t generation,
+                const std::vector<BSONObj>& results,
+                long long maxSizeBytes = kMaxSizeBytes) {
+        _cache.insert(key, kNs, generation, kShard, _version, _now, results, maxSizeBytes);
+    }
+
+    bool lookup(const std::string& key, std::vector<BSONObj>* results) {
+        return _cache.lookup(key, kShard, _version, _now, kMaxStaleness, results);
+    }
+
+    ClusterQueryResultCache _cache;
+    ChunkVersion _version{1, 0, OID::gen()};
+    Date_t _now = Date_t::fromMillisSinceEpoch(100000);
+};
+
+TEST_F(ClusterQueryResultCacheTest, HitAfterInsert) {
+    insert("a", _cache.getGeneration(kNs), {BSON("_id" << 1), BSON("_id" << 2)});
+
+    std::vector<BSONObj> results;
+    ASSERT_TRUE(lookup("a", &results));
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(BSON("_id" << 2), results[1]);
+
+    ASSERT_FALSE(lookup("b", &results));
+
+    const auto stats = _cache.getStats();
+    ASSERT_EQUALS(1, stats.hits);
+    ASSERT_EQUALS(1, stats.misses);
+    ASSERT_EQUALS(1, stats.numEntries);
+}
+
+TEST_F(ClusterQueryResultCacheTest, NotEnabledForNamespace) {
+    _cache.setEnabledNamespaces({});
+    ASSERT_FALSE(_cache.isEnabled(kNs));
+
+    insert("a", _cache.getGeneration(kNs), {BSON("_id" << 1)});
+
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(lookup("a", &results));
+    ASSERT_EQUALS(0, _cache.getStats().numEntries);
+}
+
+TEST_F(ClusterQueryResultCacheTest, ShardVersionChangeInvalidates) {
+    insert("a", _cache.getGeneration(kNs), {BSON("_id" << 1)});
+
+    _version.incMinor();
+
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(lookup("a", &results));
+    ASSERT_EQUALS(1, _cache.getStats().invalidations);
+    ASSERT_EQUALS(0, _cache.getStats().numEntries);
+}
+
+TEST_F(ClusterQueryResultCacheTest, WriteInvalidates) {
+    const uint64_t generation = _cache.getGeneration(kNs);
+    insert("a", generation, {BSON("_id" << 1)});
+
+    _cache.noteWrite(kNs);
+
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(lookup("a", &results));
+
+    // Results read before the write completed must not be cached
+    insert("a", generation, {BSON("_id" << 1)});
+    ASSERT_FALSE(lookup("a", &results));
+
+    insert("a", _cache.getGeneration(kNs), {BSON("_id" << 1)});
+    ASSERT_TRUE(lookup("a", &results));
+}
+
+TEST_F(ClusterQueryResultCacheTest, EntriesExpire) {
+    insert("a", _cache.getGeneration(kNs), {BSON("_id" << 1)});
+
+    std::vector<BSONObj> results;
+    _now += kMaxStaleness;
+    ASSERT_TRUE(lookup("a", &results));
+
+    _now += Milliseconds(1);
+    ASSERT_FALSE(lookup("a", &results));
+}
+
+TEST_F(ClusterQueryResultCacheTest, EvictsLeastRecentlyUsed) {
+    const BSONObj doc = BSON("_id" << 1 << "payload" << std::string(100, 'x'));
+    const long long maxSizeBytes = 2 * (doc.objsize() + 1);
+
+    insert("a", _cache.getGeneration(kNs), {doc}, maxSizeBytes);
+    insert("b", _cache.getGeneration(kNs), {doc}, maxSizeBytes);
+
+    // Touch "a", so that "b" is the least recently used entry
+    std::vector<BSONObj> results;
+    ASSERT_TRUE(lookup("a", &results));
+
+    insert("c", _cache.getGeneration(kNs), {doc}, maxSizeBytes);
+
+    ASSERT_TRUE(lookup("a", &results));
+    ASSERT_FALSE(lookup("b", &results));
+    ASSERT_TRUE(lookup("c", &results));
+    ASSERT_EQUALS(1, _cache.getStats().evictions);
+    ASSERT_EQUALS(2, _cache.getStats().numEntries);
+}
+
+}  // namespace
+
+}  // namespace mongo
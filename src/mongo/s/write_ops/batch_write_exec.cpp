@@ -32,8 +32,12 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <algorithm>
+#include <deque>
+#include <map>
+
 #include "mongo/base/error_codes.h"
-#include "mongo/base/owned_pointer_map.h"
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
@@ -44,6 +48,7 @@
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -62,7 +67,10 @@ namespace {
 //
 
 // TODO: Unordered map?
-typedef OwnedPointerMap<ConnectionString, TargetedWriteBatch> OwnedHostBatchMap;
+typedef std::map<ConnectionString, TargetedWriteBatch*> HostBatchMap;
+
+// Targeted batches which are waiting for the previous batch to the same host to complete
+typedef std::map<ConnectionString, std::deque<TargetedWriteBatch*>> HostBatchQueueMap;
 }
 
 static void buildErrorFrom(const Status& status, WriteErrorDetail* error) {
@@ -80,10 +88,32 @@ static void noteStaleResponses(const vector<ShardError*>& staleErrors, NSTargete
     }
 }
 
+// Helper to figure out what host we need to dispatch a targeted batch to
+static StatusWith<ConnectionString> resolveHost(OperationContext* txn,
+                                                const TargetedWriteBatch& batch) {
+    auto shard = grid.shardRegistry()->getShard(txn, batch.getEndpoint().shardName);
+    if (!shard) {
+        return Status(ErrorCodes::ShardNotFound,
+                      str::stream() << "unknown shard name " << batch.getEndpoint().shardName);
+    }
+
+    const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
+    auto swHostAndPort = shard->getTargeter()->findHost(readPref);
+    if (!swHostAndPort.isOK()) {
+        return swHostAndPort.getStatus();
+    }
+
+    return ConnectionString(swHostAndPort.getValue());
+}
+
 // The number of times we'll try to continue a batch op if no progress is being made
 // This only applies when no writes are occurring and metadata is not changing on reload
 static const int kMaxRoundsWithoutProgress(5);
 
+// The number of child batches of an unordered batch op which may wait for the batch in flight to
+// the same host. Further writes are only targeted once the queues have drained below this.
+static const size_t kMaxQueuedBatchesPerHost(2);
+
 void BatchWriteExec::executeBatch(OperationContext* txn,
                                   const BatchedCommandRequest& clientRequest,
                                   BatchedCommandResponse* clientResponse,
@@ -125,6 +155,8 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
         //    exactly when the metadata changed.
         //
 
+        Timer roundTimer;
+
         OwnedPointerVector<TargetedWriteBatch> childBatchesOwned;
         vector<TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableVector();
 
@@ -141,91 +173,54 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
             dassert(childBatches.size() == 0u);
         }
 
-        //
-        // Send all child batches
-        //
-
-        size_t numSent = 0;
-        size_t numToSend = childBatches.size();
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedHostBatchMap ownedPendingBatches;
-            OwnedHostBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+        // The writes of an unordered batch op may complete in any order, so the remaining writes
+        // can be targeted and sent to a host as soon as its previous child batch completes,
+        // rather than waiting for every host to respond. This stops as soon as the targeter may
+        // be stale, since the remaining writes then need to wait for a refresh.
+        bool canPipeline = !clientRequest.getOrdered() && targetStatus.isOK();
 
-            //
-            // Send side
-            //
+        // Child batches out on the network, mapped by endpoint. Every host has at most one batch
+        // in flight and the remaining batches for it wait in 'queuedBatches'.
+        HostBatchMap pendingBatches;
+        HostBatchQueueMap queuedBatches;
 
-            // Get as many batches as we can at once
-            for (vector<TargetedWriteBatch*>::iterator it = childBatches.begin();
-                 it != childBatches.end();
-                 ++it) {
-                //
-                // Collect the info needed to dispatch our targeted batch
-                //
-
-                TargetedWriteBatch* nextBatch = *it;
-                // If the batch is NULL, we sent it previously, so skip
-                if (nextBatch == NULL)
-                    continue;
-
-                // Figure out what host we need to dispatch our targeted batch
-                bool resolvedHost = true;
-                const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
-                auto shard =
-                    grid.shardRegistry()->getShard(txn, nextBatch->getEndpoint().shardName);
-
-                if (!shard) {
-                    Status status = Status(ErrorCodes::ShardNotFound,
-                                           str::stream() << "unknown shard name "
-                                                         << nextBatch->getEndpoint().shardName);
-                    resolvedHost = false;
+        // Resolves the hosts of the child batches starting at 'firstBatch' and queues them
+        const auto queueChildBatches = [&](size_t firstBatch) {
+            for (size_t i = firstBatch; i < childBatches.size(); ++i) {
+                TargetedWriteBatch* nextBatch = childBatches[i];
 
+                auto swShardHost = resolveHost(txn, *nextBatch);
+                if (!swShardHost.isOK()) {
                     // Record a resolve failure
                     // TODO: It may be necessary to refresh the cache if stale, or maybe just
                     // cancel and retarget the batch
                     WriteErrorDetail error;
-                    buildErrorFrom(status, &error);
+                    buildErrorFrom(swShardHost.getStatus(), &error);
                     LOG(4) << "unable to send write batch to " << nextBatch->getEndpoint().shardName
-                           << causedBy(status);
+                           << causedBy(swShardHost.getStatus());
                     batchOp.noteBatchError(*nextBatch, error);
-                }
-
-                auto swHostAndPort = shard->getTargeter()->findHost(readPref);
-                if (!swHostAndPort.isOK()) {
-                    resolvedHost = false;
 
-                    // Record a resolve failure
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just
-                    // cancel and retarget the batch
-                    WriteErrorDetail error;
-                    buildErrorFrom(swHostAndPort.getStatus(), &error);
-                    LOG(4) << "unable to send write batch to " << nextBatch->getEndpoint().shardName
-                           << causedBy(swHostAndPort.getStatus());
-                    batchOp.noteBatchError(*nextBatch, error);
-                }
-
-                if (!resolvedHost) {
                     ++stats->numResolveErrors;
-
-                    // We're done with this batch
-                    // Clean up when we can't resolve a host
-                    delete *it;
-                    *it = NULL;
-                    --numToSend;
                     continue;
                 }
 
-                ConnectionString shardHost(swHostAndPort.getValue());
-
-                // If we already have a batch for this host, wait until the next time
-                OwnedHostBatchMap::MapType::iterator pendingIt = pendingBatches.find(shardHost);
-                if (pendingIt != pendingBatches.end())
+                // We'll only get several batches for the same host if we have broadcast and
+                // non-broadcast endpoints for the same host, or if more writes were targeted
+                // while the host was busy.
+                queuedBatches[swShardHost.getValue()].push_back(nextBatch);
+            }
+        };
+
+        // Sends the next queued batch to every host which has no batch in flight
+        const auto sendQueuedBatches = [&]() {
+            bool sentAny = false;
+            for (auto& hostQueue : queuedBatches) {
+                const ConnectionString& shardHost = hostQueue.first;
+                if (hostQueue.second.empty() || pendingBatches.count(shardHost))
                     continue;
 
-                //
-                // We now have all the info needed to dispatch the batch
-                //
+                TargetedWriteBatch* nextBatch = hostQueue.second.front();
+                hostQueue.second.pop_front();
 
                 BatchedCommandRequest request(clientRequest.getBatchType());
                 batchOp.buildBatchRequest(*nextBatch, &request);
@@ -240,81 +235,120 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
 
                 _dispatcher->addCommand(shardHost, nss.db(), request.toBSON());
 
-                // Indicate we're done by setting the batch to NULL
-                // We'll only get duplicate hostEndpoints if we have broadcast and non-broadcast
-                // endpoints for the same host, so this should be pretty efficient without
-                // moving stuff around.
-                *it = NULL;
-
-                // Recv-side is responsible for cleaning up the nextBatch when used
                 pendingBatches.insert(make_pair(shardHost, nextBatch));
+                ++stats->numChildBatches;
+                sentAny = true;
             }
 
-            // Send them all out
-            _dispatcher->sendAll();
-            numSent += pendingBatches.size();
+            if (sentAny) {
+                _dispatcher->sendAll();
+            }
+        };
 
-            //
-            // Recv side
-            //
+        // Returns the length of the longest queue of batches waiting for a host
+        const auto maxQueuedBatches = [&]() {
+            size_t maxQueued = 0;
+            for (const auto& hostQueue : queuedBatches) {
+                maxQueued = std::max(maxQueued, hostQueue.second.size());
+            }
+            return maxQueued;
+        };
 
-            while (_dispatcher->numPending() > 0) {
-                // Get the response
-                ConnectionString shardHost;
-                BatchedCommandResponse response;
-                Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
-
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(shardHost) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(shardHost)->second;
-
-                if (dispatchStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-
-                    LOG(4) << "write results received from " << shardHost.toString() << ": "
-                           << response.toString();
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, response, &trackedErrors);
-
-                    // Note if anything was stale
-                    const vector<ShardError*>& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-
-                    if (staleErrors.size() > 0) {
-                        noteStaleResponses(staleErrors, _targeter);
-                        ++stats->numStaleBatches;
-                    }
-
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(
-                        shardHost,
-                        response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
-                        response.isElectionIdSet() ? response.getElectionId() : OID());
-                } else {
-                    // Error occurred dispatching, note it
+        //
+        // Send side
+        //
 
-                    stringstream msg;
-                    msg << "write results unavailable from " << shardHost.toString()
-                        << causedBy(dispatchStatus.toString());
+        queueChildBatches(0);
+        sendQueuedBatches();
 
-                    WriteErrorDetail error;
-                    buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
+        //
+        // Recv side
+        //
+
+        while (_dispatcher->numPending() > 0) {
+            // Get the response
+            ConnectionString shardHost;
+            BatchedCommandResponse response;
+            Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
+
+            // Get the TargetedWriteBatch to find where to put the response
+            dassert(pendingBatches.find(shardHost) != pendingBatches.end());
+            TargetedWriteBatch* batch = pendingBatches.find(shardHost)->second;
+            pendingBatches.erase(shardHost);
+
+            if (dispatchStatus.isOK()) {
+                TrackedErrors trackedErrors;
+                trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+
+                LOG(4) << "write results received from " << shardHost.toString() << ": "
+                       << response.toString();
 
-                    LOG(4) << "unable to receive write results from " << shardHost.toString()
-                           << causedBy(dispatchStatus.toString());
+                // Dispatch was ok, note response
+                batchOp.noteBatchResponse(*batch, response, &trackedErrors);
 
-                    batchOp.noteBatchError(*batch, error);
+                // Note if anything was stale
+                const vector<ShardError*>& staleErrors =
+                    trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+
+                if (staleErrors.size() > 0) {
+                    noteStaleResponses(staleErrors, _targeter);
+                    ++stats->numStaleBatches;
+                    canPipeline = false;
                 }
+
+                // Remember that we successfully wrote to this shard
+                // NOTE: This will record lastOps for shards where we actually didn't update
+                // or delete any documents, which preserves old behavior but is conservative
+                stats->noteWriteAt(shardHost,
+                                   response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
+                                   response.isElectionIdSet() ? response.getElectionId() : OID());
+            } else {
+                // Error occurred dispatching, note it
+
+                stringstream msg;
+                msg << "write results unavailable from " << shardHost.toString()
+                    << causedBy(dispatchStatus.toString());
+
+                WriteErrorDetail error;
+                buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
+
+                LOG(4) << "unable to receive write results from " << shardHost.toString()
+                       << causedBy(dispatchStatus.toString());
+
+                batchOp.noteBatchError(*batch, error);
             }
+
+            //
+            // Target more writes while the other hosts are still busy
+            //
+
+            if (canPipeline && maxQueuedBatches() < kMaxQueuedBatchesPerHost) {
+                const size_t firstNewBatch = childBatches.size();
+                Status pipelineTargetStatus =
+                    batchOp.targetBatch(txn, *_targeter, recordTargetErrors, &childBatches);
+                if (!pipelineTargetStatus.isOK()) {
+                    // Let the batches in flight complete, then refresh the targeter
+                    _targeter->noteCouldNotTarget();
+                    refreshedTargeter = true;
+                    ++stats->numTargetErrors;
+                    canPipeline = false;
+                    dassert(childBatches.size() == firstNewBatch);
+                } else {
+                    stats->numPipelinedBatches += childBatches.size() - firstNewBatch;
+                    queueChildBatches(firstNewBatch);
+                }
+            }
+
+            sendQueuedBatches();
         }
 
         ++rounds;
         ++stats->numRounds;
 
+        const Milliseconds roundTime(roundTimer.millis());
+        stats->totalRoundTime += roundTime;
+        stats->maxRoundTime = std::max(stats->maxRoundTime, roundTime);
+
         // If we're done, get out
         if (batchOp.isFinished())
             break;
@@ -367,7 +401,9 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
                    ? " and"
                    : "")
            << (clientResponse->isWriteConcernErrorSet() ? " with write concern error" : "")
-           << " for " << clientRequest.getNS();
+           << " for " << clientRequest.getNS() << " in " << rounds << " rounds, "
+           << stats->numChildBatches << " child batches ("
+           << stats->numPipelinedBatches << " pipelined)";
 }
 
 void BatchWriteExecStats::noteWriteAt(const ConnectionString& host,
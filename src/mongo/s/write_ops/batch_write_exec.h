@@ -38,6 +38,7 @@
 #include "mongo/s/ns_targeter.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -56,6 +57,10 @@ class OperationContext;
  *  - the "dispatcher" used to send child batches to several shards at once, and retrieve the
  *    results
  *
+ * Child batches of ordered writes are sent in rounds, where each round waits for all the shards
+ * to respond before targeting the next writes. Unordered writes are pipelined instead: once a
+ * shard responds, the remaining writes are targeted and its next child batch is sent right away.
+ *
  * Both the targeter and dispatcher are assumed to be dedicated to this particular
  * BatchWriteExec instance.
  *
@@ -97,7 +102,12 @@ typedef std::map<ConnectionString, HostOpTime> HostOpTimeMap;
 class BatchWriteExecStats {
 public:
     BatchWriteExecStats()
-        : numRounds(0), numTargetErrors(0), numResolveErrors(0), numStaleBatches(0) {}
+        : numRounds(0),
+          numTargetErrors(0),
+          numResolveErrors(0),
+          numStaleBatches(0),
+          numChildBatches(0),
+          numPipelinedBatches(0) {}
 
     void noteWriteAt(const ConnectionString& host, repl::OpTime opTime, const OID& electionId);
 
@@ -113,6 +123,13 @@ public:
     int numResolveErrors;
     // Number of stale batches
     int numStaleBatches;
+    // Number of child batches sent to the shards
+    int numChildBatches;
+    // Number of child batches targeted while earlier batches of the same round were in flight
+    int numPipelinedBatches;
+    // Time spent in all rounds, and in the slowest one
+    Milliseconds totalRoundTime{0};
+    Milliseconds maxRoundTime{0};
 
 private:
     HostOpTimeMap _writeOpTimes;
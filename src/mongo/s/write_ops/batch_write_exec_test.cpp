@@ -168,6 +168,54 @@ TEST_F(BatchWriteExecTest, SingleOpError) {
     ASSERT_EQUALS(stats.numRounds, 1);
 }
 
+TEST_F(BatchWriteExecTest, UnorderedBatchesArePipelined) {
+    //
+    // An unordered batch too large for one child batch is sent in a single round
+    //
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(false);
+    request.setWriteConcern(BSONObj());
+    const int numDocs = BatchedCommandRequest::kMaxWriteBatchSize * 2 + 1;
+    for (int i = 0; i < numDocs; ++i) {
+        request.getInsertRequest()->addToDocuments(BSON("x" << i));
+    }
+
+    BatchedCommandResponse response;
+    BatchWriteExecStats stats;
+    exec->executeBatch(operationContext(), request, &response, &stats);
+    ASSERT(response.getOk());
+
+    ASSERT_EQUALS(stats.numRounds, 1);
+    ASSERT_EQUALS(stats.numChildBatches, 3);
+    ASSERT_EQUALS(stats.numPipelinedBatches, 2);
+}
+
+TEST_F(BatchWriteExecTest, OrderedBatchesAreNotPipelined) {
+    //
+    // The same batch needs one round per child batch when it is ordered
+    //
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(true);
+    request.setWriteConcern(BSONObj());
+    const int numDocs = BatchedCommandRequest::kMaxWriteBatchSize * 2 + 1;
+    for (int i = 0; i < numDocs; ++i) {
+        request.getInsertRequest()->addToDocuments(BSON("x" << i));
+    }
+
+    BatchedCommandResponse response;
+    BatchWriteExecStats stats;
+    exec->executeBatch(operationContext(), request, &response, &stats);
+    ASSERT(response.getOk());
+
+    ASSERT_EQUALS(stats.numRounds, 3);
+    ASSERT_EQUALS(stats.numChildBatches, 3);
+    ASSERT_EQUALS(stats.numPipelinedBatches, 0);
+}
+
 //
 // Test retryable errors
 //
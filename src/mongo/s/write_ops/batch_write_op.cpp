@@ -273,6 +273,46 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
     int numTargetErrors = 0;
 
     size_t numWriteOps = _clientRequest->sizeWriteOps();
+
+    // The documents of an unordered insert batch are targeted up front, which lets the targeter
+    // look up all of their shard keys in one pass. Targeting an insert records its size for
+    // autosplit, so only documents which are sure to be sent in this round are targeted this way:
+    // the ready documents at the front of the batch, up to the count and size limits of a single
+    // child batch. However they are spread over the shards, none of them can then be left out of
+    // its child batch and targeted again in the next round. Ordered batches may stop at the first
+    // write which goes to a different shard, so they keep targeting one write at a time. If any
+    // document fails to target, every write is targeted on its own below to find the failure.
+    OwnedPointerVector<ShardEndpoint> insertEndpointsOwned;
+    vector<ShardEndpoint*> insertEndpoints;
+    if (!ordered && _clientRequest->getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+        !_clientRequest->isInsertIndexRequest()) {
+        vector<size_t> readyOps;
+        vector<BSONObj> docs;
+        int docsSizeBytes = 0;
+        for (size_t i = 0;
+             i < numWriteOps && docs.size() < BatchedCommandRequest::kMaxWriteBatchSize;
+             ++i) {
+            if (_writeOps[i].getWriteState() != WriteOpState_Ready)
+                continue;
+
+            const int writeSizeBytes = getWriteSizeBytes(_writeOps[i]);
+            if (docsSizeBytes + writeSizeBytes > BSONObjMaxUserSize)
+                break;
+
+            docsSizeBytes += writeSizeBytes;
+            readyOps.push_back(i);
+            docs.push_back(_writeOps[i].getWriteItem().getDocument());
+        }
+
+        if (docs.size() > 1u &&
+            targeter.targetInserts(txn, docs, &insertEndpointsOwned.mutableVector()).isOK()) {
+            insertEndpoints.resize(numWriteOps, NULL);
+            for (size_t i = 0; i < readyOps.size(); ++i) {
+                insertEndpoints[readyOps[i]] = insertEndpointsOwned[i];
+            }
+        }
+    }
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -288,7 +328,12 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(txn, targeter, &writes);
+        Status targetStatus = Status::OK();
+        if (!insertEndpoints.empty() && insertEndpoints[i]) {
+            writeOp.targetInsert(*insertEndpoints[i], &writes);
+        } else {
+            targetStatus = writeOp.targetWrites(txn, targeter, &writes);
+        }
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
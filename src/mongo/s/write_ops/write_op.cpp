@@ -139,6 +139,20 @@ Status WriteOp::targetWrites(OperationContext* txn,
     return Status::OK();
 }
 
+void WriteOp::targetInsert(const ShardEndpoint& endpoint, vector<TargetedWrite*>* targetedWrites) {
+    dassert(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
+
+    _childOps.push_back(new ChildWriteOp(this));
+
+    WriteOpRef ref(_itemRef.getItemIndex(), _childOps.size() - 1);
+    targetedWrites->push_back(new TargetedWrite(endpoint, ref));
+
+    _childOps.back()->pendingWrite = targetedWrites->back();
+    _childOps.back()->state = WriteOpState_Pending;
+
+    _state = WriteOpState_Pending;
+}
+
 size_t WriteOp::getNumTargeted() {
     return _childOps.size();
 }
@@ -126,6 +126,12 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Creates the TargetedWrite for an insert which has already been targeted at 'endpoint', for
+     * example by NSTargeter::targetInserts() as part of its whole batch.
+     */
+    void targetInsert(const ShardEndpoint& endpoint, std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
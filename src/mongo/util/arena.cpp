@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "mongo/util/allocator.h"
+
+namespace mongo {
+
+namespace {
+
+size_t alignUp(size_t bytes) {
+    return (bytes + Arena::kAlignment - 1) & ~(Arena::kAlignment - 1);
+}
+
+}  // namespace
+
+Arena::Arena(size_t chunkSize) : _chunkSize(alignUp(chunkSize)) {}
+
+Arena::~Arena() {
+    for (auto&& chunk : _chunks) {
+        std::free(chunk.data);
+    }
+}
+
+void* Arena::allocate(size_t bytes) {
+    const size_t alignedBytes = alignUp(bytes);
+    if (static_cast<size_t>(_end - _pos) < alignedBytes) {
+        _addChunk(alignedBytes);
+    }
+
+    _lastAllocation = _pos;
+    _pos += alignedBytes;
+    _bytesAllocated += bytes;
+    return _lastAllocation;
+}
+
+void* Arena::reallocate(void* ptr, size_t oldBytes, size_t newBytes) {
+    if (!ptr) {
+        return allocate(newBytes);
+    }
+
+    if (ptr == _lastAllocation) {
+        const size_t alignedBytes = alignUp(newBytes);
+        if (static_cast<size_t>(_end - _lastAllocation) >= alignedBytes) {
+            _pos = _lastAllocation + alignedBytes;
+            if (newBytes > oldBytes) {
+                _bytesAllocated += newBytes - oldBytes;
+            }
+            return ptr;
+        }
+    }
+
+    void* newPtr = allocate(newBytes);
+    std::memcpy(newPtr, ptr, std::min(oldBytes, newBytes));
+    return newPtr;
+}
+
+Arena::Mark Arena::mark() const {
+    Mark mark;
+    mark._numChunks = _chunks.size();
+    mark._pos = _pos;
+    mark._lastAllocation = _lastAllocation;
+    return mark;
+}
+
+void Arena::rewind(const Mark& mark) {
+    if (_chunks.empty()) {
+        return;
+    }
+
+    const size_t numChunks = std::max<size_t>(mark._numChunks, 1);
+    for (size_t i = numChunks; i < _chunks.size(); ++i) {
+        std::free(_chunks[i].data);
+    }
+    _chunks.resize(numChunks);
+
+    // A mark taken before the first allocation rewinds to the start of the first chunk.
+    _pos = mark._numChunks ? mark._pos : _chunks[0].data;
+    _end = _chunks.back().data + _chunks.back().size;
+    _lastAllocation = mark._lastAllocation;
+}
+
+void Arena::reset() {
+    rewind(Mark());
+}
+
+void Arena::_addChunk(size_t minBytes) {
+    // Allocations too large for a chunk of their own size get a dedicated chunk.
+    const size_t size = std::max(_chunkSize, minBytes);
+    _chunks.push_back({static_cast<char*>(mongoMalloc(size)), size});
+    _pos = _chunks.back().data;
+    _end = _pos + size;
+}
+
+}  // namespace mongo
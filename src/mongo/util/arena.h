@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+/**
+ * A region of memory from which short-lived allocations are carved by bumping a pointer, and
+ * which are all freed at once when the Arena is reset or destroyed. Memory is taken from the heap
+ * in chunks of at least 'chunkSize' bytes, the first of them on the first allocation, so an
+ * Arena which is never used costs nothing.
+ *
+ * Not thread-safe.
+ */
+class Arena {
+    MONGO_DISALLOW_COPYING(Arena);
+
+public:
+    static const size_t kDefaultChunkSize = 16 * 1024;
+
+    // Every allocation is aligned to this many bytes.
+    static const size_t kAlignment = 16;
+
+    explicit Arena(size_t chunkSize = kDefaultChunkSize);
+    ~Arena();
+
+    /**
+     * Returns 'bytes' bytes of memory, which remain valid until reset() or destruction.
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * Resizes 'ptr', which was allocated from this Arena with size 'oldBytes', to 'newBytes'
+     * bytes, preserving its contents. Grows in place when 'ptr' is the most recent allocation and
+     * its chunk has room. 'ptr' may be null, in which case this is the same as allocate().
+     */
+    void* reallocate(void* ptr, size_t oldBytes, size_t newBytes);
+
+    /**
+     * A position in an Arena, to which it can later be rewound.
+     */
+    class Mark {
+    public:
+        Mark() = default;
+
+    private:
+        friend class Arena;
+
+        size_t _numChunks = 0;
+        char* _pos = nullptr;
+        char* _lastAllocation = nullptr;
+    };
+
+    /**
+     * Frees everything allocated from an Arena during the lifetime of the Scope, which therefore
+     * must not be used once the Scope has ended. Scopes may nest. Memory allocated before the
+     * Scope began must not be reallocated while it is active, since the new memory would be freed
+     * along with the Scope.
+     */
+    class Scope {
+        MONGO_DISALLOW_COPYING(Scope);
+
+    public:
+        explicit Scope(Arena* arena) : _arena(arena), _mark(arena->mark()) {}
+
+        ~Scope() {
+            _arena->rewind(_mark);
+        }
+
+    private:
+        Arena* const _arena;
+        const Mark _mark;
+    };
+
+    /**
+     * Returns the current position of this Arena.
+     */
+    Mark mark() const;
+
+    /**
+     * Frees everything allocated from this Arena since 'mark' was taken. Chunks added since then
+     * are returned to the heap, except for the first chunk, which is kept for reuse.
+     */
+    void rewind(const Mark& mark);
+
+    /**
+     * Frees everything allocated from this Arena. The first chunk is kept for reuse.
+     */
+    void reset();
+
+    /**
+     * Returns the number of bytes handed out since construction, including those which have
+     * since been freed by rewind() or reset().
+     */
+    size_t bytesAllocated() const {
+        return _bytesAllocated;
+    }
+
+private:
+    struct Chunk {
+        char* data;
+        size_t size;
+    };
+
+    /**
+     * Starts a new chunk with room for at least 'minBytes' bytes.
+     */
+    void _addChunk(size_t minBytes);
+
+    const size_t _chunkSize;
+
+    std::vector<Chunk> _chunks;
+
+    // The unused part of the current chunk.
+    char* _pos = nullptr;
+    char* _end = nullptr;
+
+    // The start of the most recent allocation, which reallocate() can grow in place.
+    char* _lastAllocation = nullptr;
+
+    size_t _bytesAllocated = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+bool isAligned(const void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % Arena::kAlignment == 0;
+}
+
+TEST(ArenaTest, AllocationsAreAlignedAndDistinct) {
+    Arena arena(64);
+    char* a = static_cast<char*>(arena.allocate(3));
+    char* b = static_cast<char*>(arena.allocate(17));
+    ASSERT(isAligned(a));
+    ASSERT(isAligned(b));
+    ASSERT_GREATER_THAN_OR_EQUALS(b - a, 16);
+    ASSERT_EQUALS(20U, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, AllocationLargerThanChunkSize) {
+    Arena arena(64);
+    char* big = static_cast<char*>(arena.allocate(1000));
+    std::memset(big, 'x', 1000);
+    char* small = static_cast<char*>(arena.allocate(8));
+    std::memset(small, 'y', 8);
+    ASSERT_EQUALS('x', big[999]);
+    ASSERT_EQUALS(1008U, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, ReallocateLastAllocationGrowsInPlace) {
+    Arena arena(256);
+    char* ptr = static_cast<char*>(arena.allocate(16));
+    ASSERT_EQUALS(static_cast<void*>(ptr), arena.reallocate(ptr, 16, 128));
+    ASSERT_EQUALS(128U, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, ReallocatePreservesContents) {
+    Arena arena(64);
+    char* ptr = static_cast<char*>(arena.allocate(6));
+    std::memcpy(ptr, "hello", 6);
+    arena.allocate(8);
+
+    char* moved = static_cast<char*>(arena.reallocate(ptr, 6, 200));
+    ASSERT_NOT_EQUALS(static_cast<void*>(ptr), static_cast<void*>(moved));
+    ASSERT_EQUALS(0, std::strcmp("hello", moved));
+}
+
+TEST(ArenaTest, ReallocateNullAllocates) {
+    Arena arena;
+    ASSERT(arena.reallocate(nullptr, 0, 32));
+    ASSERT_EQUALS(32U, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, ResetReusesFirstChunk) {
+    Arena arena(64);
+    void* first = arena.allocate(32);
+    arena.allocate(500);
+    arena.reset();
+
+    ASSERT_EQUALS(first, arena.allocate(32));
+    ASSERT_EQUALS(564U, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, ScopeFreesOnlyItsOwnAllocations) {
+    Arena arena(64);
+    char* outer = static_cast<char*>(arena.allocate(6));
+    std::memcpy(outer, "outer", 6);
+
+    void* inner;
+    {
+        Arena::Scope scope(&arena);
+        inner = arena.allocate(16);
+        arena.allocate(500);
+    }
+
+    ASSERT_EQUALS(inner, arena.allocate(16));
+    ASSERT_EQUALS(0, std::strcmp("outer", outer));
+    ASSERT_EQUALS(538U, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, ScopeOnUnusedArenaKeepsFirstChunk) {
+    Arena arena(64);
+
+    void* inner;
+    {
+        Arena::Scope scope(&arena);
+        inner = arena.allocate(100);
+    }
+
+    ASSERT_EQUALS(inner, arena.allocate(8));
+}
+
+TEST(ArenaTest, AllocationBeforeScopeStillGrowsInPlace) {
+    Arena arena(256);
+    char* ptr = static_cast<char*>(arena.allocate(16));
+    {
+        Arena::Scope scope(&arena);
+        arena.allocate(32);
+    }
+
+    ASSERT_EQUALS(static_cast<void*>(ptr), arena.reallocate(ptr, 16, 64));
+}
+
+}  // namespace
+}  // namespace mongo